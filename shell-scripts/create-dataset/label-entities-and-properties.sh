@@ -8,6 +8,7 @@ cmake --build build
 	--split "$SPLIT" \
 	--language "$LABEL_LANGUAGE" \
 	--part-size 15 \
+	--in-flight "${LABEL_IN_FLIGHT:-1}" \
 	--quiet "false"
 
 cd ../..
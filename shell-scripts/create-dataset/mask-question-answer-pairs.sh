@@ -7,6 +7,7 @@ cmake --build build
 	--task "mask-question-answer-pairs" \
 	--split "$SPLIT" \
 	--language "$TARGET_LANGUAGE" \
+	--threads "${MASK_THREADS:-1}" \
 	--quiet "false"
 
 cd ../..
@@ -0,0 +1,16 @@
+#!/usr/bin/env bash
+
+cd source/cpp-ds-create
+
+cmake --build build
+./build/main \
+	--task "pipeline" \
+	--split "$SPLIT" \
+	--language "$TARGET_LANGUAGE" \
+	--part-size 15 \
+	--in-flight "${LABEL_IN_FLIGHT:-1}" \
+	--threads "${MASK_THREADS:-1}" \
+	--checkpoints "${PIPELINE_CHECKPOINTS:-false}" \
+	--quiet "false"
+
+cd ../..
@@ -0,0 +1,150 @@
+/* Benchmarks of matching labels in questions, and of masking. */
+
+#include <optional>
+#include <regex>
+#include <benchmark/benchmark.h>
+#include "tasks/mask-question-answer-pairs.hpp"
+#include "synthetic-data.hpp"
+
+using namespace DutchKBQADSCreate;
+using namespace DutchKBQADSCreate::Benchmarks;
+
+/**
+ * @brief The number of labels an entity or property has, on average.
+ */
+const std::size_t labels_per_symbol = 4;
+
+/**
+ * @brief Returns a label store of `symbols` entities, each with
+ *   `labels_per_symbol` labels.
+ *
+ * @param engine The random engine to draw from.
+ * @param symbols The number of entities.
+ * @return The label store, sealed.
+ */
+LabelStore synthetic_label_store(std::mt19937 &engine, std::size_t symbols) {
+    LabelStore store;
+    for (std::size_t idx = 0; idx < symbols; idx++) {
+        store.add(static_cast<WikiData::symbol_id>(idx + 1), synthetic_labels(engine, labels_per_symbol));
+    }
+    store.seal();
+    return store;
+}
+
+/**
+ * @brief Returns the index bounds of the first occurrence of `label` in
+ *   `sentence` the way this program originally found them: by compiling the
+ *   label, with only its square brackets escaped, into a regex and searching
+ *   the sentence for it.
+ *
+ * @param label The label to search for.
+ * @param sentence The sentence to search in.
+ * @return The index bounds of the first match, or null if there is none.
+ */
+std::optional<index_range> regex_matched_label(const std::string &label, const std::string &sentence) {
+    std::string inner_re = label;
+    inner_re = std::regex_replace(inner_re, std::regex("(\\[)"), "\\[");
+    inner_re = std::regex_replace(inner_re, std::regex("(\\])"), "\\]");
+    std::regex re("(" + inner_re + ")");
+    std::smatch label_re_match;
+    if (std::regex_search(sentence, label_re_match, re)) {
+        int start_idx = static_cast<int>(label_re_match.position(0));
+        return index_range(start_idx, start_idx + label_re_match.length(0) - 1);
+    } else { return std::nullopt; }
+}
+
+/**
+ * @brief Benchmarks matching the labels of a question's three entities one by
+ *   one with `regex_matched_label`: the baseline of `label_index_selection`.
+ *
+ * @param state The benchmark's state.
+ */
+void per_label_matching(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    std::vector<std::string> labels = synthetic_labels(engine, 3 * labels_per_symbol);
+    const std::string question = synthetic_question_containing(engine,
+                                                               { labels[0], labels[4], labels[8] },
+                                                               typical_question_length);
+    for (auto _ : state) {
+        for (const auto &label : labels) {
+            benchmark::DoNotOptimize(regex_matched_label(label, question));
+        }
+    }
+}
+BENCHMARK(per_label_matching);
+
+/**
+ * @brief Benchmarks selecting labels for a question's three entities with a
+ *   `LabelIndex` over the labels of `state.range(0)` entities.
+ *
+ * @param state The benchmark's state.
+ */
+void label_index_selection(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const LabelStore store = synthetic_label_store(engine, static_cast<std::size_t>(state.range(0)));
+    const LabelIndex index(store);
+    const std::vector<WikiData::symbol_id> entities = { 1, 2, 3 };
+    std::vector<std::string> question_labels;
+    for (const auto &ent : entities) {
+        question_labels.emplace_back(store.labels(ent)[0]);
+    }
+    const std::string question = synthetic_question_containing(engine, question_labels, typical_question_length);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(selected_labels_for_entities_and_properties(question, entities, index));
+    }
+}
+BENCHMARK(label_index_selection)->RangeMultiplier(8)->Range(8, 32768);
+
+/**
+ * @brief Benchmarks masking a question-answer pair of three entities and two
+ *   properties, given a `LabelIndex` over the labels of 4096 symbols.
+ *
+ * @param state The benchmark's state.
+ */
+void mask_question_answer_pair(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    LabelStore store;
+    std::vector<WikiData::symbol_id> symbols = { 1, 2, 3, WikiData::property_tag | 1, WikiData::property_tag | 2 };
+    std::vector<std::string> question_labels;
+    for (const auto &symbol : symbols) {
+        std::vector<std::string> labels = synthetic_labels(engine, labels_per_symbol);
+        question_labels.push_back(labels[0]);
+        store.add(symbol, labels);
+    }
+    for (WikiData::symbol_id idx = 4; idx < 4096; idx++) {
+        store.add(idx, synthetic_labels(engine, labels_per_symbol));
+    }
+    store.seal();
+    const LabelIndex index(store);
+    const QuestionAnswerPair pair(1,
+                                  synthetic_question_containing(engine, question_labels, typical_question_length),
+                                  "SELECT ?answer WHERE { wd:Q1 wdt:P1 wd:Q2 . wd:Q3 wdt:P2 ?answer }");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(masked_question_answer_pair(pair, symbols, index));
+    }
+}
+BENCHMARK(mask_question_answer_pair);
+
+/**
+ * @brief Benchmarks selecting labels for a question's three entities with a
+ *   `LabelIndex` over the labels of 4096 entities, where one entity's label
+ *   only occurs misspelt and must be matched approximately.
+ *
+ * @param state The benchmark's state.
+ */
+void approximate_label_selection(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const LabelStore store = synthetic_label_store(engine, 4096);
+    const LabelIndex index(store);
+    const std::vector<WikiData::symbol_id> entities = { 1, 2, 3 };
+    std::vector<std::string> question_labels;
+    for (const auto &ent : entities) {
+        question_labels.emplace_back(store.labels(ent)[0]);
+    }
+    question_labels[2].insert(question_labels[2].size() / 2, "e");  /* One edit away. */
+    const std::string question = synthetic_question_containing(engine, question_labels, typical_question_length);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(selected_labels_for_entities_and_properties(question, entities, index, 2));
+    }
+}
+BENCHMARK(approximate_label_selection);
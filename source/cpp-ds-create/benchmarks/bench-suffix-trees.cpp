@@ -0,0 +1,138 @@
+/* Benchmarks of suffix tree construction and longest common substrings. */
+
+#include <benchmark/benchmark.h>
+#include "suffix-trees/longest-common-substring.hpp"
+#include "suffix-trees/suffix-tree.hpp"
+#include "synthetic-data.hpp"
+
+using namespace DutchKBQADSCreate;
+using namespace DutchKBQADSCreate::Benchmarks;
+
+/**
+ * @brief Benchmarks constructing a suffix tree over a sentence of
+ *   `state.range(0)` bytes.
+ *
+ * @param state The benchmark's state.
+ */
+void construct_suffix_tree(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const std::string str = synthetic_words(engine, static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        SuffixTrees::SuffixTree tree(str);
+        tree.construct();
+        benchmark::DoNotOptimize(tree.root);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(str.size()));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(construct_suffix_tree)->RangeMultiplier(4)->Range(16, 16384)->Complexity(benchmark::oN);
+
+/**
+ * @brief Benchmarks finding the longest common substring of a label and a
+ *   question of `state.range(0)` bytes with the LCS backend `backend`.
+ *
+ * @param state The benchmark's state.
+ * @param backend The backend. `EXPLICIT_STATE_SUFFIX_TREE` is the baseline.
+ */
+void longest_common_substring_of_label(benchmark::State &state, SuffixTrees::LCSBackend backend) {
+    std::mt19937 engine(synthetic_seed);
+    const std::vector<std::string> labels = synthetic_labels(engine, 1);
+    const std::string question = synthetic_question_containing(engine,
+                                                               labels,
+                                                               static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SuffixTrees::longest_common_substring(labels[0], question, backend));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK_CAPTURE(longest_common_substring_of_label, explicit_state, SuffixTrees::EXPLICIT_STATE_SUFFIX_TREE)
+    ->RangeMultiplier(4)->Range(typical_question_length, 24576)->Complexity(benchmark::oN);
+BENCHMARK_CAPTURE(longest_common_substring_of_label, flat, SuffixTrees::FLAT_SUFFIX_TREE)
+    ->RangeMultiplier(4)->Range(typical_question_length, 24576)->Complexity(benchmark::oN);
+BENCHMARK_CAPTURE(longest_common_substring_of_label, suffix_array, SuffixTrees::SUFFIX_ARRAY)
+    ->RangeMultiplier(4)->Range(typical_question_length, 24576)->Complexity(benchmark::oN);
+
+/**
+ * @brief Returns 4096 pairs of labels and typical questions containing them.
+ *
+ * @return The pairs.
+ */
+std::vector<std::pair<std::string, std::string>> synthetic_label_question_pairs() {
+    std::mt19937 engine(synthetic_seed);
+    const std::vector<std::string> labels = synthetic_labels(engine, 4096);
+    std::vector<std::pair<std::string, std::string>> pairs;
+    pairs.reserve(labels.size());
+    for (const auto &label : labels) {
+        pairs.emplace_back(label, synthetic_question_containing(engine, { label }, typical_question_length));
+    }
+    return pairs;
+}
+
+/**
+ * @brief Benchmarks finding the longest common substrings of 4096 pairs of
+ *   labels and typical questions one by one, with the `SUFFIX_ARRAY` backend.
+ *   The baseline of `longest_common_substrings_of_pairs`.
+ *
+ * @param state The benchmark's state.
+ */
+void longest_common_substrings_of_pairs_one_by_one(benchmark::State &state) {
+    const std::vector<std::pair<std::string, std::string>> pairs = synthetic_label_question_pairs();
+    for (auto _ : state) {
+        for (const auto &pair : pairs) {
+            benchmark::DoNotOptimize(SuffixTrees::longest_common_substring(pair.first,
+                                                                           pair.second,
+                                                                           SuffixTrees::SUFFIX_ARRAY));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(pairs.size()));
+}
+BENCHMARK(longest_common_substrings_of_pairs_one_by_one)->UseRealTime();
+
+/**
+ * @brief Benchmarks finding the longest common substrings of 4096 pairs of
+ *   labels and typical questions in one batch, with `state.range(0)` threads.
+ *
+ * @param state The benchmark's state.
+ */
+void longest_common_substrings_of_pairs(benchmark::State &state) {
+    const std::vector<std::pair<std::string, std::string>> pairs = synthetic_label_question_pairs();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SuffixTrees::longest_common_substrings(pairs, static_cast<int>(state.range(0))));
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(pairs.size()));
+}
+BENCHMARK(longest_common_substrings_of_pairs)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+/**
+ * @brief Benchmarks finding the longest common substrings of one question
+ *   and `state.range(0)` labels, sharing the work on the question.
+ *
+ * @param state The benchmark's state.
+ */
+void one_vs_many_longest_common_substrings(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const std::vector<std::string> labels = synthetic_labels(engine, static_cast<std::size_t>(state.range(0)));
+    const std::string question = synthetic_question_containing(engine,
+                                                               { labels.front(), labels.back() },
+                                                               typical_question_length);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SuffixTrees::one_vs_many_longest_common_substrings(question, labels));
+    }
+}
+BENCHMARK(one_vs_many_longest_common_substrings)->RangeMultiplier(4)->Range(1, 256);
+
+/**
+ * @brief Benchmarks finding all maximal common substrings of at least four
+ *   code points between a label and a typical question.
+ *
+ * @param state The benchmark's state.
+ */
+void maximal_common_substrings_of_label(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const std::vector<std::string> labels = synthetic_labels(engine, 1);
+    const std::string question = synthetic_question_containing(engine, labels, typical_question_length);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SuffixTrees::maximal_common_substrings(labels[0], question, 4));
+    }
+}
+BENCHMARK(maximal_common_substrings_of_label);
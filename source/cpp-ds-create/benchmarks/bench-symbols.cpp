@@ -0,0 +1,206 @@
+/* Benchmarks of replacing special symbols, and of scanning SPARQL for WikiData identifiers. */
+
+#include <algorithm>
+#include <regex>
+#include <set>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "tasks/replace-special-symbols.hpp"
+#include "wikidata/symbol-ids.hpp"
+#include "synthetic-data.hpp"
+
+using namespace DutchKBQADSCreate;
+using namespace DutchKBQADSCreate::Benchmarks;
+
+/**
+ * @brief The special symbols that the `replace-special-symbols` task replaces,
+ *   besides HTML character entities.
+ */
+const std::map<std::string, std::string> benchmark_replace_map = { { "_", " " }, { "{", "" }, { "}", "" } };
+
+/**
+ * @brief The characters that are reserved in regular expressions.
+ */
+const std::vector<char> regex_characters_to_escape = {
+    '.', '(', ')', '[', ']', '|', '{', '}', '*', '+', '-', '?', '^', '$', '/', '\\'
+};
+
+/**
+ * @brief Returns `non_escaped` with its characters that are reserved in
+ *   regular expressions escaped, the way this program originally escaped
+ *   symbols before searching for them.
+ *
+ * @param non_escaped The original, non-escaped string.
+ * @return The string with any RegEx-reserved characters escaped.
+ */
+static std::string string_with_regex_characters_escaped(const std::string &non_escaped) {
+    std::string escapes_added;
+    for (const auto &c : non_escaped) {
+        if (std::find(regex_characters_to_escape.begin(), regex_characters_to_escape.end(), c) !=
+            regex_characters_to_escape.end()) {
+            escapes_added += "\\";
+        }
+        escapes_added += c;
+    }
+    return escapes_added;
+}
+
+/**
+ * @brief Returns `str` with the symbols of `benchmark_replace_map` replaced the
+ *   way this program originally did: one regex search for any symbol, and one
+ *   regex replacement over the whole string per found symbol. The baseline of
+ *   `symbol_replacer`.
+ *
+ * @param str The string to replace symbols in.
+ * @return The string, with its symbols replaced.
+ */
+std::string regex_replaced_symbols(const std::string &str) {
+    static const std::regex search_query("(_)|(\\{)|(\\})");
+    std::string replaced = str;
+    for (std::sregex_iterator it(str.begin(), str.end(), search_query); it != std::sregex_iterator(); ++it) {
+        const std::string symbol = it->str();
+        replaced = std::regex_replace(replaced,
+                                      std::regex("(" + string_with_regex_characters_escaped(symbol) + ")"),
+                                      benchmark_replace_map.at(symbol));
+    }
+    return replaced;
+}
+
+/**
+ * @brief Benchmarks `regex_replaced_symbols` on a translation of
+ *   `state.range(0)` bytes.
+ *
+ * @param state The benchmark's state.
+ */
+void regex_symbol_replacement(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const std::string text = synthetic_translation(engine, static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(regex_replaced_symbols(text));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(regex_symbol_replacement)->RangeMultiplier(8)->Range(typical_question_length, 6144);
+
+/**
+ * @brief Benchmarks replacing both the symbols of `benchmark_replace_map` and
+ *   HTML character entities in a translation of `state.range(0)` bytes, with
+ *   a `SymbolReplacer`.
+ *
+ * @param state The benchmark's state.
+ */
+void symbol_replacer(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const std::string text = synthetic_translation(engine, static_cast<std::size_t>(state.range(0)));
+    const SymbolReplacer replacer(benchmark_replace_map, true);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(replacer.replaced(text));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(symbol_replacer)->RangeMultiplier(8)->Range(typical_question_length, 6144);
+
+/**
+ * @brief The HTML character entities that synthetic translations contain,
+ *   with their referents.
+ */
+const std::map<std::string, std::string> benchmark_html_character_entity_map = {
+    { "&quot;", "\"" }, { "&amp;", "&" }, { "&lt;", "<" }
+};
+
+/**
+ * @brief Returns `str` with its HTML entities replaced the way this program
+ *   originally did: one regex search for any entity, and one regex
+ *   replacement over the whole string per found entity. The baseline of
+ *   `html_entity_replacer`.
+ *
+ * @param str The string to replace HTML entities in.
+ * @return The string, with its HTML entities replaced.
+ */
+std::string string_with_html_entities_replaced(const std::string &str) {
+    static const std::regex html_entity_query("((&#[0-9]{1,4};)|(&[a-z]+;))");
+    static const std::regex code_point_query("[0-9]{1,4}");
+    std::string replaced = str;
+    for (std::sregex_iterator it(str.begin(), str.end(), html_entity_query); it != std::sregex_iterator(); ++it) {
+        const std::string entity = it->str();
+        std::string referent;
+        if (benchmark_html_character_entity_map.count(entity) == 0) {
+            std::smatch code_point_match;
+            std::regex_search(entity, code_point_match, code_point_query);
+            referent = std::string { static_cast<char>(std::stoi(code_point_match.str())) };
+        } else {
+            referent = benchmark_html_character_entity_map.at(entity);
+        }
+        replaced = std::regex_replace(replaced, std::regex("(" + entity + ")"), referent);
+    }
+    return replaced;
+}
+
+/**
+ * @brief Benchmarks `string_with_html_entities_replaced` on a translation of
+ *   `state.range(0)` bytes.
+ *
+ * @param state The benchmark's state.
+ */
+void regex_html_entity_replacement(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const std::string text = synthetic_translation(engine, static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(string_with_html_entities_replaced(text));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(regex_html_entity_replacement)->RangeMultiplier(8)->Range(typical_question_length, 6144);
+
+/**
+ * @brief Benchmarks replacing only HTML character and numeric entities in a
+ *   translation of `state.range(0)` bytes, with a `SymbolReplacer`.
+ *
+ * @param state The benchmark's state.
+ */
+void html_entity_replacer(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const std::string text = synthetic_translation(engine, static_cast<std::size_t>(state.range(0)));
+    const SymbolReplacer replacer({}, true);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(replacer.replaced(text));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(html_entity_replacer)->RangeMultiplier(8)->Range(typical_question_length, 6144);
+
+/**
+ * @brief Benchmarks collecting the identifiers of a SPARQL query with the
+ *   regex this program originally used: the baseline of
+ *   `symbol_ids_in_sparql`.
+ *
+ * @param state The benchmark's state.
+ */
+void regex_identifier_scan(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const std::string sparql = synthetic_sparql(engine, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        const std::regex ent_prp_query("[QP][0-9]+");
+        std::set<std::string> ids;
+        for (std::sregex_iterator it(sparql.begin(), sparql.end(), ent_prp_query); it != std::sregex_iterator(); ++it) {
+            ids.insert(it->str());
+        }
+        benchmark::DoNotOptimize(ids);
+    }
+}
+BENCHMARK(regex_identifier_scan)->RangeMultiplier(4)->Range(1, 64);
+
+/**
+ * @brief Benchmarks collecting the identifiers of a SPARQL query of
+ *   `state.range(0)` triple patterns with `WikiData::symbol_ids_in_sparql`.
+ *
+ * @param state The benchmark's state.
+ */
+void symbol_ids_in_sparql(benchmark::State &state) {
+    std::mt19937 engine(synthetic_seed);
+    const std::string sparql = synthetic_sparql(engine, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(WikiData::symbol_ids_in_sparql(sparql));
+    }
+}
+BENCHMARK(symbol_ids_in_sparql)->RangeMultiplier(4)->Range(1, 64);
@@ -0,0 +1,124 @@
+/* Symbols for generating synthetic, LC-QuAD 2.0-like benchmark inputs. */
+
+#include <array>
+#include "synthetic-data.hpp"
+
+using namespace DutchKBQADSCreate::Benchmarks;
+
+/**
+ * @brief Words to build synthetic sentences from. Some contain multi-byte
+ *   UTF-8 characters, like translated Dutch questions do.
+ */
+const std::array<const char *, 24> synthetic_vocabulary = {
+    "wat", "is", "de", "het", "een", "van", "wie", "heeft", "welke", "stad",
+    "geboren", "rivier", "één", "café", "coördinaat", "hoofdstad", "bevolking",
+    "taal", "gebied", "België", "naam", "Zuid-Holland", "auteur", "ontdekt"
+};
+
+/**
+ * @brief Returns a sentence of vocabulary words of roughly `length` bytes.
+ *
+ * @param engine The random engine to draw from.
+ * @param length The length to reach. The sentence ends with the word that
+ *   reaches it.
+ * @return The sentence.
+ */
+std::string DutchKBQADSCreate::Benchmarks::synthetic_words(std::mt19937 &engine, std::size_t length) {
+    std::uniform_int_distribution<std::size_t> word(0, synthetic_vocabulary.size() - 1);
+    std::string words;
+    while (words.size() < length) {
+        if (!words.empty()) {
+            words += ' ';
+        }
+        words += synthetic_vocabulary[word(engine)];
+    }
+    return words;
+}
+
+/**
+ * @brief Returns `count` labels of one to four words, like WikiData labels and
+ *   aliases.
+ *
+ * @param engine The random engine to draw from.
+ * @param count The number of labels.
+ * @return The labels.
+ */
+std::vector<std::string> DutchKBQADSCreate::Benchmarks::synthetic_labels(std::mt19937 &engine, std::size_t count) {
+    std::uniform_int_distribution<std::size_t> length(4, 28);
+    std::vector<std::string> labels;
+    labels.reserve(count);
+    for (std::size_t idx = 0; idx < count; idx++) {
+        labels.push_back(synthetic_words(engine, length(engine)));
+    }
+    return labels;
+}
+
+/**
+ * @brief Returns a question of roughly `length` bytes in which each of
+ *   `labels` occurs once, in order, among filler words.
+ *
+ * @param engine The random engine to draw from.
+ * @param labels The labels to include.
+ * @param length The length to reach.
+ * @return The question.
+ */
+std::string DutchKBQADSCreate::Benchmarks::synthetic_question_containing(std::mt19937 &engine,
+                                                                         const std::vector<std::string> &labels,
+                                                                         std::size_t length) {
+    std::size_t labels_length = 0;
+    for (const auto &label : labels) {
+        labels_length += label.size() + 1;
+    }
+    const std::size_t filler_length = length > labels_length ? (length - labels_length) / (labels.size() + 1) : 1;
+    std::string question = synthetic_words(engine, filler_length);
+    for (const auto &label : labels) {
+        question += ' ' + label + ' ' + synthetic_words(engine, filler_length);
+    }
+    return question + '?';
+}
+
+/**
+ * @brief Returns a SPARQL query like those of LC-QuAD 2.0, with `triples`
+ *   triple patterns over random entities and properties.
+ *
+ * @param engine The random engine to draw from.
+ * @param triples The number of triple patterns.
+ * @return The query.
+ */
+std::string DutchKBQADSCreate::Benchmarks::synthetic_sparql(std::mt19937 &engine, int triples) {
+    std::uniform_int_distribution<int> entity(1, 99999999);
+    std::uniform_int_distribution<int> property(1, 9999);
+    std::string sparql = "SELECT ?answer WHERE {";
+    for (int idx = 0; idx < triples; idx++) {
+        sparql += " wd:Q" + std::to_string(entity(engine)) +
+                  " p:P" + std::to_string(property(engine)) + " ?s" + std::to_string(idx) + " ." +
+                  " ?s" + std::to_string(idx) + " ps:P" + std::to_string(property(engine)) + " ?answer .";
+    }
+    return sparql + " FILTER(LANG(?answer) = 'en') }";
+}
+
+/**
+ * @brief Returns a machine-translated text of roughly `length` bytes, with
+ *   the HTML character entities and special symbols that translations of
+ *   LC-QuAD 2.0 contain.
+ *
+ * @param engine The random engine to draw from.
+ * @param length The length to reach.
+ * @return The text.
+ */
+std::string DutchKBQADSCreate::Benchmarks::synthetic_translation(std::mt19937 &engine, std::size_t length) {
+    const std::array<const char *, 8> specials = {
+        "&quot;", "&amp;", "&#39;", "&#233;", "_", "{", "}", "&lt;"
+    };
+    std::uniform_int_distribution<std::size_t> special(0, specials.size() - 1);
+    std::uniform_int_distribution<int> chance(0, 5);
+    std::string text;
+    while (text.size() < length) {
+        text += synthetic_words(engine, 12);
+        text += chance(engine) == 0 ? "_" : " ";
+        if (chance(engine) < 2) {
+            text += specials[special(engine)];
+        }
+    }
+    return text;
+}
@@ -0,0 +1,31 @@
+/* Symbols for generating synthetic, LC-QuAD 2.0-like benchmark inputs (header). */
+
+#ifndef SYNTHETIC_DATA_HPP
+#define SYNTHETIC_DATA_HPP
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace DutchKBQADSCreate::Benchmarks {
+    /**
+     * @brief The seed of every generator's random engine, so that all runs
+     *   benchmark the same inputs.
+     */
+    const unsigned int synthetic_seed = 0x5EED;
+    /**
+     * @brief The typical length in bytes of a translated LC-QuAD 2.0 question.
+     */
+    const std::size_t typical_question_length = 96;
+
+    std::string synthetic_words(std::mt19937 &engine, std::size_t length);
+    std::vector<std::string> synthetic_labels(std::mt19937 &engine, std::size_t count);
+    std::string synthetic_question_containing(std::mt19937 &engine,
+                                              const std::vector<std::string> &labels,
+                                              std::size_t length);
+    std::string synthetic_sparql(std::mt19937 &engine, int triples);
+    std::string synthetic_translation(std::mt19937 &engine, std::size_t length);
+}
+
+#endif  /* SYNTHETIC_DATA_HPP */
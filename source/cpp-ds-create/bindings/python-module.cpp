@@ -0,0 +1,219 @@
+/* Python bindings of the longest common substring, label matching and masking symbols. */
+
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include "suffix-trees/longest-common-substring.hpp"
+#include "tasks/mask-question-answer-pairs.hpp"
+#include "wikidata/symbol-ids.hpp"
+
+namespace py = pybind11;
+using namespace DutchKBQADSCreate;
+
+/**
+ * @brief A label match as handed to Python: the matched label, followed by the
+ *   start (inclusive) and end (exclusive) of its match within the question, in
+ *   code points, so that it can be used to slice the Python string.
+ */
+using python_label_match = std::tuple<std::string, int, int>;
+
+/**
+ * @brief Returns the number of code points of the UTF8-encoded `str` that
+ *   start before the byte with index `byte_index`.
+ *
+ * @param str The string.
+ * @param byte_index The byte index. At most the size of `str`.
+ * @return The number of code points.
+ */
+static int code_points_before(const std::string &str, int byte_index) {
+    int code_points = 0;
+    for (int idx = 0; idx < byte_index; idx++) {
+        if ((static_cast<unsigned char>(str[idx]) & 0xc0u) != 0x80) {
+            code_points++;  /* Not a continuation byte. */
+        }
+    }
+    return code_points;
+}
+
+/**
+ * @brief Constructs an index over `labels`.
+ *
+ * @param labels A mapping from entities and properties (like `Q5` and `P31`)
+ *   to their labels.
+ * @return The index.
+ */
+static LabelIndex label_index_from_labels(const std::map<std::string, std::vector<std::string>> &labels) {
+    LabelStore store;
+    for (const auto &[ent_or_prp, ent_or_prp_labels] : labels) {
+        store.add(WikiData::parsed_symbol_id(ent_or_prp), ent_or_prp_labels);
+    }
+    store.seal();
+    return LabelIndex(store);
+}
+
+/**
+ * @brief Returns the label selected for each of `entities_properties` in
+ *   `question`, or null if some entity or property cannot be assigned one.
+ *   See `selected_labels_for_entities_and_properties`.
+ *
+ * @param label_index An index over the labels of all entities and properties.
+ * @param question The question.
+ * @param entities_properties The question's entities and properties, like `Q5`
+ *   and `P31`.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly.
+ * @return A mapping from the entities and properties to their label matches.
+ */
+static std::optional<std::map<std::string, python_label_match>> python_selected_labels(
+        const LabelIndex &label_index,
+        const std::string &question,
+        const std::vector<std::string> &entities_properties,
+        int max_edit_distance) {
+    std::vector<WikiData::symbol_id> ids;
+    for (const auto &ent_or_prp : entities_properties) {
+        ids.push_back(WikiData::parsed_symbol_id(ent_or_prp));
+    }
+    const ent_prp_chosen_label_map map = selected_labels_for_entities_and_properties(question,
+                                                                                     ids,
+                                                                                     label_index,
+                                                                                     max_edit_distance);
+    if (!map.has_value()) {
+        return std::nullopt;
+    }
+    std::map<std::string, python_label_match> matches;
+    for (const auto &[ent_or_prp, match] : map.value()) {
+        matches.insert({ WikiData::string_from_symbol_id(ent_or_prp),
+                         { std::string(match.label),
+                           code_points_before(question, match.match_bounds.first),
+                           code_points_before(question, match.match_bounds.second + 1) } });
+    }
+    return matches;
+}
+
+/**
+ * @brief Masks the question and answer of a question-answer pair, taking its
+ *   entities and properties from the answer.
+ *
+ * @param question The question.
+ * @param answer The answer: a SPARQL query.
+ * @param label_index An index over the labels of all entities and properties.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly.
+ * @return The masked question and answer, or null if the pair cannot be
+ *   masked.
+ */
+static std::optional<std::pair<std::string, std::string>> python_masked_question_answer_pair(
+        const std::string &question,
+        const std::string &answer,
+        const LabelIndex &label_index,
+        int max_edit_distance) {
+    const std::optional<QuestionAnswerPair> masked = masked_question_answer_pair(
+        QuestionAnswerPair(0, question, answer),
+        WikiData::symbol_ids_in_sparql(answer),
+        label_index,
+        max_edit_distance
+    );
+    if (!masked.has_value()) {
+        return std::nullopt;
+    }
+    return std::pair<std::string, std::string>(masked->q, masked->a);
+}
+
+/**
+ * @brief Masks question-answer pairs, taking the entities and properties of
+ *   each from its answer. Runs without the Python global interpreter lock.
+ *
+ * @param pairs The question-answer pairs, as triples of a UID, a question and
+ *   an answer. The UIDs must be unique.
+ * @param label_index An index over the labels of all entities and properties.
+ * @param threads The number of threads to mask with. Minimally 1.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly.
+ * @return A mapping from the UIDs of the pairs that could be masked to their
+ *   masked questions and answers.
+ */
+static std::map<int, std::pair<std::string, std::string>> python_masked_question_answer_pairs(
+        const std::vector<std::tuple<int, std::string, std::string>> &pairs,
+        const LabelIndex &label_index,
+        int threads,
+        int max_edit_distance) {
+    std::vector<QuestionAnswerPair> qa_pairs;
+    q_ent_prp_map questions_entities_properties;
+    qa_pairs.reserve(pairs.size());
+    for (const auto &[uid, question, answer] : pairs) {
+        qa_pairs.emplace_back(uid, question, answer);
+        questions_entities_properties.insert({ uid, WikiData::symbol_ids_in_sparql(answer) });
+    }
+    std::map<int, std::pair<std::string, std::string>> masked;
+    for (auto &masked_pair : masked_question_answer_pairs(qa_pairs,
+                                                          questions_entities_properties,
+                                                          label_index,
+                                                          true,
+                                                          threads,
+                                                          max_edit_distance)) {
+        masked.insert({ masked_pair.uid, { masked_pair.q, masked_pair.a } });
+    }
+    return masked;
+}
+
+PYBIND11_MODULE(dutch_kbqa_cpp_ds_create, module) {
+    module.doc() = "Longest common substrings, label matching and masking of the C++ post-processing project, "
+                   "over in-memory strings.";
+
+    py::enum_<SuffixTrees::LCSBackend>(module, "LCSBackend")
+        .value("EXPLICIT_STATE_SUFFIX_TREE", SuffixTrees::EXPLICIT_STATE_SUFFIX_TREE)
+        .value("FLAT_SUFFIX_TREE", SuffixTrees::FLAT_SUFFIX_TREE)
+        .value("SUFFIX_ARRAY", SuffixTrees::SUFFIX_ARRAY);
+    module.def("longest_common_substring",
+               &SuffixTrees::longest_common_substring,
+               py::arg("first"),
+               py::arg("second"),
+               py::arg("backend") = SuffixTrees::EXPLICIT_STATE_SUFFIX_TREE,
+               py::call_guard<py::gil_scoped_release>(),
+               "Returns the longest common substring of `first` and `second`, or `None` if they share none.");
+    module.def("longest_common_substrings",
+               &SuffixTrees::longest_common_substrings,
+               py::arg("pairs"),
+               py::arg("threads") = 1,
+               py::call_guard<py::gil_scoped_release>(),
+               "Returns the longest common substring (or `None`) of every pair of strings in `pairs`, "
+               "computed with `threads` threads.");
+
+    py::class_<LabelIndex>(module, "LabelIndex",
+                           "An index over the labels of entities and properties, with which labels are matched "
+                           "in questions and questions are masked.")
+        .def(py::init(&label_index_from_labels),
+             py::arg("labels"),
+             "Indexes `labels`: a mapping from entities and properties (like 'Q5' and 'P31') to their labels.")
+        .def("selected_labels",
+             &python_selected_labels,
+             py::arg("question"),
+             py::arg("entities_properties"),
+             py::arg("max_edit_distance") = 0,
+             "Returns, for each of `entities_properties`, the label selected for it in `question` along with the "
+             "start and end of the match (a slice of `question`), or `None` if some entity or property cannot be "
+             "assigned a label.");
+
+    module.def("masked_question_answer_pair",
+               &python_masked_question_answer_pair,
+               py::arg("question"),
+               py::arg("answer"),
+               py::arg("label_index"),
+               py::arg("max_edit_distance") = 0,
+               "Returns the masked question and answer of a question-answer pair, or `None` if it cannot be masked. "
+               "Its entities and properties are taken from the answer.");
+    module.def("masked_question_answer_pairs",
+               &python_masked_question_answer_pairs,
+               py::arg("pairs"),
+               py::arg("label_index"),
+               py::arg("threads") = 1,
+               py::arg("max_edit_distance") = 0,
+               py::call_guard<py::gil_scoped_release>(),
+               "Masks `pairs`, triples of a UID, question and answer, with `threads` threads. Returns a mapping from "
+               "the UIDs of the pairs that could be masked to their masked questions and answers.");
+}
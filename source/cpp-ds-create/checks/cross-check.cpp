@@ -0,0 +1,365 @@
+/* Cross-checks of interchangeable string matching implementations against each other and against naive ones. */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "suffix-trees/longest-common-substring.hpp"
+#include "suffix-trees/unicode-string.hpp"
+#include "string-matching/aho-corasick.hpp"
+#include "string-matching/approximate-matcher.hpp"
+
+using namespace DutchKBQADSCreate;
+
+/**
+ * @brief The seed of every check's random engine, so that all runs check the
+ *   same inputs.
+ */
+const unsigned int check_seed = 0xC4EC;
+/**
+ * @brief The symbols random inputs are built from. A small alphabet makes
+ *   long and repeated common substrings likely; the multi-byte symbol ensures
+ *   that code points and bytes are not confused.
+ */
+const std::vector<std::string> check_symbols = { "a", "b", "c", "\xC3\xAB", " " };
+
+/**
+ * @brief Generates a random string of `length` symbols from the first
+ *   `alphabet_size` symbols of `check_symbols`.
+ *
+ * @param engine The random engine to draw symbols with.
+ * @param length The number of symbols.
+ * @param alphabet_size The number of distinct symbols to draw from.
+ * @return The string.
+ */
+static std::string random_string(std::mt19937 &engine, int length, int alphabet_size) {
+    std::uniform_int_distribution<int> symbol(0, alphabet_size - 1);
+    std::string str;
+    for (int idx = 0; idx < length; idx++) {
+        str += check_symbols[symbol(engine)];
+    }
+    return str;
+}
+
+/**
+ * @brief Returns the code points of the UTF8 string `str`.
+ *
+ * @param str The string.
+ * @return The code points.
+ */
+static std::vector<utf8::uint32_t> code_points_of(const std::string &str) {
+    std::vector<utf8::uint32_t> code_points;
+    SuffixTrees::UnicodeString::append_utf8_decoded(str, code_points);
+    return code_points;
+}
+
+/**
+ * @brief Determines the length of the longest common substring of `first`
+ *   and `second` naively, by dynamic programming over their code points.
+ *
+ * @param first The first string.
+ * @param second The second string.
+ * @return The length of their longest common substring, in code points.
+ */
+static int naive_longest_common_substring_length(const std::string &first, const std::string &second) {
+    const std::vector<utf8::uint32_t> a = code_points_of(first);
+    const std::vector<utf8::uint32_t> b = code_points_of(second);
+    std::vector<int> previous(b.size() + 1, 0);
+    std::vector<int> current(b.size() + 1, 0);
+    int longest = 0;
+    for (std::size_t i = 1; i <= a.size(); i++) {
+        for (std::size_t j = 1; j <= b.size(); j++) {
+            current[j] = a[i - 1] == b[j - 1] ? previous[j - 1] + 1 : 0;
+            longest = std::max(longest, current[j]);
+        }
+        std::swap(previous, current);
+    }
+    return longest;
+}
+
+/**
+ * @brief Determines the Levenshtein distance between two code point
+ *   sequences naively, by dynamic programming.
+ *
+ * @param a The first sequence.
+ * @param b The second sequence.
+ * @return Their Levenshtein distance.
+ */
+static int naive_levenshtein_distance(const std::vector<utf8::uint32_t> &a, const std::vector<utf8::uint32_t> &b) {
+    std::vector<int> previous(b.size() + 1);
+    std::vector<int> current(b.size() + 1);
+    for (std::size_t j = 0; j <= b.size(); j++) {
+        previous[j] = static_cast<int>(j);
+    }
+    for (std::size_t i = 1; i <= a.size(); i++) {
+        current[0] = static_cast<int>(i);
+        for (std::size_t j = 1; j <= b.size(); j++) {
+            current[j] = std::min({ previous[j - 1] + (a[i - 1] != b[j - 1] ? 1 : 0),
+                                    previous[j] + 1,
+                                    current[j - 1] + 1 });
+        }
+        std::swap(previous, current);
+    }
+    return previous[b.size()];
+}
+
+/**
+ * @brief Reports a failed check, together with the inputs it failed on.
+ *
+ * @param check The name of the check.
+ * @param message What went wrong.
+ * @param inputs The inputs of the check.
+ */
+static void report_failure(const std::string &check,
+                           const std::string &message,
+                           const std::vector<std::string> &inputs) {
+    std::cerr << check << ": " << message << std::endl;
+    for (const std::string &input : inputs) {
+        std::cerr << "    \"" << input << "\"" << std::endl;
+    }
+}
+
+/**
+ * @brief Checks whether `lcs` can be the longest common substring of `first`
+ *   and `second`: it must be as long as naively determined, and occur in both.
+ *
+ * @param lcs The longest common substring to check.
+ * @param first The first string.
+ * @param second The second string.
+ * @return The question's answer.
+ */
+static bool is_longest_common_substring(const std::optional<std::string> &lcs,
+                                        const std::string &first,
+                                        const std::string &second) {
+    const int expected_length = naive_longest_common_substring_length(first, second);
+    if (!lcs.has_value()) {
+        return expected_length == 0;
+    }
+    return static_cast<int>(code_points_of(lcs.value()).size()) == expected_length &&
+           first.find(lcs.value()) != std::string::npos &&
+           second.find(lcs.value()) != std::string::npos;
+}
+
+/**
+ * @brief Cross-checks all longest common substring implementations on the
+ *   pair `first` and `second`.
+ *
+ * The three backends, the workspace and the parallel variant must return
+ * identical results, as their documentation promises. The suffix automaton
+ * may break ties differently, so only its result's length is checked.
+ *
+ * @param first The first string.
+ * @param second The second string.
+ * @return Whether all implementations agree.
+ */
+static bool check_longest_common_substring_pair(const std::string &first, const std::string &second) {
+    const std::string check = "longest common substring";
+    const std::optional<std::string> reference = SuffixTrees::longest_common_substring(
+            first, second, SuffixTrees::EXPLICIT_STATE_SUFFIX_TREE);
+    if (!is_longest_common_substring(reference, first, second)) {
+        report_failure(check, "the explicit-state suffix tree is wrong", { first, second });
+        return false;
+    }
+    const std::vector<std::pair<std::string, std::optional<std::string>>> others = {
+        { "flat suffix tree",
+          SuffixTrees::longest_common_substring(first, second, SuffixTrees::FLAT_SUFFIX_TREE) },
+        { "suffix array",
+          SuffixTrees::longest_common_substring(first, second, SuffixTrees::SUFFIX_ARRAY) },
+        { "workspace",
+          SuffixTrees::LCSWorkspace().longest_common_substring(first, second) },
+        { "parallel",
+          SuffixTrees::longest_common_substrings({ { first, second } }, 1).at(0) }
+    };
+    for (const auto &[name, lcs] : others) {
+        if (lcs != reference) {
+            report_failure(check, "the " + name + " disagrees with the explicit-state suffix tree", { first, second });
+            return false;
+        }
+    }
+    const std::optional<std::string> automaton_lcs = SuffixTrees::one_vs_many_longest_common_substrings(
+            first, { second }).at(0);
+    if (!is_longest_common_substring(automaton_lcs, first, second)) {
+        report_failure(check, "the suffix automaton is wrong", { first, second });
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Cross-checks the longest common substring implementations on random
+ *   pairs, and on deep ones: long, highly repetitive strings that give suffix
+ *   trees long paths.
+ *
+ * @return The number of failed checks.
+ */
+static int check_longest_common_substrings() {
+    std::mt19937 engine(check_seed);
+    std::uniform_int_distribution<int> length(0, 40);
+    std::uniform_int_distribution<int> alphabet_size(1, static_cast<int>(check_symbols.size()));
+    int failures = 0;
+    for (int pair = 0; pair < 3000; pair++) {
+        const int size = alphabet_size(engine);
+        const std::string first = random_string(engine, length(engine), size);
+        const std::string second = random_string(engine, length(engine), size);
+        failures += check_longest_common_substring_pair(first, second) ? 0 : 1;
+    }
+    /* Fibonacci strings are maximally repetitive without being periodic. */
+    std::string fibonacci_previous = "a";
+    std::string fibonacci = "ab";
+    while (fibonacci.size() < 2000) {
+        fibonacci_previous = std::exchange(fibonacci, fibonacci + fibonacci_previous);
+    }
+    const std::vector<std::pair<std::string, std::string>> deep_pairs = {
+        { std::string(3000, 'a'), std::string(2000, 'a') },
+        { std::string(3000, 'a'), std::string(1500, 'a') + "b" + std::string(1500, 'a') },
+        { fibonacci, fibonacci_previous },
+        { fibonacci, fibonacci.substr(1) + "c" },
+        { random_string(engine, 2000, 2), random_string(engine, 2000, 2) }
+    };
+    for (const auto &[first, second] : deep_pairs) {
+        failures += check_longest_common_substring_pair(first, second) ? 0 : 1;
+    }
+    return failures;
+}
+
+/**
+ * @brief Cross-checks the Aho-Corasick automaton against `std::string::find`
+ *   on random texts and pattern sets.
+ *
+ * @return The number of failed checks.
+ */
+static int check_aho_corasick() {
+    const std::string check = "Aho-Corasick";
+    std::mt19937 engine(check_seed);
+    std::uniform_int_distribution<int> text_length(0, 60);
+    std::uniform_int_distribution<int> pattern_length(1, 6);
+    std::uniform_int_distribution<int> pattern_count(1, 12);
+    std::uniform_int_distribution<int> alphabet_size(1, static_cast<int>(check_symbols.size()));
+    int failures = 0;
+    for (int round = 0; round < 3000; round++) {
+        const int size = alphabet_size(engine);
+        const std::string text = random_string(engine, text_length(engine), size);
+        StringMatching::AhoCorasickAutomaton automaton;
+        std::vector<std::string> inputs = { text };
+        const int count = pattern_count(engine);
+        for (int idx = 0; idx < count; idx++) {
+            inputs.push_back(random_string(engine, pattern_length(engine), size));
+            automaton.add_pattern(inputs.back());
+        }
+        automaton.compile();
+        /* Enumerate, per pattern, every occurrence naively; in the order
+         * `all_matches` promises: by ending index, then longest first. */
+        std::vector<StringMatching::pattern_match> expected_all;
+        StringMatching::first_pattern_matches expected_first;
+        for (int id = 0; id < automaton.number_of_patterns(); id++) {
+            const std::string &pattern = automaton.pattern(id);
+            const auto length = static_cast<int>(pattern.size());
+            for (std::size_t start = text.find(pattern);
+                 start != std::string::npos;
+                 start = text.find(pattern, start + 1)) {
+                const index_range range(static_cast<int>(start), static_cast<int>(start) + length - 1);
+                expected_all.emplace_back(id, range);
+                expected_first.insert({ id, range });
+            }
+        }
+        std::sort(expected_all.begin(), expected_all.end(),
+                  [](const StringMatching::pattern_match &a, const StringMatching::pattern_match &b) {
+                      if (a.second.second != b.second.second) {
+                          return a.second.second < b.second.second;
+                      }
+                      return a.second.first < b.second.first;
+                  });
+        if (automaton.all_matches(text) != expected_all) {
+            report_failure(check, "`all_matches` disagrees with `std::string::find`", inputs);
+            failures++;
+        } else if (automaton.first_matches(text) != expected_first) {
+            report_failure(check, "`first_matches` disagrees with `std::string::find`", inputs);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/**
+ * @brief Cross-checks the approximate matcher against a naive search over
+ *   all substrings of random texts.
+ *
+ * @return The number of failed checks.
+ */
+static int check_approximate_matcher() {
+    const std::string check = "approximate matcher";
+    std::mt19937 engine(check_seed);
+    std::uniform_int_distribution<int> text_length(0, 40);
+    std::uniform_int_distribution<int> pattern_length(1, 12);
+    std::uniform_int_distribution<int> long_pattern_length(1, StringMatching::max_approximate_pattern_length + 6);
+    std::uniform_int_distribution<int> max_distance(0, 3);
+    int failures = 0;
+    for (int round = 0; round < 3000; round++) {
+        const auto size = static_cast<int>(check_symbols.size());
+        const std::string text = random_string(engine, text_length(engine), size);
+        const std::string pattern = random_string(engine,
+                                                  round % 7 == 0 ? long_pattern_length(engine) :
+                                                                   pattern_length(engine),
+                                                  size);
+        const int distance = max_distance(engine);
+        const std::vector<std::string> inputs = { text, pattern, "at most " + std::to_string(distance) + " edits" };
+        const std::vector<utf8::uint32_t> text_code_points = code_points_of(text);
+        const std::vector<utf8::uint32_t> pattern_code_points = code_points_of(pattern);
+        /* The best distance to any non-empty substring of the text. */
+        std::optional<int> best;
+        if (pattern_code_points.size() <= static_cast<std::size_t>(StringMatching::max_approximate_pattern_length)) {
+            for (std::size_t start = 0; start < text_code_points.size(); start++) {
+                for (std::size_t end = start + 1; end <= text_code_points.size(); end++) {
+                    const std::vector<utf8::uint32_t> substring(text_code_points.begin() + static_cast<long>(start),
+                                                                text_code_points.begin() + static_cast<long>(end));
+                    const int candidate = naive_levenshtein_distance(pattern_code_points, substring);
+                    best = std::min(best.value_or(candidate), candidate);
+                }
+            }
+        }
+        const int allowed = std::min(distance,
+                                     static_cast<int>(pattern_code_points.size() /
+                                                      StringMatching::approximate_pattern_length_per_edit));
+        const bool expect_match = best.has_value() && best.value() <= allowed;
+        const std::optional<StringMatching::ApproximateMatch> match =
+                StringMatching::ApproximateMatcher(text).best_match(pattern, distance);
+        if (match.has_value() != expect_match) {
+            report_failure(check, expect_match ? "no match was found" : "a match was found", inputs);
+            failures++;
+            continue;
+        } else if (!match.has_value()) {
+            continue;
+        }
+        const auto &[first, last] = match.value().bounds;
+        const std::string matched = text.substr(static_cast<std::size_t>(first),
+                                                static_cast<std::size_t>(last - first + 1));
+        if (match.value().distance != best.value() ||
+            naive_levenshtein_distance(pattern_code_points, code_points_of(matched)) != best.value()) {
+            report_failure(check, "the match is not a best one", inputs);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/**
+ * @brief Runs all cross-checks.
+ *
+ * @return int An exit signal. `0` if all checks pass; non-zero otherwise.
+ */
+int main() {
+    const int failures = check_longest_common_substrings() +
+                         check_aho_corasick() +
+                         check_approximate_matcher();
+    if (failures != 0) {
+        std::cerr << failures << " check(s) failed." << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "All checks passed." << std::endl;
+    return EXIT_SUCCESS;
+}
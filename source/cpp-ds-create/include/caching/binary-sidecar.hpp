@@ -0,0 +1,172 @@
+/* Symbols for caching dataset supplements in binary sidecar files (header). */
+
+#ifndef BINARY_SIDECAR_HPP
+#define BINARY_SIDECAR_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "utilities.hpp"
+
+namespace DutchKBQADSCreate::Caching {
+    /**
+     * @brief A read-only, memory-mapped file. On platforms without `mmap`, the
+     *   file is read into memory instead.
+     */
+    class MappedFile {
+    private:
+        const char *mapped;
+        std::size_t mapped_size;
+        std::vector<char> fallback;  /* The file's contents, if not mapped. */
+    public:
+        explicit MappedFile(const fs::path &path);
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        ~MappedFile();
+        [[nodiscard]] const char *data() const;
+        [[nodiscard]] std::size_t size() const;
+    };
+
+    /**
+     * @brief The properties of a source file by which a sidecar determines
+     *   whether it is still up-to-date.
+     */
+    struct SourceFingerprint {
+        std::uint64_t size;
+        std::int64_t modification_time;
+        /**
+         * @brief An FNV-1a hash of the file's contents. Only compared when
+         *   the file's size matches but its modification time does not, so
+         *   that files that are merely touched or copied stay cached.
+         */
+        std::uint64_t content_hash;
+    };
+
+    /**
+     * @brief The kind of data a sidecar stores. A sidecar of one kind is
+     *   never read as another.
+     */
+    enum SidecarKind : std::uint32_t {
+        QUESTION_ENTITIES_PROPERTIES_MAP = 1,
+        ENTITY_PROPERTY_LABELS = 2,
+        FINALISED_DATASET_PARTITION = 3
+    };
+
+    /**
+     * @brief The sidecar format version. Increment it whenever the layout of
+     *   any sidecar kind changes, so that older sidecars are rebuilt.
+     */
+    const std::uint32_t sidecar_version = 1;
+
+    /**
+     * @brief A writer of a sidecar: a header, followed by a series of
+     *   sections. Each section is a count followed by that many fixed-size
+     *   elements, padded to a multiple of eight bytes.
+     *
+     * The sidecar is written to a temporary file, and only replaces any
+     * existing sidecar once `commit` is called.
+     */
+    class SidecarWriter {
+    private:
+        fs::path path;
+        fs::path temporary_path;
+        std::ofstream file;
+        void write_bytes(const void *bytes, std::size_t length);
+    public:
+        SidecarWriter(const fs::path &path, SidecarKind kind, const SourceFingerprint &source);
+        template <typename T>
+        void write_section(const T *elements, std::size_t count);
+        template <typename T>
+        void write_section(const std::vector<T> &elements);
+        void commit();
+    };
+
+    /**
+     * @brief A reader of a sidecar written by `SidecarWriter`. Sections must
+     *   be read in the order in which they were written.
+     */
+    class SidecarReader {
+    private:
+        fs::path path;
+        MappedFile file;
+        std::size_t position;
+        const char *next_bytes(std::size_t length);
+    public:
+        explicit SidecarReader(const fs::path &path);
+        [[nodiscard]] bool matches(SidecarKind kind, const fs::path &source);
+        template <typename T>
+        std::vector<T> read_section();
+        std::string read_string_section();
+    };
+
+    /**
+     * @brief The initial value of a 64-bit FNV-1a hash.
+     */
+    const std::uint64_t fnv_1a_offset_basis = 0xcbf29ce484222325ull;
+
+    std::uint64_t fnv_1a_hash(const char *bytes, std::size_t length, std::uint64_t hash = fnv_1a_offset_basis);
+    SourceFingerprint source_fingerprint(const fs::path &source);
+    bool fingerprint_matches(const SourceFingerprint &fingerprint, const fs::path &source);
+    fs::path sidecar_path_for(const fs::path &source);
+    std::unique_ptr<SidecarReader> opened_sidecar(const fs::path &source, SidecarKind kind);
+
+    /**
+     * @brief Writes a section of `count` elements starting at `elements`.
+     *
+     * @tparam T The trivially copyable element type.
+     * @param elements The first element.
+     * @param count The number of elements.
+     */
+    template <typename T>
+    void SidecarWriter::write_section(const T *elements, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "Sidecar elements must be trivially copyable.");
+        const std::uint64_t stored_count = count;
+        this->write_bytes(&stored_count, sizeof(stored_count));
+        this->write_bytes(elements, count * sizeof(T));
+        const std::size_t padding = (8 - (count * sizeof(T)) % 8) % 8;
+        const char zeroes[8] = {};
+        this->write_bytes(zeroes, padding);
+    }
+
+    /**
+     * @brief Writes a section containing the elements of `elements`.
+     *
+     * @tparam T The trivially copyable element type.
+     * @param elements The elements.
+     */
+    template <typename T>
+    void SidecarWriter::write_section(const std::vector<T> &elements) {
+        this->write_section(elements.data(), elements.size());
+    }
+
+    /**
+     * @brief Returns the elements of the next section.
+     *
+     * The elements are copied out of the mapping in bulk, so that the result
+     * does not depend on the sidecar staying mapped.
+     *
+     * @tparam T The trivially copyable element type the section was written
+     *   with.
+     * @return The elements.
+     */
+    template <typename T>
+    std::vector<T> SidecarReader::read_section() {
+        static_assert(std::is_trivially_copyable_v<T>, "Sidecar elements must be trivially copyable.");
+        std::uint64_t count;
+        std::memcpy(&count, this->next_bytes(sizeof(count)), sizeof(count));
+        if (count > (this->file.size() - this->position) / sizeof(T)) {
+            throw std::runtime_error("A sidecar section exceeds the sidecar's size.");
+        }
+        std::vector<T> elements(count);
+        std::memcpy(elements.data(), this->next_bytes(count * sizeof(T)), count * sizeof(T));
+        this->next_bytes((8 - (count * sizeof(T)) % 8) % 8);
+        return elements;
+    }
+}
+
+#endif  /* BINARY_SIDECAR_HPP */
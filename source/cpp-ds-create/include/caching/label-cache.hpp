@@ -0,0 +1,70 @@
+/* Symbols for caching WikiData label responses across dataset splits (header). */
+
+#ifndef LABEL_CACHE_HPP
+#define LABEL_CACHE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <json/json.h>
+#include "utilities.hpp"
+#include "wikidata/symbol-ids.hpp"
+
+namespace DutchKBQADSCreate::Caching {
+    /**
+     * @brief The name of the label cache file in `resources/dataset/`, without
+     *   `.jsonl` extension.
+     */
+    const std::string label_cache_file_name = "supplements/entity-property-label-cache";
+
+    /**
+     * @brief A persistent cache of the labels WikiData returned for entities
+     *   and properties, keyed by entity or property and natural language.
+     *   Unlike the labels files, it is shared by all dataset splits.
+     *
+     * The cache is an append-only JSON Lines file, of which every record holds
+     * the labels of one labelling query's entities and properties, in one
+     * natural language, along with when they were fetched. Later records
+     * supersede earlier ones. On construction, the file is indexed in memory.
+     */
+    class LabelResponseCache {
+    private:
+        /**
+         * @brief The cached labels of one entity or property in one natural
+         *   language.
+         */
+        struct Entry {
+            /**
+             * @brief When the labels were fetched, in seconds since the UNIX
+             *   epoch.
+             */
+            std::int64_t fetched;
+            std::vector<std::string> labels;
+        };
+        std::string file_name;
+        /**
+         * @brief How long cached labels remain valid. Zero if they never
+         *   expire.
+         */
+        std::chrono::seconds ttl;
+        std::unordered_map<std::uint64_t, Entry> entries;
+        /**
+         * @brief The number of entries in the file that have been superseded
+         *   by later records.
+         */
+        std::size_t superseded;
+        static std::uint64_t key_of(WikiData::symbol_id id, const NaturalLanguage &language);
+        void index_record(const Json::Value &record);
+    public:
+        explicit LabelResponseCache(std::chrono::seconds ttl, std::string file_name = label_cache_file_name);
+        [[nodiscard]] const std::vector<std::string> *fresh_labels(WikiData::symbol_id id,
+                                                                   const NaturalLanguage &language) const;
+        void store(const Json::Value &labels, const NaturalLanguage &language);
+        [[nodiscard]] bool worth_compacting() const;
+        void compact();
+    };
+}
+
+#endif  /* LABEL_CACHE_HPP */
@@ -0,0 +1,71 @@
+/* Symbols for masking only the question-answer pairs whose inputs changed (header). */
+
+#ifndef MASKING_MANIFEST_HPP
+#define MASKING_MANIFEST_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "caching/binary-sidecar.hpp"
+#include "utilities.hpp"
+
+namespace DutchKBQADSCreate::Caching {
+    /**
+     * @brief The masking manifest format version. Increment it whenever the
+     *   manifest's layout changes, or whenever masking itself changes such
+     *   that pairs with unchanged inputs would be masked differently, so that
+     *   all pairs are masked anew.
+     */
+    const std::uint32_t masking_manifest_version = 1;
+
+    /**
+     * @brief An incremental 64-bit FNV-1a hash over a series of values.
+     *
+     * Strings are hashed together with their lengths, so that different series
+     * of strings with the same concatenation hash differently.
+     */
+    class InputHasher {
+    private:
+        std::uint64_t hash;
+    public:
+        InputHasher();
+        void add(std::uint64_t value);
+        void add(std::string_view value);
+        [[nodiscard]] std::uint64_t digest() const;
+    };
+
+    /**
+     * @brief A record of the hashes of the inputs from which each question-
+     *   answer pair of a masked question-answer pairs file was masked, along
+     *   with the fingerprint of that file.
+     *
+     * A pair whose inputs hash the same as they did before need not be masked
+     * again: its masked equivalent (or its absence, if it could not be masked)
+     * can be taken from the masked pairs file instead. The manifest is stored
+     * in `resources/dataset/supplements/`, and is only used as long as the
+     * masked pairs file it describes is unchanged.
+     */
+    class MaskingManifest {
+    private:
+        std::string output_file_name;
+        /**
+         * @brief The hash of the inputs of each question-answer pair, keyed by
+         *   the pairs' UIDs.
+         */
+        std::unordered_map<int, std::uint64_t> input_hashes;
+        static std::string file_name_for(const std::string &output_file_name);
+    public:
+        explicit MaskingManifest(std::string output_file_name);
+        static std::optional<MaskingManifest> loaded(const std::string &output_file_name);
+        [[nodiscard]] std::size_t size() const;
+        [[nodiscard]] bool unchanged(int uid, std::uint64_t input_hash) const;
+        void record(int uid, std::uint64_t input_hash);
+        void record_all(const MaskingManifest &manifest);
+        void save() const;
+        static void remove(const std::string &output_file_name);
+    };
+}
+
+#endif  /* MASKING_MANIFEST_HPP */
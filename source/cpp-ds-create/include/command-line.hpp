@@ -13,7 +13,11 @@ namespace DutchKBQADSCreate {
         REPLACE_SPECIAL_SYMBOLS,
         GENERATE_QUESTION_TO_ENTITIES_PROPERTIES_MAP,
         LABEL_ENTITIES_AND_PROPERTIES,
-        MASK_QUESTION_ANSWER_PAIRS
+        COMPACT_ENTITY_AND_PROPERTY_LABELS,
+        MASK_QUESTION_ANSWER_PAIRS,
+        PIPELINE,
+        MERGE_SHARDS,
+        FINALISE_DATASET
     };
     const std::unordered_map<std::string, DutchKBQADSCreate::TaskType> string_to_task_type_map = {
         {"replace-special-symbols",
@@ -22,8 +26,16 @@ namespace DutchKBQADSCreate {
          DutchKBQADSCreate::GENERATE_QUESTION_TO_ENTITIES_PROPERTIES_MAP},
         {"label-entities-and-properties",
          DutchKBQADSCreate::LABEL_ENTITIES_AND_PROPERTIES},
+        {"compact-entity-and-property-labels",
+         DutchKBQADSCreate::COMPACT_ENTITY_AND_PROPERTY_LABELS},
         {"mask-question-answer-pairs",
-         DutchKBQADSCreate::MASK_QUESTION_ANSWER_PAIRS}
+         DutchKBQADSCreate::MASK_QUESTION_ANSWER_PAIRS},
+        {"pipeline",
+         DutchKBQADSCreate::PIPELINE},
+        {"merge-shards",
+         DutchKBQADSCreate::MERGE_SHARDS},
+        {"finalise-dataset",
+         DutchKBQADSCreate::FINALISE_DATASET}
     };
     using vm_desc_pair = std::pair<DutchKBQADSCreate::po::variables_map,
                                    DutchKBQADSCreate::po::options_description>;
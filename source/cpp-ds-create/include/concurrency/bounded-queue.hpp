@@ -0,0 +1,144 @@
+/* Symbols for passing work between the threads of a pipeline (header). */
+
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace DutchKBQADSCreate::Concurrency {
+    /**
+     * @brief A first-in, first-out queue of at most a fixed number of items,
+     *   through which one stage of a pipeline hands its output to the next.
+     *
+     * Pushing to a full queue blocks until an item is popped, so that a stage
+     * that outpaces the next one is held back ('backpressure') rather than
+     * piling up items in memory. Once closed, a queue accepts no more items,
+     * but the items it holds can still be popped.
+     *
+     * @tparam T The type of the items.
+     */
+    template <typename T>
+    class BoundedQueue {
+    private:
+        std::size_t capacity;
+        std::deque<T> items;
+        bool closed;
+        std::mutex mutex;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+    public:
+        explicit BoundedQueue(std::size_t capacity);
+        bool push(T item);
+        std::optional<T> pop();
+        std::optional<T> try_pop();
+        void close();
+    };
+
+    /**
+     * @brief Constructs an empty, open queue.
+     *
+     * @tparam T The type of the items.
+     * @param capacity The largest number of items the queue holds at once.
+     *   Minimally 1.
+     */
+    template <typename T>
+    BoundedQueue<T>::BoundedQueue(std::size_t capacity) : capacity(capacity), closed(false) {
+        if (capacity < 1) {
+            throw std::invalid_argument(std::string("The capacity of a queue must be at least 1, but is ") +
+                                        std::to_string(capacity) +
+                                        ".");
+        }
+    }
+
+    /**
+     * @brief Adds `item` to the back of the queue, waiting until the queue has
+     *   room for it.
+     *
+     * @tparam T The type of the items.
+     * @param item The item.
+     * @return Whether the item was added (`true`), or dropped because the
+     *   queue is closed (`false`).
+     */
+    template <typename T>
+    bool BoundedQueue<T>::push(T item) {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->not_full.wait(lock, [this] () -> bool {
+            return this->closed || this->items.size() < this->capacity;
+        });
+        if (this->closed) {
+            return false;
+        }
+        this->items.push_back(std::move(item));
+        lock.unlock();
+        this->not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Removes and returns the item at the front of the queue, waiting
+     *   until there is one.
+     *
+     * @tparam T The type of the items.
+     * @return The item, or null if the queue is closed and empty.
+     */
+    template <typename T>
+    std::optional<T> BoundedQueue<T>::pop() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->not_empty.wait(lock, [this] () -> bool {
+            return this->closed || !this->items.empty();
+        });
+        if (this->items.empty()) {
+            return std::nullopt;
+        }
+        std::optional<T> item(std::move(this->items.front()));
+        this->items.pop_front();
+        lock.unlock();
+        this->not_full.notify_one();
+        return item;
+    }
+
+    /**
+     * @brief Removes and returns the item at the front of the queue, if there
+     *   is one, without waiting.
+     *
+     * @tparam T The type of the items.
+     * @return The item, or null if the queue is empty.
+     */
+    template <typename T>
+    std::optional<T> BoundedQueue<T>::try_pop() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        if (this->items.empty()) {
+            return std::nullopt;
+        }
+        std::optional<T> item(std::move(this->items.front()));
+        this->items.pop_front();
+        lock.unlock();
+        this->not_full.notify_one();
+        return item;
+    }
+
+    /**
+     * @brief Closes the queue: later pushes are dropped, and pops return null
+     *   once the queue is empty. Wakes all waiting threads.
+     *
+     * @tparam T The type of the items.
+     */
+    template <typename T>
+    void BoundedQueue<T>::close() {
+        {
+            const std::lock_guard<std::mutex> lock(this->mutex);
+            this->closed = true;
+        }
+        this->not_empty.notify_all();
+        this->not_full.notify_all();
+    }
+}
+
+#endif  /* BOUNDED_QUEUE_HPP */
@@ -0,0 +1,96 @@
+/* Symbols for matching many patterns at once using Aho-Corasick automata (header). */
+
+#ifndef AHO_CORASICK_HPP
+#define AHO_CORASICK_HPP
+
+#include <map>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include "utilities.hpp"
+
+namespace DutchKBQADSCreate::StringMatching {
+    /**
+     * @brief A single occurrence of a pattern within a text. The first entry
+     *   is the pattern's ID; the second entry is the index range (both ends
+     *   inclusive) the occurrence spans within the text.
+     */
+    using pattern_match = std::pair<int, index_range>;
+    /**
+     * @brief A mapping from pattern IDs to the index range of the first
+     *   (leftmost) occurrence of that pattern within some text. Patterns that
+     *   do not occur in the text are absent from the map.
+     */
+    using first_pattern_matches = std::unordered_map<int, index_range>;
+
+    /**
+     * @brief A special value indicating the absence of a state or pattern.
+     */
+    const int no_automaton_entry = -1;
+
+    /**
+     * @brief A single state of an Aho-Corasick automaton; a node of the trie
+     *   spelled out by the automaton's patterns.
+     */
+    struct AhoCorasickState {
+        /**
+         * @brief The 'goto' function of Aho and Corasick (1975), restricted to
+         *   transitions departing from this state. Maps bytes to state
+         *   indices.
+         */
+        std::map<unsigned char, int> transitions;
+        /**
+         * @brief The state representing the longest proper suffix of this
+         *   state's string that is also a prefix of some pattern. Aho and
+         *   Corasick (1975) call this the 'failure function'.
+         */
+        int failure;
+        /**
+         * @brief The nearest state along the failure path that completes a
+         *   pattern. Used to enumerate all patterns ending at a text position
+         *   without walking over states that complete none.
+         */
+        int dictionary_link;
+        /**
+         * @brief The ID of the pattern this state completes, if any.
+         */
+        int pattern;
+    };
+
+    /**
+     * @brief An automaton that finds occurrences of many patterns in a text
+     *   using a single left-to-right pass over said text (Aho & Corasick,
+     *   1975).
+     *
+     * Patterns and texts are treated as sequences of bytes. Thus, for UTF8
+     * input, the index ranges reported are byte offsets, exactly as those of
+     * `std::string::find`.
+     *
+     * Usage is two-phased: first, add all patterns via `add_pattern`; second,
+     * call `compile` once. Only then may the automaton be searched with.
+     * Searching does not mutate the automaton, so a compiled automaton may be
+     * shared between threads.
+     */
+    class AhoCorasickAutomaton {
+    private:
+        std::vector<AhoCorasickState> states;
+        /**
+         * @brief The patterns of this automaton. A pattern's ID is its index
+         *   in this vector.
+         */
+        std::vector<std::string> patterns;
+        bool compiled;
+        int next_state(int state, unsigned char symbol) const;
+    public:
+        AhoCorasickAutomaton();
+        int add_pattern(const std::string &pattern);
+        void compile();
+        [[nodiscard]] bool is_compiled() const;
+        [[nodiscard]] int number_of_patterns() const;
+        [[nodiscard]] const std::string &pattern(int pattern_id) const;
+        [[nodiscard]] std::vector<pattern_match> all_matches(const std::string &text) const;
+        [[nodiscard]] first_pattern_matches first_matches(const std::string &text) const;
+    };
+}
+
+#endif  /* AHO_CORASICK_HPP */
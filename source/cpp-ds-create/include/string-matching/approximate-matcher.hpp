@@ -0,0 +1,77 @@
+/* Symbols for finding approximate occurrences of patterns using bit-parallel edit distances (header). */
+
+#ifndef APPROXIMATE_MATCHER_HPP
+#define APPROXIMATE_MATCHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "utilities.hpp"
+
+namespace DutchKBQADSCreate::StringMatching {
+    /**
+     * @brief The largest number of code points a pattern may have to be
+     *   matched approximately: one per bit of a machine word.
+     */
+    const std::size_t max_approximate_pattern_length = 64;
+
+    /**
+     * @brief The number of code points a pattern must have per edit that an
+     *   approximate occurrence of it may differ by. Keeps short patterns from
+     *   matching nearly anywhere.
+     */
+    const std::size_t approximate_pattern_length_per_edit = 4;
+
+    /**
+     * @brief An approximate occurrence of a pattern within a text.
+     */
+    struct ApproximateMatch {
+        /**
+         * @brief The index range (both ends inclusive) the occurrence spans
+         *   within the text, in bytes.
+         */
+        index_range bounds;
+        /**
+         * @brief The edit (Levenshtein) distance between the pattern and the
+         *   occurrence, in code points.
+         */
+        int distance;
+    };
+
+    /**
+     * @brief A text in which approximate occurrences of any number of patterns
+     *   can be searched for, each in a single pass over the text.
+     *
+     * Distances are counted in code points, so that, for example, replacing
+     * `e` by `ë` is a single edit. Every pattern is searched for with the
+     * bit-parallel algorithm of Myers (1999), which computes the edit
+     * distances of a pattern of up to 64 code points to all substrings of the
+     * text ending at a position in a constant number of word operations.
+     *
+     * The text is decoded once, when constructing the matcher. Searching does
+     * not mutate the matcher, so it may be shared between threads.
+     */
+    class ApproximateMatcher {
+    private:
+        /**
+         * @brief The UTF32-encoded code points of the text.
+         */
+        std::vector<std::uint32_t> code_points;
+        /**
+         * @brief For each code point, the byte offset at which it starts within
+         *   the text, followed by the size of the text in bytes.
+         */
+        std::vector<int> byte_offsets;
+        [[nodiscard]] std::size_t start_of_match(const std::vector<std::uint32_t> &pattern,
+                                                 std::size_t end,
+                                                 int distance) const;
+    public:
+        explicit ApproximateMatcher(const std::string &text);
+        [[nodiscard]] std::optional<ApproximateMatch> best_match(std::string_view pattern, int max_distance) const;
+    };
+}
+
+#endif  /* APPROXIMATE_MATCHER_HPP */
@@ -3,9 +3,11 @@
 #ifndef EXPLICIT_STATE_HPP
 #define EXPLICIT_STATE_HPP
 
+#include <atomic>
 #include <variant>
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include "utf8.h"
 #include "suffix-trees/unicode-string.hpp"
 
@@ -98,9 +100,10 @@ namespace DutchKBQADSCreate::SuffixTrees {
         /**
          * @brief A simple 'global' counter that increments every time a new
          *   explicit state is created, ensuring each such state gets assigned
-         *   a new, unique ID.
+         *   a new, unique ID. Atomic, so that trees may be constructed on
+         *   several threads at once.
          */
-        static int explicit_states_id_counter;
+        static std::atomic<int> explicit_states_id_counter;
     private:
         /**
          * @brief A unique identifier for this explicit state.
@@ -138,7 +141,7 @@ namespace DutchKBQADSCreate::SuffixTrees {
         explicit ExplicitState(ExplicitState *parent);
         virtual ~ExplicitState();
         [[nodiscard]] int get_id() const;
-        void set_transition(UnicodeString uni_str,
+        void set_transition(UnicodeStringView uni_str,
                             int left_ptr,
                             right_pointer right_ptr,
                             std::unique_ptr<ExplicitState> child);
@@ -146,14 +149,14 @@ namespace DutchKBQADSCreate::SuffixTrees {
         ExplicitState *get_suffix_link();
         virtual bool has_transition(utf8::uint32_t code_point);
         virtual weak_state_transition weakly_get_transition(utf8::uint32_t code_point);
-        ExplicitState *internal_split(UnicodeString uni_str,
+        ExplicitState *internal_split(UnicodeStringView uni_str,
                                       int left_ptr,
                                       right_pointer right_ptr);
         virtual std::optional<ExplicitState*> state_transition_if_present(utf8::uint32_t code_point);
         state_transitions::iterator transitions_start();
         state_transitions::iterator transitions_end();
         [[nodiscard]] std::string as_string() const;
-        virtual void print(UnicodeString uni_str, int num_indents);
+        virtual void print(UnicodeStringView uni_str, int num_indents);
     };
 
     /**
@@ -190,14 +193,21 @@ namespace DutchKBQADSCreate::SuffixTrees {
          * 'squashed'. Here, however, we leave them all distinct.
          */
         std::vector<code_point_pointer_pair> left_right_pointer_pair_integers_per_code_point;
+        /**
+         * @brief For each distinct code point, the pointer of its first entry
+         *   in `left_right_pointer_pair_integers_per_code_point`. Makes
+         *   looking up transitions from the auxiliary state take constant
+         *   (instead of linear) time.
+         */
+        std::unordered_map<utf8::uint32_t, int*> first_pointer_per_code_point;
     public:
-        explicit AuxiliaryState(UnicodeString uni_str);
+        explicit AuxiliaryState(UnicodeStringView uni_str);
         ~AuxiliaryState() override;
         int *weak_pointer_for_code_point(utf8::uint32_t code_point);
         bool has_transition(utf8::uint32_t code_point) override;
         weak_state_transition weakly_get_transition(utf8::uint32_t code_point) override;
         std::optional<ExplicitState*> state_transition_if_present(utf8::uint32_t code_point) override;
-        void print(UnicodeString uni_str, int num_indents) override;
+        void print(UnicodeStringView uni_str, int num_indents) override;
     };
 }
 
@@ -0,0 +1,133 @@
+/* Symbols for constructing arena-allocated Ukkonen suffix trees (header). */
+
+#ifndef FLAT_SUFFIX_TREE_HPP
+#define FLAT_SUFFIX_TREE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "utf8.h"
+#include "suffix-trees/unicode-string.hpp"
+
+namespace DutchKBQADSCreate::SuffixTrees {
+    /**
+     * @brief An index into the node or edge arena of a `FlatSuffixTree`.
+     */
+    using arena_index = std::int32_t;
+
+    /**
+     * @brief A special arena index, indicating the absence of a node or edge.
+     */
+    const arena_index no_arena_index = -1;
+    /**
+     * @brief A special right pointer, indicating that an edge leads to a leaf
+     *   and thus grows along with the tree's global leaf right pointer.
+     *
+     * This replaces the shared `std::unique_ptr<int>` that `ExplicitState`
+     * leaf transitions point to.
+     */
+    const std::int32_t open_right_ptr = -1;
+
+    /**
+     * @brief An explicit state of a `FlatSuffixTree`.
+     *
+     * Contrast with `ExplicitState`: transitions are not stored inside the
+     * node; instead, the node refers to the first of its outgoing edges in the
+     * tree's edge arena.
+     */
+    struct FlatNode {
+        /**
+         * @brief The node representing this node's string minus its first
+         *   code point. See `ExplicitState::suffix_link`.
+         */
+        arena_index suffix_link;
+        /**
+         * @brief The first outgoing edge of this node. Outgoing edges are
+         *   ordered by their first code point, ascending.
+         */
+        arena_index first_edge;
+    };
+
+    /**
+     * @brief A generalised transition of a `FlatSuffixTree`.
+     *
+     * Pointers are 1-based and inclusive, as in Ukkonen (1995) and in
+     * `left_right_pointer_pair`.
+     */
+    struct FlatEdge {
+        /**
+         * @brief The first code point of the substring spelled out by this
+         *   edge.
+         */
+        utf8::uint32_t code_point;
+        std::int32_t left_ptr;
+        /**
+         * @brief The right pointer of the edge, or `open_right_ptr` if the edge
+         *   leads to a leaf.
+         */
+        std::int32_t right_ptr;
+        arena_index child;
+        /**
+         * @brief The next outgoing edge of the same departure node.
+         */
+        arena_index next_sibling;
+    };
+
+    /**
+     * @brief A Ukkonen suffix tree (Ukkonen, 1995) whose nodes and edges live
+     *   in two contiguous arenas, addressed by 32-bit indices.
+     *
+     * The construction procedure is identical to that of `SuffixTree`, but no
+     * allocations are made per node or edge: the arenas are reserved up-front,
+     * and all leaves share a single right pointer integer. Unlike `SuffixTree`,
+     * the auxiliary state has no stored transitions; its transitions to the
+     * root are implied.
+     */
+    class FlatSuffixTree {
+    private:
+        /**
+         * @brief The UTF32-encoded Unicode string on which this suffix tree is
+         *   based.
+         */
+        UnicodeString uni_str;
+        std::vector<FlatNode> nodes;
+        std::vector<FlatEdge> edges;
+        /**
+         * @brief The right pointer (inclusive) shared by all edges towards
+         *   leaves. See `SuffixTree::leaf_right_ptr`.
+         */
+        std::int32_t leaf_right_ptr;
+        arena_index new_node();
+        void add_edge(arena_index node,
+                      std::int32_t left_ptr,
+                      std::int32_t right_ptr,
+                      arena_index child);
+        std::pair<arena_index, std::int32_t> canonised(arena_index state, std::int32_t left_ptr, std::int32_t right_ptr);
+        std::pair<bool, arena_index> test_and_split(arena_index state,
+                                                    std::int32_t left_ptr,
+                                                    std::int32_t right_ptr,
+                                                    utf8::uint32_t code_point);
+        std::pair<arena_index, std::int32_t> update(arena_index state, std::int32_t left_ptr, std::int32_t right_ptr);
+    public:
+        /**
+         * @brief The arena index of the auxiliary state.
+         */
+        static constexpr arena_index auxiliary = 0;
+        /**
+         * @brief The arena index of the root.
+         */
+        static constexpr arena_index root = 1;
+        explicit FlatSuffixTree(const std::string &str);
+        explicit FlatSuffixTree(UnicodeString uni_str);
+        void construct();
+        [[nodiscard]] UnicodeStringView get_uni_str() const;
+        [[nodiscard]] arena_index edge_for_code_point(arena_index node, utf8::uint32_t code_point) const;
+        [[nodiscard]] arena_index first_edge(arena_index node) const;
+        [[nodiscard]] const FlatEdge &edge(arena_index edge_idx) const;
+        [[nodiscard]] std::int32_t edge_right_ptr(arena_index edge_idx) const;
+        [[nodiscard]] arena_index suffix_link(arena_index node) const;
+        [[nodiscard]] bool is_leaf(arena_index node) const;
+        [[nodiscard]] int number_of_nodes() const;
+    };
+}
+
+#endif  /* FLAT_SUFFIX_TREE_HPP */
@@ -3,42 +3,151 @@
 #ifndef LONGEST_COMMON_SUBSTRING_HPP
 #define LONGEST_COMMON_SUBSTRING_HPP
 
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 #include "explicit-state.hpp"
+#include "flat-suffix-tree.hpp"
+#include "suffix-array.hpp"
+#include "suffix-automaton.hpp"
 #include "utilities.hpp"
 
 namespace DutchKBQADSCreate::SuffixTrees {
     /**
-     * @brief A character pair. The first entry stores a symbol to separate two
-     *   strings; the second stores a symbol to terminate the second string
-     *   with.
+     * @brief A sentinel code point with which to separate two concatenated
+     *   strings.
+     *
+     * The Unicode code space ends at U+10FFFF. Because this sentinel lies
+     * beyond it, it cannot occur in any (validly encoded) input string, so no
+     * candidate separator ever needs to be rejected.
      */
-    using separator_end_pair = std::pair<char, char>;
-
+    const utf8::uint32_t separator_code_point = 0x110000;
     /**
-     * @brief A series of separator-end pairs. These symbol pairs are used to
-     *   respectively separate and terminate two concatenated strings using
-     *   two singular symbols.
-     *
-     * This series is needed, because one or both strings may already contain
-     * the separator or ending symbol; both need to be unique to be able to
-     * distinguish them.
-     */
-    const std::vector<separator_end_pair> separator_end_pairs {
-        { '_', '*' },
-        { '_', '$' },
-        { '#', '$' },
-        { '&', '~' }
-    };
+     * @brief A sentinel code point with which to terminate two concatenated
+     *   strings. See `separator_code_point`.
+     */
+    const utf8::uint32_t end_code_point = 0x110001;
     /**
      * @brief A classification of a string as a certain substring with respect
      *   to two strings. It either is unclassified, or belongs to one (or both)
      *   of the latter two strings.
+     *
+     * `FIRST` and `SECOND` are distinct bits, and `FIRST_AND_SECOND` is their
+     * union, so that types can be combined with a bitwise OR.
      */
     enum SubstringType {
-        UNDETERMINED,  /* The state's substring has not yet been classified. */
-        FIRST,  /* The state's substring belongs only to the first string. */
-        SECOND,  /* The state's substring belongs only to the second string. */
-        FIRST_AND_SECOND  /* The state's substring belongs to both the first and second string. */
+        UNDETERMINED = 0b00,  /* The state's substring has not yet been classified. */
+        FIRST = 0b01,  /* The state's substring belongs only to the first string. */
+        SECOND = 0b10,  /* The state's substring belongs only to the second string. */
+        FIRST_AND_SECOND = 0b11  /* The state's substring belongs to both the first and second string. */
+    };
+    /**
+     * @brief A suffix structure with which to compute longest common
+     *   substrings. All backends yield identical results.
+     */
+    enum LCSBackend {
+        EXPLICIT_STATE_SUFFIX_TREE,  /* A `SuffixTree` of heap-allocated `ExplicitState`s. */
+        FLAT_SUFFIX_TREE,  /* A `FlatSuffixTree`, backed by node and edge arenas. */
+        SUFFIX_ARRAY  /* A `SuffixArray` with its longest common prefix array. */
+    };
+    /**
+     * @brief A compact set of flags that is stored per node of a
+     *   `FlatSuffixTree` while classifying its substrings.
+     *
+     * The lowest two bits hold the node's `SubstringType`, preliminary or
+     * final. The remaining bits are the flags below.
+     */
+    using substring_flags = std::uint8_t;
+    /**
+     * @brief The bits of `substring_flags` that hold a `SubstringType`.
+     */
+    const substring_flags substring_type_mask = 0b0011;
+    /**
+     * @brief Set if at least one child of the node is classified as
+     *   `FIRST_AND_SECOND`.
+     */
+    const substring_flags common_child_flag = 0b0100;
+    /**
+     * @brief Set if the node is the suffix link of some node classified as
+     *   `FIRST_AND_SECOND`.
+     */
+    const substring_flags left_extendable_flag = 0b1000;
+
+    /**
+     * @brief An explicit state on the stack of `state_substring_type`'s
+     *   post-order walk.
+     */
+    struct ExplicitTraversalFrame {
+        ExplicitState *es;
+        /**
+         * @brief The transition of `es` to walk next.
+         */
+        state_transitions::iterator transition;
+        /**
+         * @brief The length of the substring that `es` represents.
+         */
+        int length;
+        /**
+         * @brief The right pointer of the transition towards `es`.
+         */
+        int right_ptr;
+        SubstringType type;
+    };
+
+    /**
+     * @brief A node on the stack of the post-order walk over a
+     *   `FlatSuffixTree`.
+     */
+    struct FlatTraversalFrame {
+        arena_index node;
+        /**
+         * @brief The outgoing edge of `node` to walk next.
+         */
+        arena_index edge;
+        /**
+         * @brief The length of the substring that `node` represents.
+         */
+        int length;
+        /**
+         * @brief The right pointer of the edge towards `node`.
+         */
+        int right_ptr;
+    };
+
+    /**
+     * @brief The number of pairs that a worker of `longest_common_substrings`
+     *   claims at once.
+     */
+    const std::size_t lcs_chunk_size = 64;
+
+    /**
+     * @brief Reusable buffers with which to compute longest common substrings
+     *   using the `SUFFIX_ARRAY` backend.
+     *
+     * Each call reuses the buffers of the previous one, which keep their
+     * capacity, so computing the longest common substrings of many pairs
+     * hardly allocates. A workspace must not be shared between threads; give
+     * each thread its own.
+     */
+    class LCSWorkspace {
+    private:
+        /**
+         * @brief The code points of the two concatenated strings, including
+         *   their sentinels.
+         */
+        std::vector<utf8::uint32_t> code_points;
+        std::vector<utf8::uint32_t> alphabet;
+        /**
+         * @brief The ranks of `code_points` among the distinct code points.
+         */
+        std::vector<std::int32_t> text;
+        std::vector<std::int32_t> suffixes;
+        std::vector<std::int32_t> ranks;
+        std::vector<std::int32_t> lcp;
+    public:
+        std::optional<std::string> longest_common_substring(const std::string &first, const std::string &second);
     };
 
     bool is_leaf_state(ExplicitState *es);
@@ -49,7 +158,34 @@ namespace DutchKBQADSCreate::SuffixTrees {
                                        int *lcs_length,
                                        int *lcs_start_index,
                                        index_range sep_end_range);
-    std::optional<std::string> longest_common_substring(const std::string &first, const std::string &second);
+    SubstringType flat_state_substring_type(const FlatSuffixTree &tree,
+                                            arena_index node,
+                                            int length,
+                                            int *lcs_length,
+                                            int *lcs_start_index,
+                                            index_range sep_end_range);
+    void suffix_array_longest_common_substring(const std::vector<std::int32_t> &suffixes,
+                                               const std::vector<std::int32_t> &lcp,
+                                               int sep_index,
+                                               int *lcs_length,
+                                               int *lcs_start_index);
+    std::vector<index_range> flat_maximal_common_substrings(const FlatSuffixTree &tree,
+                                                            index_range sep_end_range,
+                                                            int min_length);
+    std::optional<std::string> longest_common_substring(const std::string &first,
+                                                        const std::string &second,
+                                                        LCSBackend backend = EXPLICIT_STATE_SUFFIX_TREE);
+    std::vector<std::optional<std::string>> longest_common_substrings(
+        const std::vector<std::pair<std::string, std::string>> &pairs,
+        int threads = 1
+    );
+    std::vector<std::optional<std::string>> one_vs_many_longest_common_substrings(
+        const std::string &first,
+        const std::vector<std::string> &others
+    );
+    std::vector<std::string> maximal_common_substrings(const std::string &first,
+                                                       const std::string &second,
+                                                       int min_length);
 }
 
 #endif  /* LONGEST_COMMON_SUBSTRING_HPP */
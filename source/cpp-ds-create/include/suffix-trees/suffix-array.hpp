@@ -0,0 +1,63 @@
+/* Symbols for constructing suffix arrays with longest common prefixes (header). */
+
+#ifndef SUFFIX_ARRAY_HPP
+#define SUFFIX_ARRAY_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "suffix-trees/unicode-string.hpp"
+
+namespace DutchKBQADSCreate::SuffixTrees {
+    /**
+     * @brief The suffix array of a string, together with its longest common
+     *   prefix (LCP) array.
+     *
+     * The suffix array is built with SA-IS (Nong et al., 2009) and the LCP
+     * array with Kasai et al.'s (2001) algorithm, both in time linear in the
+     * length of the string. Both are flat arrays of 32-bit integers, so
+     * sweeping over them is far friendlier to the cache than walking a
+     * pointer-based suffix tree.
+     */
+    class SuffixArray {
+    private:
+        /**
+         * @brief The UTF32-encoded Unicode string on which this suffix array
+         *   is based.
+         */
+        UnicodeString uni_str;
+        /**
+         * @brief The starting indices (0-based) of the string's suffixes, in
+         *   ascending lexicographical order of the suffixes.
+         */
+        std::vector<std::int32_t> suffixes;
+        /**
+         * @brief Per rank, the length of the longest common prefix of the
+         *   suffixes at that rank and at the rank before it. Zero at rank zero.
+         */
+        std::vector<std::int32_t> lcp;
+    public:
+        explicit SuffixArray(const std::string &str);
+        explicit SuffixArray(UnicodeString uni_str);
+        void construct();
+        [[nodiscard]] UnicodeStringView get_uni_str() const;
+        [[nodiscard]] const std::vector<std::int32_t> &get_suffixes() const;
+        [[nodiscard]] const std::vector<std::int32_t> &get_lcp() const;
+        [[nodiscard]] std::int32_t suffix_at(int rank) const;
+        [[nodiscard]] std::int32_t lcp_at(int rank) const;
+        [[nodiscard]] int number_of_suffixes() const;
+    };
+
+    std::int32_t ranked_symbols(UnicodeStringView uni_str,
+                                std::vector<utf8::uint32_t> &alphabet,
+                                std::vector<std::int32_t> &text);
+    void sa_is_suffix_array(const std::vector<std::int32_t> &text,
+                            std::int32_t max_symbol,
+                            std::vector<std::int32_t> &suffixes);
+    void kasai_lcp_array(const std::vector<std::int32_t> &text,
+                         const std::vector<std::int32_t> &suffixes,
+                         std::vector<std::int32_t> &ranks,
+                         std::vector<std::int32_t> &lcp);
+}
+
+#endif  /* SUFFIX_ARRAY_HPP */
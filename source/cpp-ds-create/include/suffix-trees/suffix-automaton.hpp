@@ -0,0 +1,79 @@
+/* Symbols for constructing suffix automata (header). */
+
+#ifndef SUFFIX_AUTOMATON_HPP
+#define SUFFIX_AUTOMATON_HPP
+
+#include <map>
+#include <vector>
+#include <string>
+#include <optional>
+#include "utf8.h"
+#include "suffix-trees/unicode-string.hpp"
+
+namespace DutchKBQADSCreate::SuffixTrees {
+    /**
+     * @brief A single state of a suffix automaton.
+     *
+     * Each state represents a class of substrings that share the same set of
+     * ending positions within the automaton's string (Blumer et al., 1985).
+     */
+    struct SuffixAutomatonState {
+        /**
+         * @brief The length of the longest substring this state represents.
+         */
+        int length;
+        /**
+         * @brief The state representing the longest suffix of this state's
+         *   substrings that belongs to another state. The initial state has
+         *   no suffix link; it stores `-1` instead.
+         */
+        int suffix_link;
+        std::map<utf8::uint32_t, int> transitions;
+    };
+
+    /**
+     * @brief The result of matching a string against a suffix automaton: the
+     *   longest common substring between said string and the automaton's
+     *   string.
+     */
+    struct CommonSubstringMatch {
+        /**
+         * @brief The length of the longest common substring, in code points.
+         */
+        int length;
+        /**
+         * @brief The index (0-based, inclusive) of the last code point of the
+         *   longest common substring within the matched string. Meaningless if
+         *   `length` is zero.
+         */
+        int end_index;
+    };
+
+    /**
+     * @brief A suffix automaton (Blumer et al., 1985): the smallest
+     *   deterministic automaton accepting all suffixes of some string.
+     *
+     * A suffix automaton is built once, in time linear in the length of its
+     * string. It can then be matched against any number of other strings to
+     * find their longest common substring with the automaton's string, each
+     * time in time linear in the length of the other string. No separator
+     * symbols are needed, so strings may contain any code point.
+     */
+    class SuffixAutomaton {
+    private:
+        std::vector<SuffixAutomatonState> states;
+        /**
+         * @brief The state representing the complete string added so far.
+         */
+        int last;
+        void extend(utf8::uint32_t code_point);
+    public:
+        explicit SuffixAutomaton(const std::string &str);
+        explicit SuffixAutomaton(UnicodeStringView uni_str);
+        [[nodiscard]] CommonSubstringMatch longest_common_substring_match(UnicodeStringView other) const;
+        [[nodiscard]] std::optional<std::string> longest_common_substring(const std::string &other) const;
+        [[nodiscard]] int number_of_states() const;
+    };
+}
+
+#endif  /* SUFFIX_AUTOMATON_HPP */
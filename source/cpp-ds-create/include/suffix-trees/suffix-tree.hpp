@@ -52,7 +52,7 @@ namespace DutchKBQADSCreate::SuffixTrees {
          */
         int right_ptr;
         explicit ReferencePair(ExplicitState *state, explicit_left_right_pointer_pair pair);
-        canon_reference_pair canonised(UnicodeString uni_str);
+        canon_reference_pair canonised(UnicodeStringView uni_str);
     };
 
     /**
@@ -87,9 +87,11 @@ namespace DutchKBQADSCreate::SuffixTrees {
          */
         ExplicitState *root;
         explicit SuffixTree(const std::string &str);
+        explicit SuffixTree(UnicodeString uni_str);
         std::pair<bool, ExplicitState*> test_and_split(ReferencePair pair, utf8::uint32_t code_point);
         canon_reference_pair update(ReferencePair pair);
         void construct();
+        [[nodiscard]] UnicodeStringView get_uni_str() const;
         void print();
     };
 }
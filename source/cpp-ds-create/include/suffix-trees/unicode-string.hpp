@@ -8,12 +8,40 @@
 #include <optional>
 #include "utf8.h"
 
+/* Forward-declare the class `UnicodeString` for use in `UnicodeStringView`. */
 namespace DutchKBQADSCreate::SuffixTrees {
+    class UnicodeString;
+}
+
+namespace DutchKBQADSCreate::SuffixTrees {
+    /**
+     * @brief A non-owning, read-only view into (a part of) the code points of
+     *   a UTF32-encoded Unicode string.
+     *
+     * Views are cheap to copy: they consist of a pointer and a length only.
+     * Like `std::string_view`, a view must not outlive the string it views.
+     */
+    class UnicodeStringView {
+    private:
+        const utf8::uint32_t *cp;  /* The first viewed UTF32-encoded code point. */
+    public:
+        int length;
+        UnicodeStringView(const utf8::uint32_t *code_points, int length);
+        UnicodeStringView(const UnicodeString &uni_str);  /* NOLINT: implicit on purpose. */
+        [[nodiscard]] UnicodeStringView substring(int start_index, int end_index) const;
+        [[nodiscard]] utf8::uint32_t code_point_at(int index) const;
+        [[nodiscard]] std::optional<int> index_of_code_point(utf8::uint32_t code_point) const;
+        [[nodiscard]] const utf8::uint32_t *begin() const;
+        [[nodiscard]] const utf8::uint32_t *end() const;
+    };
+
     /**
      * @brief A convenience class for working with UTF32-encoded Unicode
      *   strings.
      *
-     * This class is by no means meant to be performant.
+     * Functions that only read a Unicode string should accept a
+     * `UnicodeStringView` instead, to which a `UnicodeString` implicitly
+     * converts without copying its code points.
      */
     class UnicodeString {
     private:
@@ -21,15 +49,20 @@ namespace DutchKBQADSCreate::SuffixTrees {
         void ensure_unicode_string_is_within_length_limit();
     public:
         int length;
-        explicit UnicodeString(std::string str);
+        explicit UnicodeString(const std::string &str);
         explicit UnicodeString(const std::vector<utf8::uint32_t>& code_points);
-        UnicodeString substring(int start_index, int end_index);
-        utf8::uint32_t code_point_at(int index);
-        std::optional<int> index_of_code_point(utf8::uint32_t code_point);
-        static std::basic_string<char> basic_string_from_unicode_string(UnicodeString uni_str);
+        explicit UnicodeString(UnicodeStringView view);
+        void append(utf8::uint32_t code_point);
+        void append(UnicodeStringView other);
+        [[nodiscard]] UnicodeStringView substring(int start_index, int end_index) const;
+        [[nodiscard]] utf8::uint32_t code_point_at(int index) const;
+        [[nodiscard]] std::optional<int> index_of_code_point(utf8::uint32_t code_point) const;
+        [[nodiscard]] const utf8::uint32_t *data() const;
+        static void append_utf8_decoded(const std::string &str, std::vector<utf8::uint32_t> &code_points);
+        static std::basic_string<char> basic_string_from_unicode_string(UnicodeStringView uni_str);
         static std::basic_string<char> basic_string_from_unicode_code_point(utf8::uint32_t code_point);
-        std::set<utf8::uint32_t> unique_code_points();
+        [[nodiscard]] std::set<utf8::uint32_t> unique_code_points() const;
     };
 }
 
-#endif  /* UNICODE_STRING_HPP */
\ No newline at end of file
+#endif  /* UNICODE_STRING_HPP */
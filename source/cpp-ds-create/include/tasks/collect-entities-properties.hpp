@@ -7,16 +7,23 @@
 #include <map>
 #include <boost/program_options.hpp>
 #include "utilities.hpp"
+#include "wikidata/symbol-ids.hpp"
 
 namespace DutchKBQADSCreate {
-    using q_ent_prp_map = std::map<int, std::set<std::string>>;
+    /**
+     * @brief A mapping from question UIDs to the entities and properties
+     *   referred to in their SPARQL answers, stored as packed identifiers in
+     *   ascending order.
+     */
+    using q_ent_prp_map = std::map<int, std::vector<WikiData::symbol_id>>;
     namespace po = boost::program_options;
 
-    DutchKBQADSCreate::q_ent_prp_map question_entities_properties_map(const Json::Value &ds_split);
+    DutchKBQADSCreate::q_ent_prp_map question_entities_properties_map(DutchKBQADSCreate::JsonRecordReader &ds_split);
     void save_question_entities_properties_map(const DutchKBQADSCreate::q_ent_prp_map &m,
                                                const LCQuADSplit &split);
     Json::Value loaded_json_question_entities_properties_map(const LCQuADSplit &split);
-    DutchKBQADSCreate::q_ent_prp_map loaded_question_entities_properties_map(const LCQuADSplit &split);
+    DutchKBQADSCreate::q_ent_prp_map loaded_question_entities_properties_map(const LCQuADSplit &split,
+                                                                           bool use_binary_cache = false);
     void generate_question_entities_properties_map(const po::variables_map &vm);
 }
 
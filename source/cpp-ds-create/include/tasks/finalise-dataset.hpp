@@ -0,0 +1,39 @@
+/* Symbols for finalising masked question-answer pairs into columnar files for model training (header). */
+
+#ifndef FINALISE_DATASET_HPP
+#define FINALISE_DATASET_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+#include "caching/binary-sidecar.hpp"
+#include "tasks/mask-question-answer-pairs.hpp"
+#include "utilities.hpp"
+
+namespace DutchKBQADSCreate {
+    namespace po = boost::program_options;
+
+    /**
+     * @brief The directory in which the finalised datasets are saved: those
+     *   that models are trained, validated and tested with.
+     */
+    const DutchKBQADSCreate::fs::path finalised_dataset_dir = DutchKBQADSCreate::dataset_dir / "finalised";
+
+    std::string post_processed_question(const std::string &question);
+    std::string post_processed_answer(const std::string &answer);
+    std::string finalised_partition_file_name(const std::string &partition, const NaturalLanguage &language);
+    void save_finalised_partition(const std::vector<QuestionAnswerPair> &finalised_pairs,
+                                  std::size_t begin,
+                                  std::size_t end,
+                                  const std::string &partition,
+                                  const NaturalLanguage &language,
+                                  const Caching::SourceFingerprint &source);
+    void finalise_question_answer_pairs(const std::vector<QuestionAnswerPair> &masked_pairs,
+                                        const LCQuADSplit &split,
+                                        const NaturalLanguage &language,
+                                        double fraction_to_validate);
+    void finalise_dataset(const po::variables_map &vm);
+}
+
+#endif  /* FINALISE_DATASET_HPP */
@@ -3,33 +3,158 @@
 #ifndef LABEL_ENTITIES_PROPERTIES_HPP
 #define LABEL_ENTITIES_PROPERTIES_HPP
 
+#include <cstdint>
+#include <memory>
 #include <set>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include <json/json.h>
 #include <boost/program_options.hpp>
+#include "caching/binary-sidecar.hpp"
+#include "caching/label-cache.hpp"
 #include "utilities.hpp"
+#include "wikidata/symbol-ids.hpp"
+
+/* Forward-declare the class `LabelStore` for use in `LabelList`. */
+namespace DutchKBQADSCreate {
+    class LabelStore;
+}
 
 namespace DutchKBQADSCreate {
     namespace po = boost::program_options;
-    using ent_prp_partitioning = std::vector<std::set<std::string>>;
-    using ent_prp_label_map = std::map<std::string, std::vector<std::string>>;
+    using ent_prp_partitioning = std::vector<std::vector<WikiData::symbol_id>>;
+
+    /**
+     * @brief The location of a single label within the string pool of a
+     *   `LabelStore`.
+     */
+    struct LabelSpan {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
 
-    std::set<std::string> unique_entities_and_properties_of_split(const LCQuADSplit &split);
+    /**
+     * @brief A non-owning view of the labels of a single entity or property,
+     *   in the order in which they were stored. It must not outlive the
+     *   `LabelStore` it views into.
+     */
+    class LabelList {
+    private:
+        const LabelStore *store;
+        std::uint32_t first_span;
+        std::uint32_t span_count;
+    public:
+        LabelList(const LabelStore *store, std::uint32_t first_span, std::uint32_t span_count);
+        [[nodiscard]] std::size_t size() const;
+        [[nodiscard]] bool empty() const;
+        [[nodiscard]] std::string_view operator[](std::size_t idx) const;
+    };
+
+    /**
+     * @brief The labels of many entities and properties, stored in a single
+     *   contiguous string pool.
+     *
+     * Each entity or property refers to a run of consecutive `LabelSpan`s;
+     * each span refers to a label in the pool. There are no allocations per
+     * label. Entities and properties are looked up by binary search.
+     */
+    class LabelStore {
+    private:
+        /**
+         * @brief The run of labels of one entity or property.
+         */
+        struct Entry {
+            WikiData::symbol_id id;
+            std::uint32_t first_span;
+            std::uint32_t span_count;
+        };
+        std::string pool;
+        std::vector<LabelSpan> spans;
+        /**
+         * @brief The entries of all stored entities and properties, sorted by
+         *   their identifiers once `seal` has been called.
+         */
+        std::vector<Entry> entries;
+        bool sealed;
+        friend class LabelList;
+    public:
+        LabelStore();
+        void add(WikiData::symbol_id id, const std::vector<std::string> &labels);
+        void seal();
+        [[nodiscard]] bool contains(WikiData::symbol_id id) const;
+        [[nodiscard]] LabelList labels(WikiData::symbol_id id) const;
+        [[nodiscard]] std::size_t number_of_symbols() const;
+        [[nodiscard]] WikiData::symbol_id symbol(std::size_t idx) const;
+        [[nodiscard]] LabelList labels_at(std::size_t idx) const;
+        [[nodiscard]] std::size_t number_of_labels() const;
+        void write_to(Caching::SidecarWriter &sidecar) const;
+        static LabelStore read_from(Caching::SidecarReader &sidecar);
+    };
+
+    /**
+     * @brief A non-owning view of the labels of some of the entities and
+     *   properties of a `LabelStore`. Labels are looked up in the store only
+     *   when accessed, so that constructing a subset allocates nothing. It
+     *   must outlive neither the store nor the entities and properties it was
+     *   constructed from.
+     */
+    class LabelSubset {
+    private:
+        const WikiData::symbol_id *ent_prp_ids;
+        std::size_t ent_prp_count;
+        const LabelStore *store;
+    public:
+        LabelSubset(const std::vector<WikiData::symbol_id> &ent_prp_ids, const LabelStore &store);
+        [[nodiscard]] std::size_t size() const;
+        [[nodiscard]] bool empty() const;
+        [[nodiscard]] WikiData::symbol_id symbol(std::size_t idx) const;
+        [[nodiscard]] LabelList labels_at(std::size_t idx) const;
+    };
+
+    std::vector<WikiData::symbol_id> unique_entities_and_properties_of_split(const LCQuADSplit &split);
+    std::string entity_and_property_labels_relative_path(const LCQuADSplit &split,
+                                                         const NaturalLanguage &language,
+                                                         const Shard &shard = whole_shard);
     void save_entity_and_property_labels(const Json::Value &json,
                                          const LCQuADSplit &split,
-                                         const NaturalLanguage &language);
+                                         const NaturalLanguage &language,
+                                         const Shard &shard = whole_shard);
     Json::Value loaded_json_entity_and_property_labels(const LCQuADSplit &split,
-                                                       const NaturalLanguage &language);
-    DutchKBQADSCreate::ent_prp_label_map loaded_entity_and_property_labels(const LCQuADSplit &split,
-                                                                           const NaturalLanguage &language);
-    DutchKBQADSCreate::ent_prp_label_map entity_and_property_labels_subset(
-        const std::set<std::string> &ent_prp_set,
-        const DutchKBQADSCreate::ent_prp_label_map &all
+                                                       const NaturalLanguage &language,
+                                                       const Shard &shard = whole_shard);
+    void compact_entity_and_property_labels(const LCQuADSplit &split,
+                                            const NaturalLanguage &language,
+                                            const Shard &shard = whole_shard);
+    void compact_entity_and_property_labels(const Json::Value &json,
+                                            const LCQuADSplit &split,
+                                            const NaturalLanguage &language,
+                                            const Shard &shard = whole_shard);
+    DutchKBQADSCreate::LabelStore label_store_from_json(const Json::Value &json);
+    DutchKBQADSCreate::LabelStore loaded_entity_and_property_labels(const LCQuADSplit &split,
+                                                                    const NaturalLanguage &language,
+                                                                    bool use_binary_cache = false);
+    DutchKBQADSCreate::LabelSubset entity_and_property_labels_subset(
+        const std::vector<WikiData::symbol_id> &ent_prp_ids,
+        const DutchKBQADSCreate::LabelStore &all
+    );
+    std::vector<WikiData::symbol_id> entities_and_properties_requiring_labeling(const LCQuADSplit &split,
+                                                                                const NaturalLanguage &language);
+    std::vector<WikiData::symbol_id> entities_and_properties_requiring_labeling(
+        const std::vector<WikiData::symbol_id> &ent_prp_total,
+        const Json::Value &current_json
     );
-    std::set<std::string> entities_and_properties_requiring_labeling(const LCQuADSplit &split,
-                                                                     const NaturalLanguage &language);
-    DutchKBQADSCreate::ent_prp_partitioning entity_property_partitioning(const std::set<std::string> &ent_prp_set,
-                                                                         int part_size);
+    Json::Value labelled_entities_and_properties(const std::vector<WikiData::symbol_id> &ent_prp_total,
+                                                 const LCQuADSplit &split,
+                                                 const NaturalLanguage &language,
+                                                 int part_size,
+                                                 int in_flight,
+                                                 bool quiet,
+                                                 Caching::LabelResponseCache *label_cache = nullptr,
+                                                 const Shard &shard = whole_shard);
+    std::unique_ptr<Caching::LabelResponseCache> opened_label_cache(const DutchKBQADSCreate::po::variables_map &vm);
     void label_entities_and_properties(const DutchKBQADSCreate::po::variables_map &vm);
+    void compact_entity_and_property_labels(const DutchKBQADSCreate::po::variables_map &vm);
 }
 
 #endif  /* LABEL_ENTITIES_PROPERTIES_HPP */
@@ -4,11 +4,15 @@
 #define MASK_QUESTION_ANSWER_PAIRS_HPP
 
 #include <boost/program_options.hpp>
+#include <cstdint>
 #include <map>
 #include <optional>
+#include <string_view>
 #include "tasks/collect-entities-properties.hpp"
 #include "tasks/label-entities-properties.hpp"
 #include "suffix-trees/longest-common-substring.hpp"
+#include "string-matching/aho-corasick.hpp"
+#include "string-matching/approximate-matcher.hpp"
 #include "utilities.hpp"
 
 /* Forward-declare the `LabelMatch` structure for usage in type definitions. */
@@ -23,7 +27,7 @@ namespace DutchKBQADSCreate {
      *   no label could be matched (see `selected_label_for_entity_or_property`
      *   below), a null value is stored instead.
      */
-    using ent_or_prp_chosen_label = std::optional<std::pair<std::string, LabelMatch>>;
+    using ent_or_prp_chosen_label = std::optional<std::pair<WikiData::symbol_id, LabelMatch>>;
     /**
      * @brief A mapping from entities and properties to associated (substrings
      *   of) labels. If null is stored, this indicates that one or more
@@ -31,12 +35,12 @@ namespace DutchKBQADSCreate {
      *   to an appropriate label. For situations in which this happens, see
      *   the function `selected_label_for_entity_or_property`.
      */
-    using ent_prp_chosen_label_map = std::optional<std::map<std::string, LabelMatch>>;
+    using ent_prp_chosen_label_map = std::optional<std::map<WikiData::symbol_id, LabelMatch>>;
     /**
      * @brief A mapping from entities and properties to masks for them within
      *   a to-be-masked question-answer pair.
      */
-    using ent_prp_mask_map = std::map<std::string, std::string>;
+    using ent_prp_mask_map = std::map<WikiData::symbol_id, std::string>;
 
     /**
      * @brief An LC-QuAD 2.0 question-answer pair. The question's natural
@@ -68,60 +72,155 @@ namespace DutchKBQADSCreate {
         /**
          * @brief The entity or property to which this label belongs to.
          */
-        std::string ent_or_prp;
+        WikiData::symbol_id ent_or_prp;
         /**
          * @brief The original, complete label, including portions that have
-         *   been removed in finding the longest common substring.
+         *   been removed in finding the longest common substring. Views into
+         *   the `LabelIndex` (or other owner) the label was obtained from.
          */
-        std::string label;
+        std::string_view label;
         /**
          * @brief The index boundaries of this label match within the question.
          */
         index_range match_bounds;
+        /**
+         * @brief Whether the label occurs at `match_bounds` only approximately,
+         *   rather than exactly.
+         */
+        bool is_approximate = false;
 
-        LabelMatch(const std::string &label,
+        LabelMatch(std::string_view label,
                    const index_range &match_bounds,
-                   const std::string &ent_or_prp);
-        static std::optional<index_range> match_label_in_sentence(const std::string &label,
-                                                                  const std::string &sentence);
+                   WikiData::symbol_id ent_or_prp);
         static bool appears_earlier_in_string(const LabelMatch &first, const LabelMatch &second);
         static std::optional<LabelMatch> best_label_match(const std::vector<LabelMatch> &matches);
         static void sorted_label_matches(std::vector<LabelMatch> &matches);
         static bool collision_present_in_label_matches(std::vector<LabelMatch> matches);
     };
 
+    /**
+     * @brief An index over the labels of all entities and properties, with
+     *   which every label occurrence in a question can be found using a single
+     *   pass over said question.
+     *
+     * The index is built once, and can then be shared (read-only) by all
+     * questions of a dataset split.
+     */
+    class LabelIndex {
+    private:
+        /**
+         * @brief An automaton having every unique, non-empty label as a
+         *   pattern.
+         */
+        StringMatching::AhoCorasickAutomaton automaton;
+        /**
+         * @brief The indexed entities and properties, in ascending order.
+         */
+        std::vector<WikiData::symbol_id> symbols;
+        /**
+         * @brief For each entity and property in `symbols`, the index of its
+         *   first pattern ID in `label_pattern_ids`, followed by the total
+         *   number of pattern IDs.
+         */
+        std::vector<std::uint32_t> first_label_pattern;
+        /**
+         * @brief For each entity and property, the pattern IDs of its labels,
+         *   in the same order as the labels themselves. Empty labels are
+         *   stored as `StringMatching::no_automaton_entry`.
+         */
+        std::vector<int> label_pattern_ids;
+    public:
+        explicit LabelIndex(const LabelStore &ent_prp_labels);
+        [[nodiscard]] StringMatching::first_pattern_matches label_occurrences_in_sentence(
+            const std::string &sentence
+        ) const;
+        [[nodiscard]] std::vector<LabelMatch> label_matches_for_entity_or_property(
+            WikiData::symbol_id ent_or_prp,
+            const StringMatching::first_pattern_matches &occurrences
+        ) const;
+        [[nodiscard]] std::optional<LabelMatch> first_label_match_for_entity_or_property(
+            WikiData::symbol_id ent_or_prp,
+            const StringMatching::first_pattern_matches &occurrences
+        ) const;
+        [[nodiscard]] std::optional<LabelMatch> approximate_label_match_for_entity_or_property(
+            WikiData::symbol_id ent_or_prp,
+            const StringMatching::ApproximateMatcher &matcher,
+            int max_edit_distance
+        ) const;
+    };
+
     std::vector<DutchKBQADSCreate::QuestionAnswerPair> question_answer_pairs(const LCQuADSplit &split,
                                                                              const NaturalLanguage &language);
     DutchKBQADSCreate::ent_or_prp_chosen_label selected_label_for_entity_or_property(
-        const std::string &question,
-        const std::string &ent_or_prp,
-        const std::vector<std::string> &labels,
+        WikiData::symbol_id ent_or_prp,
+        const LabelIndex &label_index,
+        const StringMatching::first_pattern_matches &occurrences,
         const ent_prp_chosen_label_map &map
     );
     DutchKBQADSCreate::ent_prp_chosen_label_map selected_labels_for_entities_and_properties(
         const std::string &question,
-        const std::set<std::string> &entities_properties,
-        const ent_prp_label_map &ent_prp_labels
+        const std::vector<WikiData::symbol_id> &entities_properties,
+        const LabelIndex &label_index,
+        int max_edit_distance = 0
     );
-    void mask_single_entity_or_property_in_question(std::string &q,
-                                                    const LabelMatch &match,
-                                                    int &ent_counter,
-                                                    int &prp_counter,
-                                                    ent_prp_mask_map &mask_map);
-    void mask_single_entity_or_property_in_answer(std::string &a,
-                                                  const LabelMatch &match,
-                                                  ent_prp_mask_map &mask_map);
+    const std::string &mask_for_entity_or_property(WikiData::symbol_id ent_or_prp,
+                                                   int &ent_counter,
+                                                   int &prp_counter,
+                                                   ent_prp_mask_map &mask_map);
+    std::string question_with_labels_masked(const std::string &q,
+                                            const std::vector<LabelMatch> &matches,
+                                            const ent_prp_mask_map &mask_map);
+    std::string answer_with_entities_and_properties_masked(const std::string &a,
+                                                           const ent_prp_mask_map &mask_map);
     std::optional<DutchKBQADSCreate::QuestionAnswerPair> masked_question_answer_pair(
         const QuestionAnswerPair &qa_pair,
-        const std::set<std::string> &entities_properties,
-        const ent_prp_label_map &ent_prp_labels
+        const std::vector<WikiData::symbol_id> &entities_properties,
+        const LabelIndex &label_index,
+        int max_edit_distance = 0
+    );
+    std::vector<DutchKBQADSCreate::QuestionAnswerPair> masked_question_answer_pairs(const LCQuADSplit &split,
+                                                                                    const NaturalLanguage &language,
+                                                                                    bool quiet,
+                                                                                    int threads,
+                                                                                    bool use_binary_cache = true,
+                                                                                    const Shard &shard = whole_shard,
+                                                                                    int max_edit_distance = 0);
+    std::vector<DutchKBQADSCreate::QuestionAnswerPair> masked_question_answer_pairs(
+        const std::vector<DutchKBQADSCreate::QuestionAnswerPair> &qa_pairs,
+        const q_ent_prp_map &questions_entities_properties,
+        const LabelStore &ent_prp_labels,
+        bool quiet,
+        int threads,
+        int max_edit_distance = 0
+    );
+    std::vector<DutchKBQADSCreate::QuestionAnswerPair> masked_question_answer_pairs(
+        const std::vector<DutchKBQADSCreate::QuestionAnswerPair> &qa_pairs,
+        const q_ent_prp_map &questions_entities_properties,
+        const LabelIndex &label_index,
+        bool quiet,
+        int threads,
+        int max_edit_distance = 0
     );
-    Json::Value masked_question_answer_pairs(const LCQuADSplit &split,
-                                             const NaturalLanguage &language,
-                                             bool quiet);
-    void save_masked_question_answer_pairs_json(const Json::Value &json,
-                                                const LCQuADSplit &split,
-                                                const NaturalLanguage &language);
+    std::string masked_question_answer_pairs_file_name(const LCQuADSplit &split,
+                                                       const NaturalLanguage &language,
+                                                       const Shard &shard = whole_shard);
+    std::vector<std::size_t> indices_in_uid_string_order(const std::vector<QuestionAnswerPair> &qa_pairs);
+    void save_masked_question_answer_pairs(const std::vector<DutchKBQADSCreate::QuestionAnswerPair> &masked_pairs,
+                                           const LCQuADSplit &split,
+                                           const NaturalLanguage &language,
+                                           const Shard &shard = whole_shard);
+    std::uint64_t masking_input_hash(const QuestionAnswerPair &qa_pair,
+                                     const std::vector<WikiData::symbol_id> &entities_properties,
+                                     const LabelStore &ent_prp_labels,
+                                     int max_edit_distance = 0);
+    std::size_t update_masked_question_answer_pairs(const LCQuADSplit &split,
+                                                    const NaturalLanguage &language,
+                                                    bool quiet,
+                                                    int threads,
+                                                    bool use_binary_cache = true,
+                                                    bool incremental = true,
+                                                    const Shard &shard = whole_shard,
+                                                    int max_edit_distance = 0);
     void mask_question_answer_pairs(const po::variables_map &vm);
 }
 
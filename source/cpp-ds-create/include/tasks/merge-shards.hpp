@@ -0,0 +1,27 @@
+/* Symbols for merging the output of sharded tasks (header). */
+
+#ifndef MERGE_SHARDS_HPP
+#define MERGE_SHARDS_HPP
+
+#include <boost/program_options.hpp>
+#include "utilities.hpp"
+
+namespace DutchKBQADSCreate {
+    namespace po = boost::program_options;
+
+    bool entity_and_property_label_shard_exists(const LCQuADSplit &split,
+                                                const NaturalLanguage &language,
+                                                const Shard &shard);
+    bool masked_question_answer_pair_shard_exists(const LCQuADSplit &split,
+                                                  const NaturalLanguage &language,
+                                                  const Shard &shard);
+    void merge_entity_and_property_label_shards(const LCQuADSplit &split,
+                                                const NaturalLanguage &language,
+                                                int shard_count);
+    void merge_masked_question_answer_pair_shards(const LCQuADSplit &split,
+                                                  const NaturalLanguage &language,
+                                                  int shard_count);
+    void merge_shards(const po::variables_map &vm);
+}
+
+#endif  /* MERGE_SHARDS_HPP */
@@ -4,11 +4,38 @@
 #define REPLACE_SPECIAL_SYMBOLS_HPP
 
 #include <json/json.h>
+#include <map>
+#include <string>
 #include <vector>
 #include <boost/program_options.hpp>
+#include "string-matching/aho-corasick.hpp"
 
 namespace DutchKBQADSCreate {
     namespace po = boost::program_options;
+
+    /**
+     * @brief Replaces symbols in strings, and optionally decodes HTML
+     *   entities, in a single left-to-right pass per string.
+     *
+     * All symbols are compiled into one Aho-Corasick automaton up-front, so
+     * that the work per string is linear in its length plus its number of
+     * symbol occurrences. A compiled replacer may be shared between threads.
+     */
+    class SymbolReplacer {
+    private:
+        StringMatching::AhoCorasickAutomaton automaton;
+        /**
+         * @brief The replacements of the automaton's patterns, indexed by
+         *   pattern ID.
+         */
+        std::vector<std::string> replacements;
+        bool replace_html_entities;
+        static std::size_t decoded_numeric_entity(const std::string &str, std::size_t idx, std::string &output);
+    public:
+        SymbolReplacer(const std::map<std::string, std::string> &replace_map, bool replace_html_entities);
+        [[nodiscard]] std::string replaced(const std::string &str) const;
+    };
+
     Json::Value json_with_symbols_replaced(Json::Value json,
                                            const std::map<std::string, std::string>& replace_map);
     Json::Value json_with_html_entities_replaced(Json::Value json);
@@ -0,0 +1,27 @@
+/* Symbols for running the dataset-creating tasks as a single in-process pipeline (header). */
+
+#ifndef RUN_PIPELINE_HPP
+#define RUN_PIPELINE_HPP
+
+#include <boost/program_options.hpp>
+#include "caching/label-cache.hpp"
+#include "utilities.hpp"
+
+namespace DutchKBQADSCreate {
+    namespace po = boost::program_options;
+
+    void run_pipeline(const LCQuADSplit &split,
+                      const NaturalLanguage &language,
+                      int part_size,
+                      int in_flight,
+                      int threads,
+                      bool checkpoints,
+                      bool quiet,
+                      Caching::LabelResponseCache *label_cache = nullptr,
+                      int max_edit_distance = 0,
+                      bool finalise = false,
+                      double fraction_to_validate = 0.);
+    void run_pipeline(const po::variables_map &vm);
+}
+
+#endif  /* RUN_PIPELINE_HPP */
@@ -0,0 +1,116 @@
+/* Symbols for tracing where the tasks spend their time and memory (header). */
+
+#ifndef TRACER_HPP
+#define TRACER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "utilities.hpp"
+
+namespace DutchKBQADSCreate::Tracing {
+    using tracing_clock = std::chrono::steady_clock;
+
+    /**
+     * @brief A named, monotonically increasing count of events, such as
+     *   question-answer pairs masked or bytes written.
+     *
+     * Counters are obtained once through `counter`, after which incrementing
+     * them is a single relaxed atomic addition, so that they can be
+     * incremented from hot loops and from several threads at once.
+     */
+    class Counter {
+    private:
+        std::atomic<std::int64_t> count;
+    public:
+        Counter();
+        void add(std::int64_t amount = 1);
+        [[nodiscard]] std::int64_t value() const;
+    };
+
+    /**
+     * @brief A completed run of a stage of a task.
+     */
+    struct StageRun {
+        std::string name;
+        /**
+         * @brief When the run started, in microseconds since tracing started.
+         */
+        std::int64_t start;
+        /**
+         * @brief The wall time of the run, in microseconds.
+         */
+        std::int64_t duration;
+        /**
+         * @brief The index of the thread that performed the run. 0-based, in
+         *   the order in which threads first completed a stage.
+         */
+        int thread;
+        /**
+         * @brief The peak resident set size of the process when the run
+         *   completed, in bytes.
+         */
+        std::int64_t peak_rss;
+    };
+
+    /**
+     * @brief A collector of stage runs and counters, which writes them out as
+     *   a Chrome trace file (which Perfetto can open as well) and as a summary.
+     *
+     * Counting always takes place; stage runs are only collected once tracing
+     * is enabled, so that untraced runs do not accumulate them.
+     */
+    class Tracer {
+    private:
+        std::atomic<bool> enabled;
+        tracing_clock::time_point origin;
+        mutable std::mutex mutex;
+        std::vector<StageRun> runs;
+        /**
+         * @brief All counters obtained so far, keyed by name. The counters
+         *   are never moved, so references to them stay valid.
+         */
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+    public:
+        Tracer();
+        void enable();
+        [[nodiscard]] bool is_enabled() const;
+        [[nodiscard]] std::int64_t microseconds_since_origin(tracing_clock::time_point time) const;
+        Counter &counter(const std::string &name);
+        void record(StageRun run);
+        [[nodiscard]] std::map<std::string, std::int64_t> counter_values() const;
+        void write_chrome_trace(const fs::path &path) const;
+        void write_summary(std::ostream &out) const;
+    };
+
+    /**
+     * @brief A stage of a task, which is traced from its construction up
+     *   until its destruction.
+     *
+     * Stages may be nested, and may be run by several threads at once. If
+     * tracing is disabled, a stage costs a single check.
+     */
+    class Stage {
+    private:
+        std::string name;
+        tracing_clock::time_point start;
+        bool traced;
+    public:
+        explicit Stage(std::string name);
+        Stage(const Stage &) = delete;
+        Stage &operator=(const Stage &) = delete;
+        ~Stage();
+    };
+
+    Tracer &tracer();
+    Counter &counter(const std::string &name);
+    std::int64_t peak_resident_set_size();
+}
+
+#endif  /* TRACER_HPP */
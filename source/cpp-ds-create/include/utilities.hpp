@@ -6,10 +6,17 @@
 #include <unordered_map>
 #include <string>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
 #include <set>
+#include <vector>
 #include <json/json.h>
+#include <boost/program_options.hpp>
 
 namespace DutchKBQADSCreate {
+    namespace po = boost::program_options;
+
     /**
      * @brief An index range. The first entry in this pair is the starting
      *   index; the second entry is the ending index. Both ends are inclusive.
@@ -64,7 +71,6 @@ namespace DutchKBQADSCreate {
         ENTITY,
         PROPERTY
     };
-    WikiDataSymbol wiki_data_symbol_for_entity_or_property(const std::string &ent_or_prp);
 
     /**
      * @brief The root directory of the project that this C++ dataset
@@ -87,15 +93,107 @@ namespace DutchKBQADSCreate {
      */
     const DutchKBQADSCreate::fs::path supplements_dir = DutchKBQADSCreate::dataset_dir / "supplements";
 
+    /**
+     * @brief One of `count` disjoint parts ('shards') of a task's work, so that
+     *   the work can be spread over several processes or machines.
+     *
+     * A shard covers a contiguous range of the work's items, so concatenating
+     * the output of all shards in order of their indices yields the output of
+     * the whole task. Output files of a shard carry a suffix to tell them apart;
+     * the single shard of unsharded work has none.
+     */
+    struct Shard {
+        /**
+         * @brief The index of this shard. 0-based.
+         */
+        int index;
+        int count;
+
+        Shard(int index, int count);
+        [[nodiscard]] bool is_whole() const;
+        [[nodiscard]] std::pair<std::size_t, std::size_t> bounds(std::size_t total) const;
+        [[nodiscard]] std::string file_name_suffix() const;
+    };
+    /**
+     * @brief The single shard of work that is not sharded.
+     */
+    const DutchKBQADSCreate::Shard whole_shard = DutchKBQADSCreate::Shard(0, 1);
+    DutchKBQADSCreate::Shard requested_shard(const po::variables_map &vm);
+
     bool dataset_file_exists(const fs::path &file);
     void create_directory_if_absent(const DutchKBQADSCreate::fs::path &dir_path);
     Json::Value json_loaded_from_dataset_file(const std::string &file_name);
     void save_json_to_dataset_file(const Json::Value &json,
-                                   const std::string &file_name);
-    void append_json_to_dataset_file(const Json::Value &json,
-                                     const std::string &file_name);
+                                   const std::string &file_name,
+                                   bool pretty = false);
+    void append_json_line_to_dataset_file(const Json::Value &json,
+                                          const std::string &file_name);
+    std::vector<Json::Value> json_lines_loaded_from_dataset_file(const std::string &file_name);
+
+    /**
+     * @brief The type of the top-level JSON value of a dataset file that is
+     *   read or written record by record.
+     */
+    enum JsonContainerType {
+        JSON_ARRAY,
+        JSON_OBJECT
+    };
+
+    /**
+     * @brief A pull parser over the records of a dataset file whose top-level
+     *   value is a JSON array or object: the array's elements, or the object's
+     *   members.
+     *
+     * Only a single record is held in memory at a time, so that memory use is
+     * bounded by the largest record rather than by the size of the file. Each
+     * record is parsed into a `Json::Value` of its own.
+     */
+    class JsonRecordReader {
+    private:
+        std::string file_name;
+        std::ifstream file;
+        JsonContainerType type;
+        bool exhausted;
+        std::size_t records_read;
+        std::unique_ptr<Json::CharReader> reader;
+        int next_char_after_whitespace();
+        std::string next_value_text();
+        Json::Value parsed_value_text(const std::string &text);
+    public:
+        explicit JsonRecordReader(const std::string &file_name);
+        [[nodiscard]] JsonContainerType container_type() const;
+        bool next(std::string &key, Json::Value &record);
+        bool next(Json::Value &record);
+    };
+
+    /**
+     * @brief A writer that saves a JSON array or object to a dataset file
+     *   record by record, instead of building it in memory first.
+     *
+     * By default, records are written compactly, which suits the intermediate
+     * files of the dataset creation process.
+     */
+    class JsonRecordWriter {
+    private:
+        std::string file_name;
+        std::ofstream file;
+        JsonContainerType type;
+        bool pretty;
+        bool closed;
+        std::size_t records_written;
+        std::unique_ptr<Json::StreamWriter> writer;
+        void write_separator();
+        void write_value(const Json::Value &record);
+    public:
+        JsonRecordWriter(const std::string &file_name, JsonContainerType type, bool pretty = false);
+        JsonRecordWriter(const JsonRecordWriter &) = delete;
+        JsonRecordWriter &operator=(const JsonRecordWriter &) = delete;
+        ~JsonRecordWriter();
+        void write(const Json::Value &record);
+        void write(const std::string &key, const Json::Value &record);
+        void close();
+    };
 
-    std::string string_with_regex_characters_escaped(const std::string &non_escaped);
     std::set<std::string> string_set_from_string_vec(const std::vector<std::string> &vec);
     std::optional<index_range> index_bounds_of_substring_in_string(const std::string &str, const std::string &sub_str);
     bool substring_replacement_success(std::string &str,
@@ -0,0 +1,44 @@
+/* Symbols for adapting the size of WikiData query batches (header). */
+
+#ifndef BATCH_SIZER_HPP
+#define BATCH_SIZER_HPP
+
+#include <chrono>
+
+namespace DutchKBQADSCreate::WikiData {
+    /**
+     * @brief The latency that an `AdaptiveBatchSizer` steers towards by
+     *   default. Well below the 60-second limit of the WikiData query
+     *   service, so that slow moments do not immediately cause timeouts.
+     */
+    const std::chrono::milliseconds default_target_batch_latency { 10000 };
+
+    /**
+     * @brief Determines how many items to put in each WikiData query, based on
+     *   the latencies and failures of earlier queries.
+     *
+     * After each success, the batch size moves half-way towards the size that
+     * would have hit the target latency, assuming latency grows linearly with
+     * batch size. It at most doubles or halves per success. After each
+     * failure (a timeout or server error), the size of the failed batch is
+     * halved.
+     */
+    class AdaptiveBatchSizer {
+    private:
+        double size;
+        int min_size;
+        int max_size;
+        std::chrono::milliseconds target_latency;
+        void clamp_size();
+    public:
+        AdaptiveBatchSizer(int initial_size,
+                           int min_size,
+                           int max_size,
+                           std::chrono::milliseconds target_latency = default_target_batch_latency);
+        [[nodiscard]] int batch_size() const;
+        void register_success(int batch_size, std::chrono::milliseconds latency);
+        void register_failure(int batch_size);
+    };
+}
+
+#endif  /* BATCH_SIZER_HPP */
@@ -0,0 +1,190 @@
+/* Symbols for querying the WikiData query service concurrently (header). */
+
+#ifndef QUERY_FETCHER_HPP
+#define QUERY_FETCHER_HPP
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include <curlpp/Easy.hpp>
+#include <curlpp/Multi.hpp>
+
+namespace DutchKBQADSCreate::WikiData {
+    using fetcher_clock = std::chrono::steady_clock;
+
+    const std::string wikidata_query_service_url = "https://query.wikidata.org/";
+
+    /**
+     * @brief Settings that determine how aggressively a `QueryFetcher` queries
+     *   the WikiData query service.
+     */
+    struct FetcherSettings {
+        /**
+         * @brief The maximal number of queries to have in flight at once. The
+         *   public WikiData endpoint permits up to five per client.
+         */
+        int max_in_flight = 1;
+        /**
+         * @brief The maximal number of attempts per query, when it fails due
+         *   to transient (5xx or network) errors. `429` responses only count
+         *   as attempts once a query has received `max_throttles` of them.
+         */
+        int max_attempts = 6;
+        /**
+         * @brief The number of `429` responses a query may receive before
+         *   every further one counts as a failed attempt, so that a query that
+         *   is throttled indefinitely eventually fails.
+         */
+        int max_throttles = 20;
+        /**
+         * @brief The shortest interval between the starts of two queries.
+         */
+        std::chrono::milliseconds min_start_interval { 250 };
+        /**
+         * @brief The longest interval between the starts of two queries,
+         *   which the rate limiter backs off to under sustained throttling.
+         */
+        std::chrono::milliseconds max_start_interval { 30000 };
+        /**
+         * @brief The time to wait after a `429` response that lacks a
+         *   (numeric) `Retry-After` header.
+         */
+        std::chrono::milliseconds default_retry_after { 5000 };
+        /**
+         * @brief The wait before the first retry of a failed query. It
+         *   doubles with every further attempt, up to `max_backoff`.
+         */
+        std::chrono::milliseconds initial_backoff { 1000 };
+        std::chrono::milliseconds max_backoff { 60000 };
+        /**
+         * @brief The maximal duration of a single query, in seconds. The
+         *   WikiData query service itself aborts queries after 60 seconds.
+         */
+        long timeout_seconds = 90;
+    };
+
+    /**
+     * @brief A rate limiter that spaces query starts, and adapts the spacing
+     *   to how the server responds.
+     *
+     * Each throttling response doubles the interval between starts and, if
+     * the server sent a `Retry-After`, blocks all starts until it has passed.
+     * Each successful response shrinks the interval by a tenth again, down to
+     * the configured minimum.
+     */
+    class AdaptiveRateLimiter {
+    private:
+        std::chrono::milliseconds interval;
+        std::chrono::milliseconds min_interval;
+        std::chrono::milliseconds max_interval;
+        fetcher_clock::time_point next_start;
+    public:
+        AdaptiveRateLimiter(std::chrono::milliseconds min_interval, std::chrono::milliseconds max_interval);
+        [[nodiscard]] fetcher_clock::time_point next_permitted_start() const;
+        [[nodiscard]] std::chrono::milliseconds current_interval() const;
+        void register_start();
+        void register_success();
+        void register_throttle(std::chrono::milliseconds retry_after);
+    };
+
+    /**
+     * @brief A query waiting to be (re)started by a `QueryFetcher`.
+     */
+    struct PendingQuery {
+        std::size_t index;
+        std::string sparql;
+        /**
+         * @brief The number of failed attempts for this query so far.
+         */
+        int failed_attempts;
+        /**
+         * @brief The number of `429` responses to this query so far.
+         */
+        int throttles;
+        /**
+         * @brief The earliest moment at which this query may be started.
+         */
+        fetcher_clock::time_point not_before;
+    };
+
+    /**
+     * @brief A reusable transfer handle of a `QueryFetcher`, along with the
+     *   state of the query it currently performs.
+     */
+    struct TransferSlot {
+        std::unique_ptr<curlpp::Easy> request;
+        std::optional<PendingQuery> query;
+        std::string body;
+        /**
+         * @brief The value of the response's `Retry-After` header, if it was
+         *   present and numeric.
+         */
+        std::optional<std::chrono::seconds> retry_after;
+        fetcher_clock::time_point started;
+    };
+
+    /**
+     * @brief A callback that returns the SPARQL of a next query to perform,
+     *   which will be known as query `index`, or null if there is no further
+     *   query to perform for now. Queries are numbered in the order in which
+     *   they are produced, starting at 0.
+     */
+    using query_producer = std::function<std::optional<std::string>(std::size_t index)>;
+    /**
+     * @brief A callback that receives the response body of the query at
+     *   `index`, and the time it took to obtain it.
+     */
+    using query_response_callback = std::function<void(std::size_t index,
+                                                       const std::string &body,
+                                                       std::chrono::milliseconds latency)>;
+    /**
+     * @brief A callback that is told that the query at `index` failed
+     *   transiently, and why. It returns whether the query should be retried
+     *   (`true`) or given up on (`false`).
+     */
+    using query_failure_callback = std::function<bool(std::size_t index, const std::string &reason)>;
+
+    /**
+     * @brief Performs SPARQL queries against the WikiData query service,
+     *   several in flight at once.
+     *
+     * Queries are sent as form-encoded POST bodies, so that their size is not
+     * bounded by URL length limits. All transfers share a single
+     * `curlpp::Multi` handle, and thereby its connection cache: connections
+     * are kept alive and reused, and, where the server supports it, queries
+     * are multiplexed over HTTP/2. Transient failures are retried with
+     * exponential backoff, and throttling responses are handled by an
+     * `AdaptiveRateLimiter`.
+     */
+    class QueryFetcher {
+    private:
+        FetcherSettings settings;
+        AdaptiveRateLimiter limiter;
+        curlpp::Multi multi;
+        std::vector<TransferSlot> slots;
+        std::mt19937 jitter_engine;
+        void configure_request(TransferSlot &slot, const std::string &query);
+        void start(TransferSlot &slot, const PendingQuery &query);
+        [[nodiscard]] std::chrono::milliseconds backoff_for_attempt(int failed_attempts);
+        void retry_or_abort(std::deque<PendingQuery> &pending,
+                            const PendingQuery &query,
+                            const std::string &reason,
+                            const query_failure_callback &on_failure);
+        void wait_for_activity(std::chrono::milliseconds max_wait);
+    public:
+        explicit QueryFetcher(const FetcherSettings &settings);
+        void fetch(const query_producer &next_query,
+                   const query_response_callback &on_response,
+                   const query_failure_callback &on_failure = nullptr);
+    };
+
+    std::string url_encoded_string(const std::string &str);
+    std::optional<std::chrono::seconds> retry_after_from_header_line(const std::string &line);
+}
+
+#endif  /* QUERY_FETCHER_HPP */
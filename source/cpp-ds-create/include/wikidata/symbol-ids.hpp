@@ -0,0 +1,54 @@
+/* Symbols for representing WikiData entities and properties compactly (header). */
+
+#ifndef SYMBOL_IDS_HPP
+#define SYMBOL_IDS_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "utilities.hpp"
+
+namespace DutchKBQADSCreate::WikiData {
+    /**
+     * @brief A WikiData entity or property, packed into 32 bits: the most
+     *   significant bit is set for properties, and the remaining bits hold the
+     *   numeric part of the identifier. For example, `Q42` is `42`, and `P31`
+     *   is `0x8000001F`.
+     *
+     * Entities sort before properties, and both sort numerically.
+     */
+    using symbol_id = std::uint32_t;
+
+    /**
+     * @brief The bit that tags a `symbol_id` as a property.
+     */
+    const symbol_id property_tag = 0x80000000u;
+    /**
+     * @brief The largest numeric part that a `symbol_id` can hold.
+     */
+    const std::uint32_t max_symbol_number = property_tag - 1;
+
+    /**
+     * @brief An occurrence of an entity or property identifier within a
+     *   SPARQL query: its packed identifier, and the index range (start
+     *   inclusive, end exclusive) of its textual form, excluding the prefix.
+     */
+    struct SymbolOccurrence {
+        symbol_id id;
+        std::size_t start;
+        std::size_t end;
+    };
+
+    symbol_id symbol_id_of(WikiDataSymbol type, std::uint32_t number);
+    WikiDataSymbol symbol_type(symbol_id id);
+    std::uint32_t symbol_number(symbol_id id);
+    std::string string_from_symbol_id(symbol_id id);
+    std::optional<symbol_id> symbol_id_from_string(const std::string &ent_or_prp);
+    symbol_id parsed_symbol_id(const std::string &ent_or_prp);
+    bool textually_precedes(symbol_id first, symbol_id second);
+    std::vector<SymbolOccurrence> symbol_occurrences_in_sparql(const std::string &sparql);
+    std::vector<symbol_id> symbol_ids_in_sparql(const std::string &sparql);
+}
+
+#endif  /* SYMBOL_IDS_HPP */
@@ -0,0 +1,335 @@
+/* Symbols for caching dataset supplements in binary sidecar files. */
+
+#include <array>
+#include <cstddef>
+#include "caching/binary-sidecar.hpp"
+#include "tracing/tracer.hpp"
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace DutchKBQADSCreate;
+using namespace DutchKBQADSCreate::Caching;
+
+/**
+ * @brief The bytes with which every sidecar starts.
+ */
+const std::array<char, 8> sidecar_magic = { 'D', 'K', 'B', 'Q', 'S', 'C', 'A', 'R' };
+
+/**
+ * @brief A value whose byte representation reveals the byte order of the
+ *   machine that wrote a sidecar. Sidecars are stored in native byte order, and
+ *   are rebuilt rather than read on machines of another byte order.
+ */
+const std::uint32_t sidecar_byte_order_mark = 0x01020304;
+
+/**
+ * @brief The header of a sidecar.
+ */
+struct SidecarHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t kind;
+    std::uint32_t byte_order_mark;
+    std::uint32_t reserved;
+    SourceFingerprint source;
+};
+
+/**
+ * @brief Maps the file at `path` into memory, read-only.
+ *
+ * @param path The path of the file.
+ */
+MappedFile::MappedFile(const fs::path &path) : mapped(nullptr), mapped_size(0) {
+#if defined(_WIN32)
+    std::ifstream file(path, std::ifstream::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::string("File \"") +
+                                 path.string() +
+                                 "\" won't open!");
+    }
+    this->fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    this->mapped = this->fallback.data();
+    this->mapped_size = this->fallback.size();
+#else
+    const int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error(std::string("File \"") +
+                                 path.string() +
+                                 "\" won't open!");
+    }
+    struct stat status {};
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw std::runtime_error(std::string("Couldn't determine the size of file \"") +
+                                 path.string() +
+                                 "\"!");
+    }
+    this->mapped_size = static_cast<std::size_t>(status.st_size);
+    if (this->mapped_size > 0) {
+        void *address = mmap(nullptr, this->mapped_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED) {
+            close(descriptor);
+            throw std::runtime_error(std::string("Couldn't map file \"") +
+                                     path.string() +
+                                     "\" into memory!");
+        }
+        this->mapped = static_cast<const char *>(address);
+    }
+    close(descriptor);  /* The mapping stays valid after closing. */
+#endif
+    static Tracing::Counter &bytes_mapped = Tracing::counter("io.bytes-mapped");
+    bytes_mapped.add(static_cast<std::int64_t>(this->mapped_size));
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+    if (this->mapped != nullptr) {
+        munmap(const_cast<char *>(this->mapped), this->mapped_size);
+    }
+#endif
+}
+
+/**
+ * @brief Returns the first byte of the file.
+ *
+ * @return A pointer to the file's contents. Null if the file is empty.
+ */
+const char *MappedFile::data() const {
+    return this->mapped;
+}
+
+/**
+ * @brief Returns the size of the file in bytes.
+ *
+ * @return The size.
+ */
+std::size_t MappedFile::size() const {
+    return this->mapped_size;
+}
+
+/**
+ * @brief Returns the 64-bit FNV-1a hash of `length` bytes starting at `bytes`.
+ *
+ * @param bytes The first byte.
+ * @param length The number of bytes.
+ * @param hash The hash to continue from, so that a hash can be computed over
+ *   several separate runs of bytes.
+ * @return The hash.
+ */
+std::uint64_t DutchKBQADSCreate::Caching::fnv_1a_hash(const char *bytes, std::size_t length, std::uint64_t hash) {
+    for (std::size_t idx = 0; idx < length; idx++) {
+        hash ^= static_cast<unsigned char>(bytes[idx]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Returns the modification time of `source` as a count of the file
+ *   clock's ticks.
+ *
+ * @param source The path of the file.
+ * @return The modification time.
+ */
+std::int64_t modification_time_of(const fs::path &source) {
+    return static_cast<std::int64_t>(fs::last_write_time(source).time_since_epoch().count());
+}
+
+/**
+ * @brief Returns the fingerprint of the file `source`, including the hash of
+ *   its contents.
+ *
+ * @param source The path of the file.
+ * @return The fingerprint.
+ */
+SourceFingerprint DutchKBQADSCreate::Caching::source_fingerprint(const fs::path &source) {
+    const MappedFile file(source);
+    return { static_cast<std::uint64_t>(file.size()),
+             modification_time_of(source),
+             fnv_1a_hash(file.data(), file.size()) };
+}
+
+/**
+ * @brief Determines whether the file `source` still has the fingerprint
+ *   `fingerprint`.
+ *
+ * The hash of `source` is only computed if its size matches that of the
+ * fingerprint, but its modification time does not.
+ *
+ * @param fingerprint The fingerprint that `source` had.
+ * @param source The path of the file.
+ * @return The question's answer.
+ */
+bool DutchKBQADSCreate::Caching::fingerprint_matches(const SourceFingerprint &fingerprint, const fs::path &source) {
+    if (fingerprint.size != static_cast<std::uint64_t>(fs::file_size(source))) {
+        return false;
+    }
+    if (fingerprint.modification_time == modification_time_of(source)) {
+        return true;
+    }
+    return fingerprint.content_hash == source_fingerprint(source).content_hash;
+}
+
+/**
+ * @brief Returns the path of the sidecar of `source`: the same path, but with
+ *   a `.cache` extension.
+ *
+ * @param source The path of the source file.
+ * @return The sidecar's path.
+ */
+fs::path DutchKBQADSCreate::Caching::sidecar_path_for(const fs::path &source) {
+    fs::path sidecar = source;
+    sidecar.replace_extension(".cache");
+    return sidecar;
+}
+
+/**
+ * @brief Returns a reader over the sidecar of `source`, provided that it
+ *   exists, is of the kind `kind`, and is up-to-date with `source`.
+ *
+ * @param source The path of the source file.
+ * @param kind The kind of sidecar.
+ * @return The reader, or null if no usable sidecar exists.
+ */
+std::unique_ptr<SidecarReader> DutchKBQADSCreate::Caching::opened_sidecar(const fs::path &source, SidecarKind kind) {
+    const fs::path sidecar = sidecar_path_for(source);
+    if (!fs::exists(sidecar) || !fs::exists(source)) {
+        return nullptr;
+    }
+    auto reader = std::make_unique<SidecarReader>(sidecar);
+    if (!reader->matches(kind, source)) {
+        return nullptr;
+    }
+    return reader;
+}
+
+/**
+ * @brief Starts writing the sidecar at `path`.
+ *
+ * @param path The path of the sidecar.
+ * @param kind The kind of data the sidecar will store.
+ * @param source The fingerprint of the source file of which the sidecar will
+ *   store a copy.
+ */
+SidecarWriter::SidecarWriter(const fs::path &path, SidecarKind kind, const SourceFingerprint &source)
+        : path(path), temporary_path(fs::path(path).concat(".writing")) {
+    this->file.open(this->temporary_path, std::ofstream::trunc | std::ofstream::binary);
+    if (!this->file.is_open()) {
+        throw std::runtime_error(std::string("Sidecar file \"") +
+                                 this->temporary_path.string() +
+                                 "\" won't open!");
+    }
+    const SidecarHeader header { sidecar_magic, sidecar_version, kind, sidecar_byte_order_mark, 0, source };
+    this->write_bytes(&header, sizeof(header));
+}
+
+/**
+ * @brief Appends `length` bytes starting at `bytes` to the sidecar.
+ *
+ * @param bytes The first byte.
+ * @param length The number of bytes.
+ */
+void SidecarWriter::write_bytes(const void *bytes, std::size_t length) {
+    this->file.write(static_cast<const char *>(bytes), static_cast<std::streamsize>(length));
+}
+
+/**
+ * @brief Finishes the sidecar, and moves it into place.
+ */
+void SidecarWriter::commit() {
+    static Tracing::Counter &bytes_written = Tracing::counter("io.bytes-written");
+    const std::streamoff written = this->file.tellp();
+    if (written > 0) {
+        bytes_written.add(static_cast<std::int64_t>(written));
+    }
+    this->file.close();
+    if (this->file.fail()) {
+        throw std::runtime_error(std::string("Couldn't write sidecar file \"") +
+                                 this->temporary_path.string() +
+                                 "\"!");
+    }
+    fs::rename(this->temporary_path, this->path);
+}
+
+/**
+ * @brief Maps the sidecar at `path` for reading.
+ *
+ * @param path The path of the sidecar.
+ */
+SidecarReader::SidecarReader(const fs::path &path) : path(path), file(path), position(0) {}
+
+/**
+ * @brief Consumes `length` bytes of the sidecar, and returns the first.
+ *
+ * @param length The number of bytes.
+ * @return A pointer to the first consumed byte.
+ */
+const char *SidecarReader::next_bytes(std::size_t length) {
+    if (length > this->file.size() - this->position) {
+        throw std::runtime_error("A sidecar ends unexpectedly.");
+    }
+    const char *bytes = this->file.data() + this->position;
+    this->position += length;
+    return bytes;
+}
+
+/**
+ * @brief Reads the sidecar's header, and returns whether the sidecar is of
+ *   the kind `kind`, of the current format, and up-to-date with `source`.
+ *
+ * The hash of `source` is only computed if its size matches that recorded in
+ * the sidecar, but its modification time does not. If the hash matches, the
+ * source was merely touched or copied, and its new modification time is
+ * recorded in the sidecar, so that later runs need not hash it again.
+ *
+ * @param kind The expected kind of sidecar.
+ * @param source The path of the source file.
+ * @return The question's answer.
+ */
+bool SidecarReader::matches(SidecarKind kind, const fs::path &source) {
+    if (this->file.size() < sizeof(SidecarHeader)) {
+        return false;
+    }
+    SidecarHeader header {};
+    std::memcpy(&header, this->next_bytes(sizeof(header)), sizeof(header));
+    if (header.magic != sidecar_magic ||
+        header.version != sidecar_version ||
+        header.kind != kind ||
+        header.byte_order_mark != sidecar_byte_order_mark) {
+        return false;
+    }
+    if (!fingerprint_matches(header.source, source)) {
+        return false;
+    }
+    const std::int64_t modification_time = modification_time_of(source);
+    if (header.source.modification_time != modification_time) {
+        /* Overwrite only the modification time of the header. If the sidecar
+         * cannot be written to, the source is simply hashed again next time. */
+        std::fstream sidecar(this->path, std::fstream::in | std::fstream::out | std::fstream::binary);
+        sidecar.seekp(static_cast<std::streamoff>(offsetof(SidecarHeader, source) +
+                                                  offsetof(SourceFingerprint, modification_time)));
+        sidecar.write(reinterpret_cast<const char *>(&modification_time), sizeof(modification_time));
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the bytes of the next section as a string.
+ *
+ * @return The string.
+ */
+std::string SidecarReader::read_string_section() {
+    std::uint64_t count;
+    std::memcpy(&count, this->next_bytes(sizeof(count)), sizeof(count));
+    const char *bytes = this->next_bytes(count);
+    std::string str(bytes, count);
+    this->next_bytes((8 - count % 8) % 8);
+    return str;
+}
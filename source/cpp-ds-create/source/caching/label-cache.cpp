@@ -0,0 +1,176 @@
+/* Symbols for caching WikiData label responses across dataset splits. */
+
+#include <map>
+#include <utility>
+#include "caching/label-cache.hpp"
+
+using namespace DutchKBQADSCreate;
+using namespace DutchKBQADSCreate::Caching;
+
+/**
+ * @brief Returns the current time in seconds since the UNIX epoch.
+ *
+ * @return The time.
+ */
+static std::int64_t seconds_since_epoch() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
+
+/**
+ * @brief The largest number of entities and properties to write per record
+ *   when compacting the cache.
+ */
+const Json::ArrayIndex max_compacted_record_size = 1000;
+
+/**
+ * @brief Opens the label cache stored in `file_name`, and indexes its
+ *   records. If the file does not exist yet, the cache starts out empty.
+ *
+ * @param ttl How long cached labels remain valid after having been fetched.
+ *   Zero if they never expire.
+ * @param file_name The name of the file in `resources/dataset/` to store the
+ *   cache in, without `.jsonl` extension.
+ */
+LabelResponseCache::LabelResponseCache(std::chrono::seconds ttl, std::string file_name)
+        : file_name(std::move(file_name)), ttl(ttl), superseded(0) {
+    if (ttl.count() < 0) {
+        throw std::invalid_argument("The time-to-live of cached labels cannot be negative.");
+    }
+    for (const auto &record : json_lines_loaded_from_dataset_file(this->file_name)) {
+        this->index_record(record);
+    }
+}
+
+/**
+ * @brief Returns the key of the labels of `id` in `language`.
+ *
+ * @param id The entity or property.
+ * @param language The natural language of the labels.
+ * @return The key.
+ */
+std::uint64_t LabelResponseCache::key_of(WikiData::symbol_id id, const NaturalLanguage &language) {
+    return (static_cast<std::uint64_t>(language) << 32) | id;
+}
+
+/**
+ * @brief Adds the labels of the cache record `record` to the in-memory index,
+ *   superseding any labels of the same entities and properties cached
+ *   earlier.
+ *
+ * @param record The record, a JSON object with the members `language`,
+ *   `fetched` and `labels`. Records in unknown natural languages are ignored.
+ */
+void LabelResponseCache::index_record(const Json::Value &record) {
+    const auto language = string_to_natural_language_map.find(record["language"].asString());
+    if (language == string_to_natural_language_map.end()) {
+        return;
+    }
+    const std::int64_t fetched = record["fetched"].asInt64();
+    const Json::Value &labels = record["labels"];
+    for (const auto &ent_or_prp : labels.getMemberNames()) {
+        Entry entry { fetched, {} };
+        for (const auto &label : labels[ent_or_prp]) {
+            entry.labels.push_back(label.asString());
+        }
+        const auto [it, inserted] = this->entries.insert_or_assign(
+            key_of(WikiData::parsed_symbol_id(ent_or_prp), language->second),
+            std::move(entry)
+        );
+        if (!inserted) {
+            this->superseded++;
+        }
+    }
+}
+
+/**
+ * @brief Returns the cached labels of `id` in `language`, provided that they
+ *   have not expired.
+ *
+ * @param id The entity or property.
+ * @param language The natural language of the labels.
+ * @return The labels, which may be empty if WikiData has none, or null if
+ *   no unexpired labels are cached.
+ */
+const std::vector<std::string> *LabelResponseCache::fresh_labels(WikiData::symbol_id id,
+                                                                 const NaturalLanguage &language) const {
+    const auto it = this->entries.find(key_of(id, language));
+    if (it == this->entries.end()) {
+        return nullptr;
+    }
+    if (this->ttl.count() > 0 && seconds_since_epoch() - it->second.fetched > this->ttl.count()) {
+        return nullptr;
+    }
+    return &it->second.labels;
+}
+
+/**
+ * @brief Caches the freshly-fetched labels `labels`, both on disk and in
+ *   memory.
+ *
+ * @param labels A mapping from entities and properties to arrays of zero or
+ *   more labels, as obtained from WikiData.
+ * @param language The natural language of the labels.
+ */
+void LabelResponseCache::store(const Json::Value &labels, const NaturalLanguage &language) {
+    Json::Value record;
+    record["language"] = string_from_natural_language(language);
+    record["fetched"] = Json::Int64(seconds_since_epoch());
+    record["labels"] = labels;
+    append_json_line_to_dataset_file(record, this->file_name);
+    this->index_record(record);
+}
+
+/**
+ * @brief Returns whether the cache file holds more superseded labels than
+ *   current ones, so that compacting it would at least halve its size.
+ *
+ * @return The question's answer.
+ */
+bool LabelResponseCache::worth_compacting() const {
+    return this->superseded > this->entries.size();
+}
+
+/**
+ * @brief Rewrites the cache file so that it only holds current labels.
+ *
+ * The compacted cache is first written to a temporary file, which then
+ * replaces the cache file. As such, an interrupted compaction leaves the cache
+ * file intact.
+ */
+void LabelResponseCache::compact() {
+    if (this->entries.empty()) {
+        fs::remove(dataset_dir / (this->file_name + ".jsonl"));
+        this->superseded = 0;
+        return;
+    }
+    /* Group the labels by language and fetch time, so that both survive. */
+    std::map<std::pair<std::uint64_t, std::int64_t>, std::vector<Json::Value>> groups;
+    for (const auto &[key, entry] : this->entries) {
+        std::vector<Json::Value> &records = groups[{ key >> 32, entry.fetched }];
+        if (records.empty() || records.back()["labels"].size() >= max_compacted_record_size) {
+            Json::Value record;
+            record["language"] = string_from_natural_language(static_cast<NaturalLanguage>(key >> 32));
+            record["fetched"] = Json::Int64(entry.fetched);
+            record["labels"] = Json::objectValue;
+            records.push_back(std::move(record));
+        }
+        Json::Value labels = Json::arrayValue;
+        for (const auto &label : entry.labels) {
+            labels.append(label);
+        }
+        const auto id = static_cast<WikiData::symbol_id>(key & 0xFFFFFFFFu);
+        records.back()["labels"][WikiData::string_from_symbol_id(id)] = std::move(labels);
+    }
+    const std::string compacting_file_name = this->file_name + ".compacting";
+    fs::remove(dataset_dir / (compacting_file_name + ".jsonl"));
+    for (const auto &group : groups) {
+        for (const auto &record : group.second) {
+            append_json_line_to_dataset_file(record, compacting_file_name);
+        }
+    }
+    fs::rename(dataset_dir / (compacting_file_name + ".jsonl"),
+               dataset_dir / (this->file_name + ".jsonl"));
+    this->superseded = 0;
+}
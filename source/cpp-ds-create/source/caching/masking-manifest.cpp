@@ -0,0 +1,183 @@
+/* Symbols for masking only the question-answer pairs whose inputs changed. */
+
+#include <utility>
+#include "caching/masking-manifest.hpp"
+
+using namespace DutchKBQADSCreate;
+using namespace DutchKBQADSCreate::Caching;
+
+/**
+ * @brief Starts a hash over an empty series of values.
+ */
+InputHasher::InputHasher() : hash(fnv_1a_offset_basis) {}
+
+/**
+ * @brief Adds the integer `value` to the series of hashed values.
+ *
+ * @param value The value.
+ */
+void InputHasher::add(std::uint64_t value) {
+    char bytes[sizeof(value)];
+    for (std::size_t idx = 0; idx < sizeof(value); idx++) {
+        bytes[idx] = static_cast<char>((value >> (8 * idx)) & 0xffu);  /* Independent of byte order. */
+    }
+    this->hash = fnv_1a_hash(bytes, sizeof(bytes), this->hash);
+}
+
+/**
+ * @brief Adds the string `value` to the series of hashed values.
+ *
+ * @param value The value.
+ */
+void InputHasher::add(std::string_view value) {
+    this->add(static_cast<std::uint64_t>(value.size()));
+    this->hash = fnv_1a_hash(value.data(), value.size(), this->hash);
+}
+
+/**
+ * @brief Returns the hash of the series of values added so far.
+ *
+ * @return The hash.
+ */
+std::uint64_t InputHasher::digest() const {
+    return this->hash;
+}
+
+/**
+ * @brief Constructs an empty manifest of the masked question-answer pairs
+ *   file `output_file_name`.
+ *
+ * @param output_file_name The name of the masked question-answer pairs file in
+ *   `resources/dataset/`, without `.json` extension.
+ */
+MaskingManifest::MaskingManifest(std::string output_file_name) : output_file_name(std::move(output_file_name)) {}
+
+/**
+ * @brief Returns the name of the manifest file of the masked question-answer
+ *   pairs file `output_file_name`.
+ *
+ * @param output_file_name The name of the masked question-answer pairs file in
+ *   `resources/dataset/`, without `.json` extension.
+ * @return The name of the manifest file in `resources/dataset/`, without
+ *   `.json` extension.
+ */
+std::string MaskingManifest::file_name_for(const std::string &output_file_name) {
+    return std::string("supplements/") + output_file_name + "-manifest";
+}
+
+/**
+ * @brief Loads the manifest of the masked question-answer pairs file
+ *   `output_file_name`, provided that it exists, is of the current format,
+ *   and describes the masked pairs file as it is now.
+ *
+ * @param output_file_name The name of the masked question-answer pairs file in
+ *   `resources/dataset/`, without `.json` extension.
+ * @return The manifest, or null if no usable manifest exists.
+ */
+std::optional<MaskingManifest> MaskingManifest::loaded(const std::string &output_file_name) {
+    const std::string file_name = file_name_for(output_file_name);
+    if (!dataset_file_exists(file_name + ".json") || !dataset_file_exists(output_file_name + ".json")) {
+        return std::nullopt;
+    }
+    const Json::Value json = json_loaded_from_dataset_file(file_name);
+    if (!json.isObject() ||
+        json["version"].asUInt() != masking_manifest_version ||
+        !json["output"].isObject() ||
+        !json["input-hashes"].isObject()) {
+        return std::nullopt;
+    }
+    const Json::Value &output = json["output"];
+    const SourceFingerprint fingerprint { output["size"].asUInt64(),
+                                          output["modification-time"].asInt64(),
+                                          output["content-hash"].asUInt64() };
+    if (!fingerprint_matches(fingerprint, dataset_dir / (output_file_name + ".json"))) {
+        return std::nullopt;
+    }
+    MaskingManifest manifest(output_file_name);
+    const Json::Value &input_hashes = json["input-hashes"];
+    for (const auto &uid : input_hashes.getMemberNames()) {
+        manifest.record(std::stoi(uid), input_hashes[uid].asUInt64());
+    }
+    return manifest;
+}
+
+/**
+ * @brief Returns the number of question-answer pairs of which this manifest
+ *   records the hash of the inputs.
+ *
+ * @return The number of pairs.
+ */
+std::size_t MaskingManifest::size() const {
+    return this->input_hashes.size();
+}
+
+/**
+ * @brief Determines whether the inputs of the question-answer pair with UID
+ *   `uid` hash to `input_hash`, as they did when the pair was last masked.
+ *
+ * @param uid The UID of the question-answer pair.
+ * @param input_hash The hash of the pair's current inputs.
+ * @return The question's answer.
+ */
+bool MaskingManifest::unchanged(int uid, std::uint64_t input_hash) const {
+    const auto entry = this->input_hashes.find(uid);
+    return entry != this->input_hashes.end() && entry->second == input_hash;
+}
+
+/**
+ * @brief Records that the question-answer pair with UID `uid` was masked
+ *   from inputs that hash to `input_hash`.
+ *
+ * @param uid The UID of the question-answer pair.
+ * @param input_hash The hash of the pair's inputs.
+ */
+void MaskingManifest::record(int uid, std::uint64_t input_hash) {
+    this->input_hashes[uid] = input_hash;
+}
+
+/**
+ * @brief Records the hashes of the inputs of all question-answer pairs that
+ *   `manifest` records.
+ *
+ * @param manifest The manifest to take the hashes from.
+ */
+void MaskingManifest::record_all(const MaskingManifest &manifest) {
+    for (const auto &[uid, input_hash] : manifest.input_hashes) {
+        this->record(uid, input_hash);
+    }
+}
+
+/**
+ * @brief Saves this manifest, along with the fingerprint of the masked
+ *   question-answer pairs file as it is now. Thus, save it only after the
+ *   masked pairs file has been saved.
+ *
+ * The manifest is written to a temporary file first, which then replaces any
+ * existing manifest.
+ */
+void MaskingManifest::save() const {
+    const SourceFingerprint fingerprint = source_fingerprint(dataset_dir / (this->output_file_name + ".json"));
+    Json::Value json;
+    json["version"] = masking_manifest_version;
+    json["output"]["size"] = static_cast<Json::UInt64>(fingerprint.size);
+    json["output"]["modification-time"] = static_cast<Json::Int64>(fingerprint.modification_time);
+    json["output"]["content-hash"] = static_cast<Json::UInt64>(fingerprint.content_hash);
+    json["input-hashes"] = Json::objectValue;
+    for (const auto &[uid, input_hash] : this->input_hashes) {
+        json["input-hashes"][std::to_string(uid)] = static_cast<Json::UInt64>(input_hash);
+    }
+    const std::string file_name = file_name_for(this->output_file_name);
+    save_json_to_dataset_file(json, file_name + ".saving");
+    fs::rename(dataset_dir / (file_name + ".saving.json"), dataset_dir / (file_name + ".json"));
+}
+
+/**
+ * @brief Removes the manifest of the masked question-answer pairs file
+ *   `output_file_name`, if it exists.
+ *
+ * @param output_file_name The name of the masked question-answer pairs file in
+ *   `resources/dataset/`, without `.json` extension.
+ */
+void MaskingManifest::remove(const std::string &output_file_name) {
+    fs::remove(dataset_dir / (file_name_for(output_file_name) + ".json"));
+}
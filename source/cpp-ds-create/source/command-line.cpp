@@ -1,11 +1,17 @@
 /* Symbols for parsing standard input at the command-line. */
 
+#include <exception>
+#include <iostream>
 #include <stdexcept>
 #include "command-line.hpp"
 #include "tasks/replace-special-symbols.hpp"
 #include "tasks/collect-entities-properties.hpp"
 #include "tasks/label-entities-properties.hpp"
 #include "tasks/mask-question-answer-pairs.hpp"
+#include "tasks/run-pipeline.hpp"
+#include "tasks/merge-shards.hpp"
+#include "tasks/finalise-dataset.hpp"
+#include "tracing/tracer.hpp"
 
 using namespace DutchKBQADSCreate;
 
@@ -41,10 +47,49 @@ vm_desc_pair DutchKBQADSCreate::dutch_kbqa_vm_desc_pair(int argc, char *argv[])
          "The natural language of the file's contents.")
         ("part-size",
          po::value<int>(),
-         "The number of entities and properties to label before saving to disk. Minimally 1.")
+         "The number of entities and properties to start labelling per query with. Adapts to query latency afterwards. Minimally 1.")
+        ("in-flight",
+         po::value<int>(),
+         "The number of WikiData queries to have in flight at once. Minimally 1. Defaults to 1.")
+        ("threads",
+         po::value<int>(),
+         "The number of threads to perform the task with. Minimally 1. Defaults to 1.")
         ("quiet",
          po::value<bool>(),
          "Whether to report progress ('false') or not ('true').")
+        ("checkpoints",
+         po::value<bool>(),
+         "Whether the pipeline task saves its intermediate results, like the separate tasks do ('true'), or only its end result and labels ('false'). Defaults to 'false'.")
+        ("label-cache",
+         po::value<bool>(),
+         "Whether to take labels from, and add fetched labels to, the label cache that all splits share ('true'), or to query WikiData for all labels ('false'). Defaults to 'true'.")
+        ("label-cache-ttl",
+         po::value<int>(),
+         "The number of days after which labels in the label cache expire, and are queried for again. 0 if they never expire. Defaults to 0.")
+        ("binary-cache",
+         po::value<bool>(),
+         "Whether to load dataset supplements from binary sidecar files next to them, (re)building those if stale ('true'), or to always parse the supplements' JSON ('false'). Defaults to 'true'.")
+        ("incremental",
+         po::value<bool>(),
+         "Whether to only mask the question-answer pairs of which the question, answer, or labels changed since the saved masked pairs were masked ('true'), or all pairs ('false'). Defaults to 'true'.")
+        ("max-edit-distance",
+         po::value<int>(),
+         "The largest number of edits (in characters) by which a label may differ from its occurrence in a question, for entities and properties none of whose labels occur in it exactly. Allows at most one edit per four characters of a label. 0 to only mask exact occurrences. Defaults to 0.")
+        ("finalise",
+         po::value<bool>(),
+         "Whether the pipeline task also finalises the masked question-answer pairs, like the 'finalise-dataset' task does ('true'), or not ('false'). Defaults to 'false'.")
+        ("fraction-to-validate",
+         po::value<double>(),
+         "The fraction (0 and 1 inclusive) of the question-answer pairs of the 'train' split that go to validation when finalising. Required to finalise the 'train' split.")
+        ("shard-index",
+         po::value<int>(),
+         "The index of the shard of the split to label or mask, from 0 up to '--shard-count'. Requires '--shard-count'.")
+        ("shard-count",
+         po::value<int>(),
+         "The number of shards to divide the split's labelling or masking into, so that each can run on its own machine. Merge the shards' output with the 'merge-shards' task. Defaults to 1.")
+        ("trace",
+         po::value<std::string>(),
+         "The path of a file to write a trace of the task's stages and counters to, in the Chrome trace format (which Perfetto opens too). A summary of the trace is printed once the task ends. Not traced if absent.")
         ("load-file-name",
          po::value<std::string>(),
          "The name of the file to load from.")
@@ -59,30 +104,71 @@ vm_desc_pair DutchKBQADSCreate::dutch_kbqa_vm_desc_pair(int argc, char *argv[])
 }
 
 /**
- * @brief Defers control to a subprogram based on command-line input values.
- * 
- * @param vm The variables map with which to determine which subprogram to
- *   run, and in what manner.
+ * @brief Runs the subprogram of the task type `task_type`.
+ *
+ * @param task_type The type of the task to run.
+ * @param vm The variables map with which to determine in what manner to run
+ *   the subprogram.
  */
-void DutchKBQADSCreate::execute_dutch_kbqa_subprogram(po::variables_map &vm) {
-    if (vm.count("task") == 0) {
-        throw std::invalid_argument(std::string(R"(The "-task" ("-t") flag )") +
-                                    "is required.");
-    }
-    auto it = string_to_task_type_map.find(vm["task"].as<std::string>());
-    assert(it != string_to_task_type_map.end());
-    TaskType task_type = it->second;
+void execute_task(TaskType task_type, po::variables_map &vm) {
     if (task_type == TaskType::REPLACE_SPECIAL_SYMBOLS) {
         replace_special_symbols_in_dataset_file(vm);
     } else if (task_type == TaskType::GENERATE_QUESTION_TO_ENTITIES_PROPERTIES_MAP) {
         generate_question_entities_properties_map(vm);
     } else if (task_type == TaskType::LABEL_ENTITIES_AND_PROPERTIES) {
         label_entities_and_properties(vm);
+    } else if (task_type == TaskType::COMPACT_ENTITY_AND_PROPERTY_LABELS) {
+        compact_entity_and_property_labels(vm);
     } else if (task_type == TaskType::MASK_QUESTION_ANSWER_PAIRS) {
         mask_question_answer_pairs(vm);
+    } else if (task_type == TaskType::PIPELINE) {
+        run_pipeline(vm);
+    } else if (task_type == TaskType::MERGE_SHARDS) {
+        merge_shards(vm);
+    } else if (task_type == TaskType::FINALISE_DATASET) {
+        finalise_dataset(vm);
     } else {
         throw std::invalid_argument(std::string("Task type \"") +
                                     vm["task"].as<std::string>() +
                                     "\" is not supported.");
     }
 }
+
+/**
+ * @brief Defers control to a subprogram based on command-line input values.
+ *
+ * If `--trace` is passed, the subprogram is traced, and the trace is written
+ * and summarised once it ends, whether it succeeds or not.
+ * 
+ * @param vm The variables map with which to determine which subprogram to
+ *   run, and in what manner.
+ */
+void DutchKBQADSCreate::execute_dutch_kbqa_subprogram(po::variables_map &vm) {
+    if (vm.count("task") == 0) {
+        throw std::invalid_argument(std::string(R"(The "-task" ("-t") flag )") +
+                                    "is required.");
+    }
+    auto it = string_to_task_type_map.find(vm["task"].as<std::string>());
+    assert(it != string_to_task_type_map.end());
+    TaskType task_type = it->second;
+    if (vm.count("trace") == 0) {
+        execute_task(task_type, vm);
+        return;
+    }
+    Tracing::tracer().enable();
+    std::exception_ptr task_error;
+    {
+        const Tracing::Stage stage(it->first);
+        try {
+            execute_task(task_type, vm);
+        } catch (...) {
+            task_error = std::current_exception();
+        }
+    }
+    Tracing::tracer().write_chrome_trace(vm["trace"].as<std::string>());
+    std::cout << std::endl << "Trace written to \"" << vm["trace"].as<std::string>() << "\"." << std::endl;
+    Tracing::tracer().write_summary(std::cout);
+    if (task_error) {
+        std::rethrow_exception(task_error);
+    }
+}
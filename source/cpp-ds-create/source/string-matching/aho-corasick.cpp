@@ -0,0 +1,206 @@
+/* Symbols for matching many patterns at once using Aho-Corasick automata. */
+
+#include <queue>
+#include <stdexcept>
+#include <unordered_set>
+#include "string-matching/aho-corasick.hpp"
+
+using namespace DutchKBQADSCreate::StringMatching;
+
+/**
+ * @brief Constructs an empty Aho-Corasick automaton. It only has a root state.
+ */
+AhoCorasickAutomaton::AhoCorasickAutomaton() {
+    this->states.push_back({ {}, 0, no_automaton_entry, no_automaton_entry });
+    this->compiled = false;
+}
+
+/**
+ * @brief Adds a pattern to search for to this automaton.
+ *
+ * Adding the same pattern twice does not create a second pattern; instead,
+ * the ID of the already-present pattern is returned.
+ *
+ * @param pattern The pattern. Must be non-empty.
+ * @return The ID of the pattern.
+ */
+int AhoCorasickAutomaton::add_pattern(const std::string &pattern) {
+    if (this->compiled) {
+        throw std::logic_error("Cannot add patterns to an already-compiled automaton!");
+    } else if (pattern.empty()) {
+        throw std::invalid_argument("Cannot add an empty pattern to an automaton!");
+    }
+    int state = 0;
+    for (const char &c : pattern) {
+        const auto symbol = static_cast<unsigned char>(c);
+        const auto it = this->states[state].transitions.find(symbol);
+        if (it == this->states[state].transitions.end()) {
+            this->states.push_back({ {}, 0, no_automaton_entry, no_automaton_entry });
+            const int created = static_cast<int>(this->states.size()) - 1;
+            this->states[state].transitions.insert({ symbol, created });
+            state = created;
+        } else {
+            state = it->second;
+        }
+    }
+    if (this->states[state].pattern == no_automaton_entry) {
+        this->patterns.push_back(pattern);
+        this->states[state].pattern = static_cast<int>(this->patterns.size()) - 1;
+    }
+    return this->states[state].pattern;
+}
+
+/**
+ * @brief Computes the failure and dictionary links of all states, making this
+ *   automaton ready for searching.
+ *
+ * The states are visited in breadth-first order, such that the failure link of
+ * a state's parent is always known before that of the state itself. See
+ * algorithm 3 of Aho and Corasick (1975).
+ */
+void AhoCorasickAutomaton::compile() {
+    std::queue<int> queue;
+    for (const auto &transition : this->states[0].transitions) {
+        this->states[transition.second].failure = 0;
+        queue.push(transition.second);
+    }
+    while (!queue.empty()) {
+        const int state = queue.front();
+        queue.pop();
+        for (const auto &transition : this->states[state].transitions) {
+            const int child = transition.second;
+            int fallback = this->states[state].failure;
+            while (fallback != 0 && this->states[fallback].transitions.count(transition.first) == 0) {
+                fallback = this->states[fallback].failure;
+            }
+            const auto it = this->states[fallback].transitions.find(transition.first);
+            this->states[child].failure = (it == this->states[fallback].transitions.end() || it->second == child) ?
+                                          0 :
+                                          it->second;
+            const AhoCorasickState &failure_state = this->states[this->states[child].failure];
+            this->states[child].dictionary_link = failure_state.pattern != no_automaton_entry ?
+                                                  this->states[child].failure :
+                                                  failure_state.dictionary_link;
+            queue.push(child);
+        }
+    }
+    this->compiled = true;
+}
+
+/**
+ * @brief Determines whether this automaton has been compiled, and thus is
+ *   ready for searching.
+ *
+ * @return The question's answer.
+ */
+bool AhoCorasickAutomaton::is_compiled() const {
+    return this->compiled;
+}
+
+/**
+ * @brief Returns the number of unique patterns of this automaton.
+ *
+ * @return The number.
+ */
+int AhoCorasickAutomaton::number_of_patterns() const {
+    return static_cast<int>(this->patterns.size());
+}
+
+/**
+ * @brief Returns the pattern with the given ID.
+ *
+ * @param pattern_id The ID of the pattern.
+ * @return The pattern.
+ */
+const std::string &AhoCorasickAutomaton::pattern(int pattern_id) const {
+    return this->patterns.at(pattern_id);
+}
+
+/**
+ * @brief Returns the state reached from `state` upon reading `symbol`, taking
+ *   failure transitions where needed.
+ *
+ * @param state The departure state.
+ * @param symbol The byte read.
+ * @return The arrival state.
+ */
+int AhoCorasickAutomaton::next_state(int state, unsigned char symbol) const {
+    while (true) {
+        const auto &transitions = this->states[state].transitions;
+        const auto it = transitions.find(symbol);
+        if (it != transitions.end()) {
+            return it->second;
+        } else if (state == 0) {
+            return 0;
+        }
+        state = this->states[state].failure;
+    }
+}
+
+/**
+ * @brief Returns all occurrences of all patterns within `text`, possibly
+ *   overlapping.
+ *
+ * Occurrences are ordered by their ending index; occurrences that end at the
+ * same index are ordered from longest to shortest.
+ *
+ * @param text The text to search in.
+ * @return The occurrences.
+ */
+std::vector<pattern_match> AhoCorasickAutomaton::all_matches(const std::string &text) const {
+    if (!this->compiled) {
+        throw std::logic_error("The automaton must be compiled before searching with it!");
+    }
+    std::vector<pattern_match> matches;
+    int state = 0;
+    for (std::size_t idx = 0; idx < text.size(); idx++) {
+        state = this->next_state(state, static_cast<unsigned char>(text[idx]));
+        int out = this->states[state].pattern != no_automaton_entry ?
+                  state :
+                  this->states[state].dictionary_link;
+        while (out != no_automaton_entry) {
+            const int pattern_id = this->states[out].pattern;
+            const int length = static_cast<int>(this->patterns[pattern_id].size());
+            matches.emplace_back(pattern_id,
+                                 index_range(static_cast<int>(idx) - length + 1, static_cast<int>(idx)));
+            out = this->states[out].dictionary_link;
+        }
+    }
+    return matches;
+}
+
+/**
+ * @brief Returns, for every pattern occurring in `text`, the index range of
+ *   its first (leftmost) occurrence.
+ *
+ * This is equivalent to calling `std::string::find` once per pattern, but
+ * takes only one pass over the text. Because a state's dictionary path is
+ * reported in full the first time the state is reached, it never needs to be
+ * walked again; this keeps the work linear in the text length plus the number
+ * of distinct patterns found.
+ *
+ * @param text The text to search in.
+ * @return The first occurrence of each occurring pattern.
+ */
+first_pattern_matches AhoCorasickAutomaton::first_matches(const std::string &text) const {
+    if (!this->compiled) {
+        throw std::logic_error("The automaton must be compiled before searching with it!");
+    }
+    first_pattern_matches matches;
+    std::unordered_set<int> reported_states;
+    int state = 0;
+    for (std::size_t idx = 0; idx < text.size(); idx++) {
+        state = this->next_state(state, static_cast<unsigned char>(text[idx]));
+        int out = this->states[state].pattern != no_automaton_entry ?
+                  state :
+                  this->states[state].dictionary_link;
+        while (out != no_automaton_entry && reported_states.insert(out).second) {
+            const int pattern_id = this->states[out].pattern;
+            const int length = static_cast<int>(this->patterns[pattern_id].size());
+            matches.insert({ pattern_id,
+                             index_range(static_cast<int>(idx) - length + 1, static_cast<int>(idx)) });
+            out = this->states[out].dictionary_link;
+        }
+    }
+    return matches;
+}
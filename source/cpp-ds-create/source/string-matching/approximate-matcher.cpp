@@ -0,0 +1,230 @@
+/* Symbols for finding approximate occurrences of patterns using bit-parallel edit distances. */
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <stdexcept>
+#include <utility>
+#include "string-matching/approximate-matcher.hpp"
+#include "suffix-trees/unicode-string.hpp"
+
+using namespace DutchKBQADSCreate::StringMatching;
+
+namespace {
+    /**
+     * @brief For every code point of a pattern, the bit vector of the
+     *   positions at which it occurs in the pattern; Myers (1999) calls this
+     *   `Peq`.
+     */
+    class PatternBitVectors {
+    private:
+        /**
+         * @brief The bit vectors of the ASCII code points, indexed directly.
+         */
+        std::array<std::uint64_t, 128> ascii;
+        /**
+         * @brief The bit vectors of all other code points of the pattern.
+         */
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> other;
+    public:
+        explicit PatternBitVectors(const std::vector<std::uint32_t> &pattern);
+        [[nodiscard]] std::uint64_t operator[](std::uint32_t code_point) const;
+    };
+}
+
+/**
+ * @brief Constructs the bit vectors of the code points of `pattern`.
+ *
+ * @param pattern The pattern. At most `max_approximate_pattern_length` code
+ *   points long.
+ */
+PatternBitVectors::PatternBitVectors(const std::vector<std::uint32_t> &pattern) : ascii() {
+    for (std::size_t idx = 0; idx < pattern.size(); idx++) {
+        const std::uint64_t bit = static_cast<std::uint64_t>(1) << idx;
+        if (pattern[idx] < this->ascii.size()) {
+            this->ascii[pattern[idx]] |= bit;
+            continue;
+        }
+        const auto entry = std::find_if(this->other.begin(), this->other.end(), [&] (const auto &other_entry) {
+            return other_entry.first == pattern[idx];
+        });
+        if (entry == this->other.end()) {
+            this->other.emplace_back(pattern[idx], bit);
+        } else {
+            entry->second |= bit;
+        }
+    }
+}
+
+/**
+ * @brief Returns the bit vector of `code_point`.
+ *
+ * @param code_point The code point.
+ * @return The bit vector, in which bit `i` is set iff the pattern's `i`-th
+ *   code point is `code_point`.
+ */
+std::uint64_t PatternBitVectors::operator[](std::uint32_t code_point) const {
+    if (code_point < this->ascii.size()) {
+        return this->ascii[code_point];
+    }
+    for (const auto &[other_code_point, bits] : this->other) {
+        if (other_code_point == code_point) {
+            return bits;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Determines whether `code_point` may be part of a word: whether it is
+ *   an ASCII letter or digit, or is not ASCII at all.
+ *
+ * @param code_point The code point.
+ * @return The question's answer.
+ */
+static bool is_word_code_point(std::uint32_t code_point) {
+    return code_point >= 0x80 || std::isalnum(static_cast<int>(code_point));
+}
+
+/**
+ * @brief Constructs a matcher for approximate occurrences of patterns in
+ *   `text`.
+ *
+ * @param text The text to search in. Must be properly UTF8-encoded.
+ */
+ApproximateMatcher::ApproximateMatcher(const std::string &text) {
+    SuffixTrees::UnicodeString::append_utf8_decoded(text, this->code_points);
+    this->byte_offsets.reserve(this->code_points.size() + 1);
+    for (std::size_t idx = 0; idx < text.size(); idx++) {
+        if ((static_cast<unsigned char>(text[idx]) & 0xc0u) != 0x80) {
+            this->byte_offsets.push_back(static_cast<int>(idx));  /* Not a continuation byte. */
+        }
+    }
+    this->byte_offsets.push_back(static_cast<int>(text.size()));
+}
+
+/**
+ * @brief Returns the index of the first code point of the shortest substring
+ *   of the text that ends at the code point with index `end`, and that has
+ *   edit distance `distance` to `pattern`.
+ *
+ * Only the substrings that can be that close to the pattern are considered, so
+ * that this takes time proportional to the square of the pattern's length.
+ *
+ * @param pattern The pattern.
+ * @param end The index of the last code point of the substring.
+ * @param distance The smallest edit distance between `pattern` and any
+ *   substring of the text ending at `end`.
+ * @return The index.
+ */
+std::size_t ApproximateMatcher::start_of_match(const std::vector<std::uint32_t> &pattern,
+                                               std::size_t end,
+                                               int distance) const {
+    const std::size_t window = std::min(end + 1, pattern.size() + static_cast<std::size_t>(distance));
+    /* Align the pattern and the text at their ends: row `i`, column `l` holds
+     * the distance between the last `i` code points of the pattern and the
+     * `l` code points of the text up to and including `end`. */
+    std::vector<int> previous(window + 1);
+    std::vector<int> current(window + 1);
+    for (std::size_t l = 0; l <= window; l++) {
+        previous[l] = static_cast<int>(l);
+    }
+    for (std::size_t i = 1; i <= pattern.size(); i++) {
+        current[0] = static_cast<int>(i);
+        const std::uint32_t pattern_code_point = pattern[pattern.size() - i];
+        for (std::size_t l = 1; l <= window; l++) {
+            const int substitution = previous[l - 1] + (pattern_code_point == this->code_points[end + 1 - l] ? 0 : 1);
+            current[l] = std::min({ substitution, previous[l] + 1, current[l - 1] + 1 });
+        }
+        std::swap(previous, current);
+    }
+    std::size_t best_length = 1;
+    for (std::size_t l = 1; l <= window; l++) {
+        if (previous[l] == distance) {
+            best_length = l;
+            break;
+        } else if (previous[l] < previous[best_length]) {
+            best_length = l;
+        }
+    }
+    return end + 1 - best_length;
+}
+
+/**
+ * @brief Returns the occurrence of `pattern` in the text with the smallest
+ *   edit distance to it, provided that the distance is small enough.
+ *
+ * The distance allowed is capped at one edit per
+ * `approximate_pattern_length_per_edit` code points of the pattern. The
+ * closest occurrences that end first often end in a row, as in `Sta`, `Staa`,
+ * and `Staat` for the pattern `Staten`; of those, the first that ends a word
+ * is returned, or the first of all if none does. It spans as few code points
+ * as possible.
+ *
+ * @param pattern The pattern to search for. Must be properly UTF8-encoded.
+ * @param max_distance The largest edit distance to allow between the pattern
+ *   and its occurrence. Minimally 0.
+ * @return The occurrence, or null if none is close enough. Patterns that are
+ *   empty, or that are longer than `max_approximate_pattern_length` code
+ *   points, never occur.
+ */
+std::optional<ApproximateMatch> ApproximateMatcher::best_match(std::string_view pattern, int max_distance) const {
+    if (max_distance < 0) {
+        throw std::invalid_argument(std::string("The largest edit distance must be at least 0, but is ") +
+                                    std::to_string(max_distance) +
+                                    ".");
+    }
+    std::vector<std::uint32_t> pattern_code_points;
+    SuffixTrees::UnicodeString::append_utf8_decoded(std::string(pattern), pattern_code_points);
+    const std::size_t length = pattern_code_points.size();
+    if (length == 0 || length > max_approximate_pattern_length) {
+        return std::nullopt;
+    }
+    const int allowed_distance = std::min(max_distance,
+                                          static_cast<int>(length / approximate_pattern_length_per_edit));
+
+    /* Myers (1999), as formulated by Hyyrö (2001). The vertical deltas `Pv`
+     * and `Mv` describe the column of the dynamic programming matrix at the
+     * current text position; `score` is its last entry. */
+    const PatternBitVectors peq(pattern_code_points);
+    const std::uint64_t last_bit = static_cast<std::uint64_t>(1) << (length - 1);
+    std::uint64_t pv = ~static_cast<std::uint64_t>(0);
+    std::uint64_t mv = 0;
+    int score = static_cast<int>(length);
+    int best_score = allowed_distance + 1;
+    std::vector<int> scores(this->code_points.size());
+    for (std::size_t idx = 0; idx < this->code_points.size(); idx++) {
+        const std::uint64_t eq = peq[this->code_points[idx]];
+        const std::uint64_t xv = eq | mv;
+        const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        std::uint64_t ph = mv | ~(xh | pv);
+        std::uint64_t mh = pv & xh;
+        if ((ph & last_bit) != 0) {
+            score++;
+        } else if ((mh & last_bit) != 0) {
+            score--;
+        }
+        /* Occurrences may start anywhere, so the top row stays 0: no bit is
+         * shifted in. */
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        scores[idx] = score;
+        best_score = std::min(best_score, score);
+    }
+    if (best_score > allowed_distance) {
+        return std::nullopt;
+    }
+    const std::size_t first_end = std::find(scores.begin(), scores.end(), best_score) - scores.begin();
+    std::size_t best_end = first_end;
+    for (std::size_t idx = first_end; idx < scores.size() && scores[idx] == best_score; idx++) {
+        if (idx + 1 == scores.size() || !is_word_code_point(this->code_points[idx + 1])) {
+            best_end = idx;
+            break;
+        }
+    }
+    const std::size_t best_start = this->start_of_match(pattern_code_points, best_end, best_score);
+    return ApproximateMatch { { this->byte_offsets[best_start], this->byte_offsets[best_end + 1] - 1 },
+                              best_score };
+}
@@ -23,7 +23,7 @@ int *DutchKBQADSCreate::SuffixTrees::weak_int_ptr_from_variant(const int_ptr_var
     }
 }
 
-int ExplicitState::explicit_states_id_counter = 0;
+std::atomic<int> ExplicitState::explicit_states_id_counter = 0;
 
 /**
  * @brief Constructs a new explicit state for a Ukkonen suffix tree.
@@ -31,17 +31,37 @@ int ExplicitState::explicit_states_id_counter = 0;
  * @param parent The parent state in the tree from which this explicit state
  *   descends.
  */
-ExplicitState::ExplicitState(ExplicitState *parent) : id(explicit_states_id_counter) {
-    ExplicitState::explicit_states_id_counter++;
+ExplicitState::ExplicitState(ExplicitState *parent)
+        : id(ExplicitState::explicit_states_id_counter.fetch_add(1, std::memory_order_relaxed)) {
     this->parent = parent;
     this->transitions = state_transitions();
     this->suffix_link = nullptr;
 }
 
 /**
- * @brief Destructs an explicit state for a Ukkonen suffix tree.
+ * @brief Destructs an explicit state for a Ukkonen suffix tree, along with all
+ *   of its descendants.
+ *
+ * Descendants are detached and destructed one by one, instead of recursively
+ * through their owning pointers, so that deep trees (such as those of long,
+ * repetitive strings) do not overflow the program's stack memory.
  */
-ExplicitState::~ExplicitState() = default;
+ExplicitState::~ExplicitState() {
+    std::vector<std::unique_ptr<ExplicitState>> pending;
+    auto detach_children = [&pending] (ExplicitState *es) -> void {
+        for (auto &transition : es->transitions) {
+            if (transition.second.second != nullptr) {
+                pending.push_back(std::move(transition.second.second));
+            }
+        }
+    };
+    detach_children(this);
+    while (!pending.empty()) {
+        std::unique_ptr<ExplicitState> es = std::move(pending.back());
+        pending.pop_back();
+        detach_children(es.get());
+    }
+}
 
 /**
  * @brief Returns the ID of this explicit state.
@@ -62,7 +82,7 @@ int ExplicitState::get_id() const {
  * @param right_ptr The right pointer for the transition.
  * @param child The child explicit state; the destination of the transition.
  */
-void ExplicitState::set_transition(UnicodeString uni_str,
+void ExplicitState::set_transition(UnicodeStringView uni_str,
                                    int left_ptr,
                                    right_pointer right_ptr,
                                    std::unique_ptr<ExplicitState> child) {
@@ -141,7 +161,7 @@ weak_state_transition ExplicitState::weakly_get_transition(utf8::uint32_t code_p
  * @param right_ptr The right pointer of the transition to `s'`.
  * @return A 'weak' (C-style) pointer to the newly-created explicit state, `r`.
  */
-ExplicitState *ExplicitState::internal_split(UnicodeString uni_str,
+ExplicitState *ExplicitState::internal_split(UnicodeStringView uni_str,
                                              int left_ptr,
                                              right_pointer right_ptr) {
     int k, p, k_prime;
@@ -245,7 +265,7 @@ std::string indent_string(int number) {
  * @warning This method is recursive. As such, if fed sufficiently large input,
  *   it may overflow the program's stack memory.
  */
-void ExplicitState::print(UnicodeString uni_str, int num_indents) {
+void ExplicitState::print(UnicodeStringView uni_str, int num_indents) {
     assert(num_indents >= 0);
     const std::string indent_str = indent_string(num_indents);
     std::cout << indent_str << this->as_string() << std::endl;
@@ -253,7 +273,7 @@ void ExplicitState::print(UnicodeString uni_str, int num_indents) {
         int trn_left_ptr, *trn_right_ptr;
         trn_left_ptr = transition.second.first.first - 1;  /* Indices cancel out: -1 + 1 = 0. */
         trn_right_ptr = weak_int_ptr_from_variant(transition.second.first.second);
-        UnicodeString trn_substr = uni_str.substring(trn_left_ptr, *trn_right_ptr);
+        UnicodeStringView trn_substr = uni_str.substring(trn_left_ptr, *trn_right_ptr);
         std::cout << indent_str << single_indent;
         std::cout << "(" << transition.second.first.first << ", " << *trn_right_ptr << ") ";
         std::cout << "(" << UnicodeString::basic_string_from_unicode_string(trn_substr) << ") ";
@@ -267,13 +287,16 @@ void ExplicitState::print(UnicodeString uni_str, int num_indents) {
  *
  * @param uni_str The UTF32-encoded Unicode string on which the tree is based.
  */
-AuxiliaryState::AuxiliaryState(UnicodeString uni_str) : ExplicitState(nullptr) {
+AuxiliaryState::AuxiliaryState(UnicodeStringView uni_str) : ExplicitState(nullptr) {
     this->root = std::make_unique<ExplicitState>(this);
     int j = -1;
     for (int idx = 0; idx < static_cast<int>(uni_str.length); idx++) {
         const utf8::uint32_t cp = uni_str.code_point_at(idx);
         this->left_right_pointer_pair_integers_per_code_point.emplace_back(cp,
                                                                            std::make_unique<int>(j));
+        this->first_pointer_per_code_point.insert(
+            { cp, this->left_right_pointer_pair_integers_per_code_point.back().second.get() }
+        );
         j--;
     }
     this->root->set_suffix_link(this);
@@ -285,18 +308,16 @@ AuxiliaryState::AuxiliaryState(UnicodeString uni_str) : ExplicitState(nullptr) {
 AuxiliaryState::~AuxiliaryState() = default;
 
 /**
- * @brief
+ * @brief Returns a 'weak', C-style pointer to the left (and right) pointer
+ *   integer of the auxiliary state's `code_point`-transition.
  *
- * @param code_point
- * @return
+ * @param code_point The code point.
+ * @return The pointer, or a null pointer if `code_point` does not occur in the
+ *   string on which the suffix tree is based.
  */
 int *AuxiliaryState::weak_pointer_for_code_point(utf8::uint32_t code_point) {
-    for (const auto &cp_pointer_pair : this->left_right_pointer_pair_integers_per_code_point) {
-        if (cp_pointer_pair.first == code_point) {
-            return cp_pointer_pair.second.get();
-        }
-    }
-    return nullptr;
+    const auto it = this->first_pointer_per_code_point.find(code_point);
+    return it == this->first_pointer_per_code_point.end() ? nullptr : it->second;
 }
 
 /**
@@ -350,7 +371,7 @@ std::optional<ExplicitState*> AuxiliaryState::state_transition_if_present(utf8::
  * @param num_indents The number of indents to apply during formatting. A
  *   strictly non-negative integer.
  */
-void AuxiliaryState::print(UnicodeString uni_str, int num_indents) {
+void AuxiliaryState::print(UnicodeStringView uni_str, int num_indents) {
     assert(num_indents > 0);
     const std::string indent_str = indent_string(num_indents);
     std::cout << num_indents << this->as_string() << std::endl;
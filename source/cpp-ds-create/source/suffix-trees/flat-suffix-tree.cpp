@@ -0,0 +1,301 @@
+/* Symbols for constructing arena-allocated Ukkonen suffix trees. */
+
+#include <stdexcept>
+#include "suffix-trees/flat-suffix-tree.hpp"
+
+using namespace DutchKBQADSCreate::SuffixTrees;
+
+/**
+ * @brief Constructs an arena-allocated Ukkonen suffix tree. Only the auxiliary
+ *   state and the root are created; call `construct` to build the rest.
+ *
+ * @param str A UTF8-encoded string from which to build the tree.
+ */
+FlatSuffixTree::FlatSuffixTree(const std::string &str) : FlatSuffixTree(UnicodeString(str)) {}
+
+/**
+ * @brief Constructs an arena-allocated Ukkonen suffix tree. Only the auxiliary
+ *   state and the root are created; call `construct` to build the rest.
+ *
+ * @param uni_str A UTF32-encoded Unicode string from which to build the tree.
+ *   It may contain sentinel code points outside the Unicode code space.
+ */
+FlatSuffixTree::FlatSuffixTree(UnicodeString uni_str) : uni_str(std::move(uni_str)) {
+    /* A suffix tree over `n` code points has at most `2n + 1` states (including
+     * the root), and at most `2n` transitions. Reserve these up-front, so that
+     * the arenas never need to grow during construction. */
+    this->nodes.reserve(2 * static_cast<std::size_t>(this->uni_str.length) + 2);
+    this->edges.reserve(2 * static_cast<std::size_t>(this->uni_str.length));
+    this->new_node();  /* The auxiliary state. */
+    this->new_node();  /* The root. */
+    this->nodes[FlatSuffixTree::root].suffix_link = FlatSuffixTree::auxiliary;
+    this->leaf_right_ptr = 0;
+}
+
+/**
+ * @brief Creates a new node without outgoing edges or a suffix link.
+ *
+ * @return The arena index of the new node.
+ */
+arena_index FlatSuffixTree::new_node() {
+    this->nodes.push_back({ no_arena_index, no_arena_index });
+    return static_cast<arena_index>(this->nodes.size()) - 1;
+}
+
+/**
+ * @brief Adds an edge from `node` to `child`, keeping the outgoing edges of
+ *   `node` ordered by their first code point.
+ *
+ * @param node The departure node.
+ * @param left_ptr The left pointer of the edge.
+ * @param right_ptr The right pointer of the edge, or `open_right_ptr`.
+ * @param child The destination node.
+ */
+void FlatSuffixTree::add_edge(arena_index node,
+                              std::int32_t left_ptr,
+                              std::int32_t right_ptr,
+                              arena_index child) {
+    const utf8::uint32_t code_point = this->uni_str.code_point_at(left_ptr - 1);  /* 1- to 0-based indexing. */
+    const auto created = static_cast<arena_index>(this->edges.size());
+    this->edges.push_back({ code_point, left_ptr, right_ptr, child, no_arena_index });
+    arena_index previous = no_arena_index;
+    arena_index current = this->nodes[node].first_edge;
+    while (current != no_arena_index && this->edges[current].code_point < code_point) {
+        previous = current;
+        current = this->edges[current].next_sibling;
+    }
+    if (current != no_arena_index && this->edges[current].code_point == code_point) {
+        throw std::logic_error("You're trying to overwrite an existing transition!");
+    }
+    this->edges[created].next_sibling = current;
+    if (previous == no_arena_index) {
+        this->nodes[node].first_edge = created;
+    } else {
+        this->edges[previous].next_sibling = created;
+    }
+}
+
+/**
+ * @brief Returns the outgoing edge of `node` that starts with `code_point`.
+ *
+ * @param node The departure node. Must not be the auxiliary state.
+ * @param code_point The first code point of the edge's substring.
+ * @return The arena index of the edge, or `no_arena_index` if there is none.
+ */
+arena_index FlatSuffixTree::edge_for_code_point(arena_index node, utf8::uint32_t code_point) const {
+    arena_index current = this->nodes[node].first_edge;
+    while (current != no_arena_index && this->edges[current].code_point < code_point) {
+        current = this->edges[current].next_sibling;
+    }
+    if (current != no_arena_index && this->edges[current].code_point == code_point) {
+        return current;
+    } else {
+        return no_arena_index;
+    }
+}
+
+/**
+ * @brief Canonises the reference pair `(state, (left_ptr, right_ptr))`.
+ *
+ * See `ReferencePair::canonised`, and page 257 of Ukkonen (1995), procedure
+ * `canonize`.
+ *
+ * @param state The explicit state of the reference pair.
+ * @param left_ptr The left pointer of the reference pair.
+ * @param right_ptr The right pointer of the reference pair.
+ * @return The canonised state and left pointer.
+ */
+std::pair<arena_index, std::int32_t> FlatSuffixTree::canonised(arena_index state,
+                                                               std::int32_t left_ptr,
+                                                               std::int32_t right_ptr) {
+    while (left_ptr <= right_ptr) {
+        if (state == FlatSuffixTree::auxiliary) {
+            /* Every transition from the auxiliary state spells out a single
+             * code point, and leads to the root. */
+            state = FlatSuffixTree::root;
+            left_ptr++;
+            continue;
+        }
+        const arena_index edge_idx = this->edge_for_code_point(state,
+                                                               this->uni_str.code_point_at(left_ptr - 1));
+        const std::int32_t edge_length = this->edge_right_ptr(edge_idx) - this->edges[edge_idx].left_ptr + 1;
+        if (edge_length > right_ptr - left_ptr + 1) {
+            break;
+        }
+        left_ptr += edge_length;
+        state = this->edges[edge_idx].child;
+    }
+    return { state, left_ptr };
+}
+
+/**
+ * @brief Tests whether the canonical reference pair `(state, (left_ptr,
+ *   right_ptr))` is an endpoint, making its state explicit if it isn't
+ *   already.
+ *
+ * See `SuffixTree::test_and_split`, and page 256 of Ukkonen (1995), procedure
+ * `test-and-split`. The split is performed in-place: the existing edge is
+ * shortened and redirected to the new node, after which a single edge is added
+ * from the new node to the old destination.
+ *
+ * @param state The explicit state of the reference pair.
+ * @param left_ptr The left pointer of the reference pair.
+ * @param right_ptr The right pointer of the reference pair.
+ * @param code_point The code point to check for.
+ * @return A pair. The first entry contains the question's answer; the second
+ *   entry contains the (possibly new) explicit state.
+ */
+std::pair<bool, arena_index> FlatSuffixTree::test_and_split(arena_index state,
+                                                            std::int32_t left_ptr,
+                                                            std::int32_t right_ptr,
+                                                            utf8::uint32_t code_point) {
+    if (left_ptr <= right_ptr) {
+        const arena_index edge_idx = this->edge_for_code_point(state,
+                                                               this->uni_str.code_point_at(left_ptr - 1));
+        const std::int32_t left_ptr_prime = this->edges[edge_idx].left_ptr;
+        const std::int32_t split_ptr = left_ptr_prime + right_ptr - left_ptr;
+        if (code_point == this->uni_str.code_point_at(split_ptr)) {
+            return { true, state };  /* Line 3. */
+        }
+        const arena_index r = this->new_node();
+        const std::int32_t old_right_ptr = this->edges[edge_idx].right_ptr;
+        const arena_index old_child = this->edges[edge_idx].child;
+        this->edges[edge_idx].right_ptr = split_ptr;
+        this->edges[edge_idx].child = r;
+        this->add_edge(r, split_ptr + 1, old_right_ptr, old_child);
+        return { false, r };  /* Line 6. */
+    } else if (state == FlatSuffixTree::auxiliary) {
+        return { true, state };  /* The auxiliary state has all transitions. */
+    } else {
+        return { this->edge_for_code_point(state, code_point) != no_arena_index, state };  /* Line 9. */
+    }
+}
+
+/**
+ * @brief Transforms this suffix tree into one that has the next code point of
+ *   the source string included in it.
+ *
+ * See `SuffixTree::update`, and page 256 of Ukkonen (1995), procedure `update`.
+ *
+ * @param state The explicit state of the active point.
+ * @param left_ptr The left pointer of the active point.
+ * @param right_ptr The index of the code point to include (1-based).
+ * @return The new active point, as a canonical state and left pointer.
+ */
+std::pair<arena_index, std::int32_t> FlatSuffixTree::update(arena_index state,
+                                                            std::int32_t left_ptr,
+                                                            std::int32_t right_ptr) {
+    const utf8::uint32_t t_i = this->uni_str.code_point_at(right_ptr - 1);
+    arena_index old_root = FlatSuffixTree::root;
+    auto end_point_r = this->test_and_split(state, left_ptr, right_ptr - 1, t_i);
+    while (!end_point_r.first) {
+        const arena_index r = end_point_r.second;
+        const arena_index r_prime = this->new_node();
+        this->add_edge(r, right_ptr, open_right_ptr, r_prime);
+        if (old_root != FlatSuffixTree::root) {
+            this->nodes[old_root].suffix_link = r;
+        }
+        old_root = r;
+        const auto s_k_pair = this->canonised(this->nodes[state].suffix_link, left_ptr, right_ptr - 1);
+        state = s_k_pair.first;
+        left_ptr = s_k_pair.second;
+        end_point_r = this->test_and_split(state, left_ptr, right_ptr - 1, t_i);
+    }
+    if (old_root != FlatSuffixTree::root) {
+        this->nodes[old_root].suffix_link = state;
+    }
+    return { state, left_ptr };
+}
+
+/**
+ * @brief Constructs a complete Ukkonen suffix tree from the string it was
+ *   initialised with.
+ *
+ * See `SuffixTree::construct`, and 'algorithm 2' at page 257 of Ukkonen (1995).
+ */
+void FlatSuffixTree::construct() {
+    arena_index state = FlatSuffixTree::root;
+    std::int32_t left_ptr = 1;
+    for (std::int32_t i = 1; i <= this->uni_str.length; i++) {
+        this->leaf_right_ptr++;
+        const auto update_pair = this->update(state, left_ptr, i);
+        const auto canon_pair = this->canonised(update_pair.first, update_pair.second, i);
+        state = canon_pair.first;
+        left_ptr = canon_pair.second;
+    }
+}
+
+/**
+ * @brief Returns a view into the UTF32-encoded Unicode string on which this
+ *   suffix tree is based. The view is valid for as long as the tree is.
+ *
+ * @return The view.
+ */
+UnicodeStringView FlatSuffixTree::get_uni_str() const {
+    return this->uni_str;
+}
+
+/**
+ * @brief Returns the first outgoing edge of `node`.
+ *
+ * Further outgoing edges can be reached through `FlatEdge::next_sibling`.
+ *
+ * @param node The node.
+ * @return The arena index of the edge, or `no_arena_index` if `node` is a leaf.
+ */
+arena_index FlatSuffixTree::first_edge(arena_index node) const {
+    return this->nodes[node].first_edge;
+}
+
+/**
+ * @brief Returns the edge stored at `edge_idx` in the edge arena.
+ *
+ * @param edge_idx The arena index of the edge.
+ * @return The edge.
+ */
+const FlatEdge &FlatSuffixTree::edge(arena_index edge_idx) const {
+    return this->edges[edge_idx];
+}
+
+/**
+ * @brief Returns the effective right pointer of an edge, resolving
+ *   `open_right_ptr` to the tree's leaf right pointer.
+ *
+ * @param edge_idx The arena index of the edge.
+ * @return The right pointer. 1-based and inclusive.
+ */
+std::int32_t FlatSuffixTree::edge_right_ptr(arena_index edge_idx) const {
+    const std::int32_t right_ptr = this->edges[edge_idx].right_ptr;
+    return right_ptr == open_right_ptr ? this->leaf_right_ptr : right_ptr;
+}
+
+/**
+ * @brief Returns the suffix link of `node`: the node representing the
+ *   substring of `node` minus its first code point.
+ *
+ * @param node The node. Must be an internal node or the root.
+ * @return The arena index of the suffix link.
+ */
+arena_index FlatSuffixTree::suffix_link(arena_index node) const {
+    return this->nodes[node].suffix_link;
+}
+
+/**
+ * @brief Determines whether `node` is a leaf of this suffix tree.
+ *
+ * @param node The node.
+ * @return The question's answer.
+ */
+bool FlatSuffixTree::is_leaf(arena_index node) const {
+    return this->nodes[node].first_edge == no_arena_index;
+}
+
+/**
+ * @brief Returns the number of nodes of this suffix tree, including the
+ *   auxiliary state.
+ *
+ * @return The number.
+ */
+int FlatSuffixTree::number_of_nodes() const {
+    return static_cast<int>(this->nodes.size());
+}
@@ -1,6 +1,11 @@
 /* Symbols for obtaining longest common substrings between pairs of strings. */
 
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <thread>
 #include "suffix-trees/longest-common-substring.hpp"
 #include "suffix-trees/unicode-string.hpp"
 #include "suffix-trees/suffix-tree.hpp"
@@ -26,8 +31,8 @@ bool DutchKBQADSCreate::SuffixTrees::is_leaf_state(ExplicitState *es) {
  *   state forms: its starting- and ending index into the string of the Ukkonen
  *   suffix tree.
  * @param sep_end_range The index range that the query string forms, together
- *   with its separator- and ending character. (These are commonly '#' and
- *   '$'.)
+ *   with its separator- and ending character. (These are the sentinels
+ *   `separator_code_point` and `end_code_point`.)
  * @return The substring type of the explicit- and leaf state.
  */
 SubstringType DutchKBQADSCreate::SuffixTrees::leaf_state_substring_type(index_range leaf_state_range,
@@ -72,6 +77,9 @@ SubstringType DutchKBQADSCreate::SuffixTrees::updated_preliminary_state_substrin
  *   to the second string only, and belongs to both the first and second
  *   string.
  *
+ * The subtree of `es` is walked in post-order using an explicit stack, so the
+ * depth of the tree does not affect the program's stack memory.
+ *
  * @param es The explicit state for which to determine the substring type.
  * @param length The length of the substring that `es` represents.
  * @param lcs_length The currently longest path length; the length of the
@@ -79,70 +87,240 @@ SubstringType DutchKBQADSCreate::SuffixTrees::updated_preliminary_state_substrin
  * @param lcs_start_index The starting index of the currently longest path
  *   (and thereby that of the LCS).
  * @param sep_end_range The index range that the query string forms, together
- *   with its separator- and ending character. (These are commonly '#' and
- *   '$'.)
+ *   with its separator- and ending character. (These are the sentinels
+ *   `separator_code_point` and `end_code_point`.)
  * @return The substring type of explicit state `es`.
- * @warning This method is recursive. As such, if fed sufficiently large input,
- *   it may overflow the program's stack memory.
  */
 SubstringType DutchKBQADSCreate::SuffixTrees::state_substring_type(ExplicitState *es,
                                                                    int length,
                                                                    int *lcs_length,
                                                                    int *lcs_start_index,
                                                                    index_range sep_end_range) {
-    SubstringType es_type, child_type;
-    int *right_ptr;
-    es_type = SubstringType::UNDETERMINED;
-    for (auto it = es->transitions_start(); it != es->transitions_end(); ++it) {
+    std::vector<ExplicitTraversalFrame> frames;
+    frames.push_back({ es, es->transitions_start(), length, 0, SubstringType::UNDETERMINED });
+    while (true) {
+        ExplicitTraversalFrame &frame = frames.back();
+        if (frame.transition == frame.es->transitions_end()) {
+            /* All children are classified, so this state is, too. */
+            assert(frame.type != UNDETERMINED);
+            const ExplicitTraversalFrame done = frame;
+            frames.pop_back();
+            if (frames.empty()) {
+                return done.type;
+            }
+            ExplicitTraversalFrame &parent = frames.back();
+            parent.type = updated_preliminary_state_substring_type(parent.type, done.type);
+            if ((parent.type == FIRST_AND_SECOND) && (done.type == FIRST_AND_SECOND)) {
+                if (*lcs_length < done.length) {
+                    *lcs_length = done.length;
+                    *lcs_start_index = done.right_ptr - done.length + 1;
+                }
+            }
+            ++parent.transition;
+            continue;
+        }
         /* Get the index of the right pointer. (Recall: the indices are inclusive.) */
-        right_ptr = weak_int_ptr_from_variant(it->second.first.second);
-        if (is_leaf_state(it->second.second.get())) {
-            /* Base case. */
-            child_type = leaf_state_substring_type({ it->second.first.first, *right_ptr },
-                                                   sep_end_range);
+        const int left_ptr = frame.transition->second.first.first;
+        const int right_ptr = *weak_int_ptr_from_variant(frame.transition->second.first.second);
+        ExplicitState *child = frame.transition->second.second.get();
+        if (is_leaf_state(child)) {
+            frame.type = updated_preliminary_state_substring_type(
+                frame.type,
+                leaf_state_substring_type({ left_ptr, right_ptr }, sep_end_range)
+            );
+            ++frame.transition;
         } else {
-            /* Recursive case. */
-            child_type = state_substring_type(it->second.second.get(),
-                                              length + (*right_ptr - it->second.first.first + 1),
-                                              lcs_length,
-                                              lcs_start_index,
-                                              sep_end_range);
+            const int child_length = frame.length + (right_ptr - left_ptr + 1);
+            /* Note: this invalidates `frame`. */
+            frames.push_back({ child, child->transitions_start(), child_length, right_ptr, UNDETERMINED });
         }
-        es_type = updated_preliminary_state_substring_type(es_type, child_type);
-        if ((es_type == FIRST_AND_SECOND) && (child_type == FIRST_AND_SECOND)) {
-            int total_length = length + (*right_ptr - it->second.first.first + 1);
-            if (*lcs_length < total_length) {
-                *lcs_length = total_length;
-                *lcs_start_index = *right_ptr - total_length + 1;
+    }
+}
+
+/**
+ * @brief Walks the subtree of `node` in post-order, classifying every internal
+ *   node by its substring type, and calls `visit` on each once it is
+ *   classified.
+ *
+ * The walk uses an explicit stack, so the depth of the tree does not affect
+ * the program's stack memory. Per node, the classification is stored as
+ * `substring_flags` in the side array `flags`, which must hold (at least) one
+ * zeroed entry per node of `tree`.
+ *
+ * @tparam Visitor A callable taking the node, the length of its substring, and
+ *   the right pointer of the edge towards it.
+ * @param tree The arena-allocated suffix tree.
+ * @param node The node to start at.
+ * @param length The length of the substring that `node` represents.
+ * @param sep_end_range The index range that the query string forms, together
+ *   with its separator- and ending character.
+ * @param flags The side array in which to store the nodes' flags.
+ * @param visit The callable to visit each internal node with.
+ * @return The substring type of `node`.
+ */
+template <typename Visitor>
+static SubstringType classified_flat_subtree(const FlatSuffixTree &tree,
+                                             arena_index node,
+                                             int length,
+                                             DutchKBQADSCreate::index_range sep_end_range,
+                                             std::vector<substring_flags> &flags,
+                                             Visitor &&visit) {
+    std::vector<FlatTraversalFrame> frames;
+    frames.push_back({ node, tree.first_edge(node), length, 0 });
+    while (true) {
+        FlatTraversalFrame &frame = frames.back();
+        if (frame.edge == no_arena_index) {
+            /* All children are classified, so this node is, too. */
+            const FlatTraversalFrame done = frame;
+            const auto done_type = static_cast<SubstringType>(flags[done.node] & substring_type_mask);
+            assert(done_type != UNDETERMINED);
+            visit(done.node, done.length, done.right_ptr);
+            frames.pop_back();
+            if (frames.empty()) {
+                return done_type;
+            }
+            FlatTraversalFrame &parent = frames.back();
+            flags[parent.node] |= done_type;
+            if (done_type == FIRST_AND_SECOND) {
+                flags[parent.node] |= common_child_flag;
             }
+            parent.edge = tree.edge(parent.edge).next_sibling;
+            continue;
+        }
+        const FlatEdge &edge = tree.edge(frame.edge);
+        const int right_ptr = tree.edge_right_ptr(frame.edge);
+        if (tree.is_leaf(edge.child)) {
+            flags[frame.node] |= leaf_state_substring_type({ edge.left_ptr, right_ptr }, sep_end_range);
+            frame.edge = edge.next_sibling;
+        } else {
+            const int child_length = frame.length + (right_ptr - edge.left_ptr + 1);
+            /* Note: this invalidates `frame`. */
+            frames.push_back({ edge.child, tree.first_edge(edge.child), child_length, right_ptr });
         }
     }
-    assert(es_type != UNDETERMINED);
-    return es_type;
 }
 
 /**
- * @brief Searches for a separator-ending symbol combination that can be used
- *   to separate and terminate a string concatenation of `first` and `second`.
+ * @brief Determines the substring type that the given node of an
+ *   arena-allocated suffix tree represents.
  *
- * To be able to do so, both symbols must not already occur in either string.
+ * This is the `FlatSuffixTree` counterpart of `state_substring_type`. Edges
+ * are visited in the same (ascending code point) order, so that both find the
+ * same longest common substring.
  *
- * @param first The first string.
- * @param second The second string.
- * @return The symbol combination if such a combination is found. Otherwise, a
- *   null value.
+ * @param tree The arena-allocated suffix tree.
+ * @param node The node for which to determine the substring type.
+ * @param length The length of the substring that `node` represents.
+ * @param lcs_length The currently longest path length; the length of the
+ *   longest common substring (LCS).
+ * @param lcs_start_index The starting index of the currently longest path
+ *   (and thereby that of the LCS).
+ * @param sep_end_range The index range that the query string forms, together
+ *   with its separator- and ending character.
+ * @return The substring type of `node`.
+ */
+SubstringType DutchKBQADSCreate::SuffixTrees::flat_state_substring_type(const FlatSuffixTree &tree,
+                                                                        arena_index node,
+                                                                        int length,
+                                                                        int *lcs_length,
+                                                                        int *lcs_start_index,
+                                                                        index_range sep_end_range) {
+    std::vector<substring_flags> flags(tree.number_of_nodes(), 0);
+    auto record_if_longest = [&flags, lcs_length, lcs_start_index] (arena_index visited,
+                                                                    int visited_length,
+                                                                    int right_ptr) -> void {
+        if ((flags[visited] & substring_type_mask) == FIRST_AND_SECOND && *lcs_length < visited_length) {
+            *lcs_length = visited_length;
+            *lcs_start_index = right_ptr - visited_length + 1;
+        }
+    };
+    return classified_flat_subtree(tree, node, length, sep_end_range, flags, record_if_longest);
+}
+
+/**
+ * @brief Determines the longest common substring of two concatenated strings
+ *   from the suffix- and longest common prefix arrays of their concatenation,
+ *   in one sweep over adjacent suffixes.
+ *
+ * Every common substring is a common prefix of two suffixes starting in
+ * different strings; the longest one is, in particular, the common prefix of
+ * two such suffixes that are adjacent in the suffix array. Among equally long
+ * candidates, the lexicographically smallest is found first, just like the
+ * post-order walks over suffix trees do.
+ *
+ * @param suffixes The suffix array of the concatenation.
+ * @param lcp The longest common prefix array of the concatenation.
+ * @param sep_index The index (0-based) of the separator between both strings.
+ * @param lcs_length The currently longest common prefix length; the length
+ *   of the longest common substring (LCS).
+ * @param lcs_start_index The starting index (1-based) of the LCS.
  */
-std::optional<separator_end_pair> workable_separator_end_symbol_pair(const std::string &first,
-                                                                     const std::string &second) {
-    for (const auto &pair : separator_end_pairs) {
-        if ((first.find(pair.first) == std::string::npos) &&
-            (first.find(pair.second) == std::string::npos) &&
-            (second.find(pair.first) == std::string::npos) &&
-            (second.find(pair.second) == std::string::npos)) {
-            return pair;
+void DutchKBQADSCreate::SuffixTrees::suffix_array_longest_common_substring(const std::vector<std::int32_t> &suffixes,
+                                                                           const std::vector<std::int32_t> &lcp,
+                                                                           int sep_index,
+                                                                           int *lcs_length,
+                                                                           int *lcs_start_index) {
+    for (std::size_t rank = 1; rank < suffixes.size(); rank++) {
+        const std::int32_t preceding = suffixes[rank - 1];
+        const std::int32_t suffix = suffixes[rank];
+        /* The separator occurs once, so no common prefix extends across it. */
+        if ((preceding < sep_index) != (suffix < sep_index) && *lcs_length < lcp[rank]) {
+            *lcs_length = lcp[rank];
+            *lcs_start_index = suffix + 1;
         }
     }
-    return std::nullopt;
+}
+
+/**
+ * @brief Determines all maximal common substrings of at least `min_length`
+ *   code points that the arena-allocated suffix tree `tree` contains.
+ *
+ * A common substring is maximal if it cannot be extended by a code point to
+ * the left or to the right without ceasing to be common. Each such substring
+ * is an internal node that is classified as `FIRST_AND_SECOND`, (1) that has
+ * no child classified as such, and (2) that is not the suffix link of another
+ * node classified as such.
+ *
+ * @param tree The arena-allocated suffix tree, built on the concatenation of
+ *   two strings.
+ * @param sep_end_range The index range that the query string forms, together
+ *   with its separator- and ending character.
+ * @param min_length The minimal length of substrings to return. Strictly
+ *   positive.
+ * @return Per maximal common substring, the index range of one of its
+ *   occurrences in `tree`'s string. 1-based and inclusive. The substrings are
+ *   ordered in the order in which the tree's nodes are classified.
+ */
+std::vector<DutchKBQADSCreate::index_range> DutchKBQADSCreate::SuffixTrees::flat_maximal_common_substrings(
+        const FlatSuffixTree &tree,
+        index_range sep_end_range,
+        int min_length) {
+    if (min_length < 1) {
+        throw std::invalid_argument("The minimal length of maximal common substrings must be strictly positive!");
+    }
+    std::vector<substring_flags> flags(tree.number_of_nodes(), 0);
+    std::vector<index_range> candidates;
+    std::vector<arena_index> candidate_nodes;
+    auto collect = [&] (arena_index visited, int visited_length, int right_ptr) -> void {
+        if ((flags[visited] & substring_type_mask) != FIRST_AND_SECOND || visited == FlatSuffixTree::root) {
+            return;
+        }
+        flags[tree.suffix_link(visited)] |= left_extendable_flag;
+        if ((flags[visited] & common_child_flag) == 0 && visited_length >= min_length) {
+            candidates.emplace_back(right_ptr - visited_length + 1, right_ptr);
+            candidate_nodes.push_back(visited);
+        }
+    };
+    classified_flat_subtree(tree, FlatSuffixTree::root, 0, sep_end_range, flags, collect);
+    /* Suffix links may point to nodes classified earlier, so only filter the
+     * left-extendable candidates out once all nodes are classified. */
+    std::vector<index_range> maximal;
+    for (std::size_t idx = 0; idx < candidates.size(); idx++) {
+        if ((flags[candidate_nodes[idx]] & left_extendable_flag) == 0) {
+            maximal.push_back(candidates[idx]);
+        }
+    }
+    return maximal;
 }
 
 /**
@@ -154,36 +332,250 @@ std::optional<separator_end_pair> workable_separator_end_symbol_pair(const std::
  *
  * @param first The first string.
  * @param second The second string.
+ * @param backend The suffix structure to compute the longest common substring
+ *   with.
  * @return The longest common substring of `first` and `second`. A null value
  *   is returned if `first` and `second` do not share any symbol.
  */
 std::optional<std::string> DutchKBQADSCreate::SuffixTrees::longest_common_substring(const std::string &first,
-                                                                                    const std::string &second) {
-    std::optional<separator_end_pair> sep_end = workable_separator_end_symbol_pair(first, second);
-    if (!sep_end.has_value()) {
-        /* Early exit: Cannot start the Ukkonen suffix tree procedure. */
-        return std::nullopt;
-    }
-    std::string concat = first + sep_end->first + second + sep_end->second;
-    SuffixTree tree(concat);
-    tree.construct();
+                                                                                    const std::string &second,
+                                                                                    LCSBackend backend) {
+    /* Concatenate both strings using sentinels that can't occur in either. */
+    UnicodeString uni_concat(first);
+    uni_concat.append(separator_code_point);
+    uni_concat.append(UnicodeString(second));
+    uni_concat.append(end_code_point);
 
     int max_length, substring_start_idx, sep_idx, end_idx;
-    UnicodeString uni_concat(concat);
     max_length = 0;
     substring_start_idx = 0;
-    sep_idx = uni_concat.index_of_code_point(sep_end->first).value();
-    end_idx = uni_concat.index_of_code_point(sep_end->second).value();
-    state_substring_type(tree.root,
-                         0,
-                         &max_length,
-                         &substring_start_idx,
-                         { sep_idx + 1, end_idx + 1 });
-    if (max_length - 1 >= 0) {
-        UnicodeString lcs = uni_concat.substring(substring_start_idx - 1,
-                                                 substring_start_idx + max_length - 1);
-        return UnicodeString::basic_string_from_unicode_string(lcs);
-    } else {
+    sep_idx = uni_concat.index_of_code_point(separator_code_point).value();
+    end_idx = uni_concat.length - 1;
+    /* The concatenation is moved into the tree, and the longest common
+     * substring is encoded straight from the tree's string: no copies needed. */
+    auto lcs_from = [&max_length, &substring_start_idx] (UnicodeStringView uni_str) -> std::optional<std::string> {
+        if (max_length - 1 >= 0) {
+            return UnicodeString::basic_string_from_unicode_string(
+                uni_str.substring(substring_start_idx - 1, substring_start_idx + max_length - 1)
+            );
+        } else {
+            return std::nullopt;
+        }
+    };
+    switch (backend) {
+        case EXPLICIT_STATE_SUFFIX_TREE: {
+            SuffixTree tree(std::move(uni_concat));
+            tree.construct();
+            state_substring_type(tree.root,
+                                 0,
+                                 &max_length,
+                                 &substring_start_idx,
+                                 { sep_idx + 1, end_idx + 1 });
+            return lcs_from(tree.get_uni_str());
+        }
+        case FLAT_SUFFIX_TREE: {
+            FlatSuffixTree tree(std::move(uni_concat));
+            tree.construct();
+            flat_state_substring_type(tree,
+                                      FlatSuffixTree::root,
+                                      0,
+                                      &max_length,
+                                      &substring_start_idx,
+                                      { sep_idx + 1, end_idx + 1 });
+            return lcs_from(tree.get_uni_str());
+        }
+        case SUFFIX_ARRAY: {
+            SuffixArray suffix_array(std::move(uni_concat));
+            suffix_array.construct();
+            suffix_array_longest_common_substring(suffix_array.get_suffixes(),
+                                                  suffix_array.get_lcp(),
+                                                  sep_idx,
+                                                  &max_length,
+                                                  &substring_start_idx);
+            return lcs_from(suffix_array.get_uni_str());
+        }
+        default:
+            throw std::logic_error(std::string("Reached a non-") +
+                                   "implemented longest common substring backend case!");
+    }
+}
+
+/**
+ * @brief Determines what the longest common substring is between two strings
+ *   `first` and `second`, using the `SUFFIX_ARRAY` backend and this
+ *   workspace's buffers. If there is no commonality, a null value is returned.
+ *
+ * The result is identical to that of `longest_common_substring`.
+ *
+ * @param first The first string.
+ * @param second The second string.
+ * @return The longest common substring of `first` and `second`. A null value
+ *   is returned if `first` and `second` do not share any symbol.
+ */
+std::optional<std::string> LCSWorkspace::longest_common_substring(const std::string &first,
+                                                                  const std::string &second) {
+    this->code_points.clear();
+    UnicodeString::append_utf8_decoded(first, this->code_points);
+    const auto sep_idx = static_cast<int>(this->code_points.size());
+    this->code_points.push_back(separator_code_point);
+    UnicodeString::append_utf8_decoded(second, this->code_points);
+    this->code_points.push_back(end_code_point);
+    if (this->code_points.size() >= static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+        throw std::logic_error(std::string("We currently only support ") +
+                               "strings with a maximal size of " +
+                               std::to_string(std::numeric_limits<int>::max()) +
+                               " code points, inclusively!");
+    }
+    const UnicodeStringView uni_concat(this->code_points.data(), static_cast<int>(this->code_points.size()));
+
+    const std::int32_t max_symbol = ranked_symbols(uni_concat, this->alphabet, this->text);
+    sa_is_suffix_array(this->text, max_symbol, this->suffixes);
+    kasai_lcp_array(this->text, this->suffixes, this->ranks, this->lcp);
+    int max_length = 0;
+    int substring_start_idx = 0;
+    suffix_array_longest_common_substring(this->suffixes, this->lcp, sep_idx, &max_length, &substring_start_idx);
+    if (max_length == 0) {
         return std::nullopt;
     }
+    return UnicodeString::basic_string_from_unicode_string(
+        uni_concat.substring(substring_start_idx - 1, substring_start_idx + max_length - 1)
+    );
+}
+
+/**
+ * @brief Determines the longest common substring of every pair of strings in
+ *   `pairs`.
+ *
+ * The pairs are divided over `threads` workers, each with its own
+ * `LCSWorkspace`. Workers repeatedly claim the next `lcs_chunk_size` pairs, so
+ * that workers that happen to get short pairs simply claim more of them. The
+ * result does not depend on the number of workers.
+ *
+ * @param pairs The pairs of strings.
+ * @param threads The number of threads to compute with. Minimally 1.
+ * @return For each pair of `pairs`, at the same index, the longest common
+ *   substring of its strings, as `longest_common_substring` would return it.
+ */
+std::vector<std::optional<std::string>> DutchKBQADSCreate::SuffixTrees::longest_common_substrings(
+        const std::vector<std::pair<std::string, std::string>> &pairs,
+        int threads) {
+    if (threads < 1) {
+        throw std::invalid_argument(std::string("The number of threads must be at least 1, but is ") +
+                                    std::to_string(threads) +
+                                    ".");
+    }
+    std::vector<std::optional<std::string>> lcs_per_pair(pairs.size());
+    std::atomic<std::size_t> next_idx = 0;
+    auto work = [&pairs, &lcs_per_pair, &next_idx] () -> void {
+        LCSWorkspace workspace;
+        while (true) {
+            const std::size_t chunk_start = next_idx.fetch_add(lcs_chunk_size);
+            if (chunk_start >= pairs.size()) {
+                return;
+            }
+            const std::size_t chunk_end = std::min(chunk_start + lcs_chunk_size, pairs.size());
+            for (std::size_t idx = chunk_start; idx < chunk_end; idx++) {
+                lcs_per_pair[idx] = workspace.longest_common_substring(pairs[idx].first, pairs[idx].second);
+            }
+        }
+    };
+    if (threads == 1) {
+        work();
+        return lcs_per_pair;
+    }
+    std::vector<std::exception_ptr> worker_errors(threads);
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < threads; worker++) {
+        workers.emplace_back([&, worker] () -> void {
+            try {
+                work();
+            } catch (...) {
+                worker_errors[worker] = std::current_exception();
+                next_idx = pairs.size();  /* Make the other workers stop early. */
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (const auto &worker_error : worker_errors) {
+        if (worker_error) {
+            std::rethrow_exception(worker_error);
+        }
+    }
+    return lcs_per_pair;
+}
+
+/**
+ * @brief Determines the longest common substrings between one string, `first`,
+ *   and each of many strings, `others`.
+ *
+ * A suffix automaton is built over `first` only once; afterwards, each string
+ * of `others` takes time linear in its own length. This makes the function
+ * suitable for comparing one question against all labels of its entities and
+ * properties.
+ *
+ * If multiple longest common substrings exist for some pair, the one that
+ * ends first within the string of `others` is selected. Thus, for ties, the
+ * outcome may differ from that of `longest_common_substring`; the length never
+ * does.
+ *
+ * @param first The string to compare against all others.
+ * @param others The other strings.
+ * @return For each string of `others`, at the same index, its longest common
+ *   substring with `first`. A null value is stored if they do not share any
+ *   symbol.
+ */
+std::vector<std::optional<std::string>> DutchKBQADSCreate::SuffixTrees::one_vs_many_longest_common_substrings(
+        const std::string &first,
+        const std::vector<std::string> &others) {
+    const SuffixAutomaton automaton(first);
+    std::vector<std::optional<std::string>> lcs_per_other;
+    lcs_per_other.reserve(others.size());
+    for (const auto &other : others) {
+        lcs_per_other.push_back(automaton.longest_common_substring(other));
+    }
+    return lcs_per_other;
+}
+
+/**
+ * @brief Determines all maximal common substrings between two strings `first`
+ *   and `second` that have at least `min_length` code points.
+ *
+ * See `flat_maximal_common_substrings` for what makes a common substring
+ * maximal. The longest common substring is always among them.
+ *
+ * @param first The first string.
+ * @param second The second string.
+ * @param min_length The minimal length of substrings to return, in code
+ *   points. Strictly positive.
+ * @return The maximal common substrings, longest first. Substrings of equal
+ *   length retain the order in which `flat_maximal_common_substrings` found
+ *   them.
+ */
+std::vector<std::string> DutchKBQADSCreate::SuffixTrees::maximal_common_substrings(const std::string &first,
+                                                                                   const std::string &second,
+                                                                                   int min_length) {
+    UnicodeString uni_concat(first);
+    uni_concat.append(separator_code_point);
+    uni_concat.append(UnicodeString(second));
+    uni_concat.append(end_code_point);
+    const int sep_idx = uni_concat.index_of_code_point(separator_code_point).value();
+    const int end_idx = uni_concat.length - 1;
+    FlatSuffixTree tree(std::move(uni_concat));
+    tree.construct();
+    std::vector<index_range> ranges = flat_maximal_common_substrings(tree,
+                                                                     { sep_idx + 1, end_idx + 1 },
+                                                                     min_length);
+    std::stable_sort(ranges.begin(), ranges.end(), [] (const index_range &a, const index_range &b) -> bool {
+        return a.second - a.first > b.second - b.first;
+    });
+    std::vector<std::string> substrings;
+    substrings.reserve(ranges.size());
+    for (const index_range &range : ranges) {
+        substrings.push_back(UnicodeString::basic_string_from_unicode_string(
+            tree.get_uni_str().substring(range.first - 1, range.second)
+        ));
+    }
+    return substrings;
 }
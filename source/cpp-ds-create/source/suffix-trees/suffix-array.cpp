@@ -0,0 +1,299 @@
+/* Symbols for constructing suffix arrays with longest common prefixes. */
+
+#include <algorithm>
+#include <utility>
+#include "suffix-trees/suffix-array.hpp"
+
+using namespace DutchKBQADSCreate::SuffixTrees;
+
+/**
+ * @brief Replaces the code points of `uni_str` by their ranks among the
+ *   string's distinct code points, which preserves their order.
+ *
+ * SA-IS keeps one bucket per symbol, while code points (and sentinels) span
+ * over a million values; ranks span only as many as the string has distinct
+ * code points.
+ *
+ * @param uni_str The Unicode string to rank the code points of.
+ * @param alphabet The buffer to hold the distinct code points in. Its
+ *   previous contents are discarded.
+ * @param text The output: the ranks, at the indices of their code points. Its
+ *   previous contents are discarded.
+ * @return The largest rank in `text`.
+ */
+std::int32_t DutchKBQADSCreate::SuffixTrees::ranked_symbols(UnicodeStringView uni_str,
+                                                            std::vector<utf8::uint32_t> &alphabet,
+                                                            std::vector<std::int32_t> &text) {
+    alphabet.assign(uni_str.begin(), uni_str.end());
+    std::sort(alphabet.begin(), alphabet.end());
+    alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+    text.clear();
+    for (const utf8::uint32_t code_point : uni_str) {
+        text.push_back(static_cast<std::int32_t>(
+            std::lower_bound(alphabet.begin(), alphabet.end(), code_point) - alphabet.begin()
+        ));
+    }
+    return std::max(static_cast<std::int32_t>(alphabet.size()) - 1, 0);
+}
+
+/**
+ * @brief Determines the suffix array of `text` with the SA-IS algorithm (Nong
+ *   et al., 2009), in time linear in the length of `text`.
+ *
+ * No sentinel needs to terminate `text`: a virtual one, smaller than all
+ * symbols, is assumed. The implementation follows that of the AtCoder Library.
+ *
+ * @param text The string to determine the suffix array of, as a sequence of
+ *   symbols in the range `[0, max_symbol]`.
+ * @param max_symbol The largest symbol that may occur in `text`.
+ * @param suffixes The output: the starting indices of the suffixes of `text`,
+ *   in ascending lexicographical order of the suffixes. Its previous contents
+ *   are discarded, but its capacity is reused.
+ */
+void DutchKBQADSCreate::SuffixTrees::sa_is_suffix_array(const std::vector<std::int32_t> &text,
+                                                        std::int32_t max_symbol,
+                                                        std::vector<std::int32_t> &suffixes) {
+    const auto n = static_cast<std::int32_t>(text.size());
+    suffixes.resize(n);
+    if (n == 0) {
+        return;
+    } else if (n == 1) {
+        suffixes[0] = 0;
+        return;
+    } else if (n == 2) {
+        suffixes[0] = text[0] < text[1] ? 0 : 1;
+        suffixes[1] = 1 - suffixes[0];
+        return;
+    }
+    /* Classify suffixes as S-type (smaller than the next suffix) or L-type. */
+    std::vector<bool> is_s_type(n, false);
+    for (std::int32_t idx = n - 2; idx >= 0; idx--) {
+        is_s_type[idx] = text[idx] == text[idx + 1] ? is_s_type[idx + 1] : text[idx] < text[idx + 1];
+    }
+    /* Per symbol, where its L- and S-type buckets start. */
+    std::vector<std::int32_t> l_bucket_starts(max_symbol + 1, 0);
+    std::vector<std::int32_t> s_bucket_starts(max_symbol + 1, 0);
+    for (std::int32_t idx = 0; idx < n; idx++) {
+        if (!is_s_type[idx]) {
+            s_bucket_starts[text[idx]]++;
+        } else {
+            l_bucket_starts[text[idx] + 1]++;
+        }
+    }
+    for (std::int32_t symbol = 0; symbol <= max_symbol; symbol++) {
+        s_bucket_starts[symbol] += l_bucket_starts[symbol];
+        if (symbol < max_symbol) {
+            l_bucket_starts[symbol + 1] += s_bucket_starts[symbol];
+        }
+    }
+    /* Sorts all suffixes by inducing them from the (sorted) LMS suffixes. */
+    std::vector<std::int32_t> buckets(max_symbol + 1);
+    auto induce = [&] (const std::vector<std::int32_t> &lms) -> void {
+        std::fill(suffixes.begin(), suffixes.end(), -1);
+        std::copy(s_bucket_starts.begin(), s_bucket_starts.end(), buckets.begin());
+        for (const std::int32_t suffix : lms) {
+            if (suffix != n) {
+                suffixes[buckets[text[suffix]]++] = suffix;
+            }
+        }
+        std::copy(l_bucket_starts.begin(), l_bucket_starts.end(), buckets.begin());
+        suffixes[buckets[text[n - 1]]++] = n - 1;
+        for (std::int32_t rank = 0; rank < n; rank++) {
+            const std::int32_t suffix = suffixes[rank];
+            if (suffix >= 1 && !is_s_type[suffix - 1]) {
+                suffixes[buckets[text[suffix - 1]]++] = suffix - 1;
+            }
+        }
+        std::copy(l_bucket_starts.begin(), l_bucket_starts.end(), buckets.begin());
+        for (std::int32_t rank = n - 1; rank >= 0; rank--) {
+            const std::int32_t suffix = suffixes[rank];
+            if (suffix >= 1 && is_s_type[suffix - 1]) {
+                suffixes[--buckets[text[suffix - 1] + 1]] = suffix - 1;
+            }
+        }
+    };
+    /* Locate the leftmost-S-type (LMS) suffixes. */
+    std::vector<std::int32_t> lms_numbers(n + 1, -1);
+    std::vector<std::int32_t> lms;
+    for (std::int32_t idx = 1; idx < n; idx++) {
+        if (!is_s_type[idx - 1] && is_s_type[idx]) {
+            lms_numbers[idx] = static_cast<std::int32_t>(lms.size());
+            lms.push_back(idx);
+        }
+    }
+    const auto m = static_cast<std::int32_t>(lms.size());
+    induce(lms);
+    if (m == 0) {
+        return;
+    }
+    /* Name the LMS substrings by their induced order, and sort the LMS
+     * suffixes by recursing on the string of names if names repeat. */
+    std::vector<std::int32_t> sorted_lms;
+    sorted_lms.reserve(m);
+    for (const std::int32_t suffix : suffixes) {
+        if (lms_numbers[suffix] != -1) {
+            sorted_lms.push_back(suffix);
+        }
+    }
+    std::vector<std::int32_t> reduced_text(m);
+    std::int32_t reduced_max_symbol = 0;
+    reduced_text[lms_numbers[sorted_lms[0]]] = 0;
+    for (std::int32_t idx = 1; idx < m; idx++) {
+        std::int32_t left = sorted_lms[idx - 1];
+        std::int32_t right = sorted_lms[idx];
+        const std::int32_t left_end = lms_numbers[left] + 1 < m ? lms[lms_numbers[left] + 1] : n;
+        const std::int32_t right_end = lms_numbers[right] + 1 < m ? lms[lms_numbers[right] + 1] : n;
+        bool same = true;
+        if (left_end - left != right_end - right) {
+            same = false;
+        } else {
+            while (left < left_end && text[left] == text[right]) {
+                left++;
+                right++;
+            }
+            if (left == n || text[left] != text[right]) {
+                same = false;
+            }
+        }
+        if (!same) {
+            reduced_max_symbol++;
+        }
+        reduced_text[lms_numbers[sorted_lms[idx]]] = reduced_max_symbol;
+    }
+    std::vector<std::int32_t> reduced_suffixes;
+    sa_is_suffix_array(reduced_text, reduced_max_symbol, reduced_suffixes);
+    for (std::int32_t idx = 0; idx < m; idx++) {
+        sorted_lms[idx] = lms[reduced_suffixes[idx]];
+    }
+    induce(sorted_lms);
+}
+
+/**
+ * @brief Determines the longest common prefix (LCP) array of `text` with
+ *   Kasai et al.'s (2001) algorithm, in time linear in the length of `text`.
+ *
+ * @param text The string of which `suffixes` is the suffix array.
+ * @param suffixes The suffix array of `text`.
+ * @param ranks The buffer to hold the inverse of `suffixes` in. Its previous
+ *   contents are discarded.
+ * @param lcp The output: per rank, the length of the longest common prefix of
+ *   the suffixes at that rank and at the rank before it. Zero at rank zero.
+ *   Its previous contents are discarded.
+ */
+void DutchKBQADSCreate::SuffixTrees::kasai_lcp_array(const std::vector<std::int32_t> &text,
+                                                     const std::vector<std::int32_t> &suffixes,
+                                                     std::vector<std::int32_t> &ranks,
+                                                     std::vector<std::int32_t> &lcp) {
+    const auto n = static_cast<std::int32_t>(text.size());
+    ranks.resize(n);
+    for (std::int32_t rank = 0; rank < n; rank++) {
+        ranks[suffixes[rank]] = rank;
+    }
+    lcp.assign(n, 0);
+    /* Dropping a suffix's first symbol shortens its LCP by at most one, so
+     * `common` never decreases by more than one per suffix. */
+    std::int32_t common = 0;
+    for (std::int32_t suffix = 0; suffix < n; suffix++) {
+        if (ranks[suffix] == 0) {
+            common = 0;
+            continue;
+        }
+        const std::int32_t preceding = suffixes[ranks[suffix] - 1];
+        while (suffix + common < n && preceding + common < n && text[suffix + common] == text[preceding + common]) {
+            common++;
+        }
+        lcp[ranks[suffix]] = common;
+        if (common > 0) {
+            common--;
+        }
+    }
+}
+
+/**
+ * @brief Constructs a suffix array. Call `construct` to sort the suffixes.
+ *
+ * @param str A UTF8-encoded string from which to build the suffix array.
+ */
+SuffixArray::SuffixArray(const std::string &str) : SuffixArray(UnicodeString(str)) {}
+
+/**
+ * @brief Constructs a suffix array. Call `construct` to sort the suffixes.
+ *
+ * @param uni_str A UTF32-encoded Unicode string from which to build the suffix
+ *   array. It may contain sentinel code points outside the Unicode code
+ *   space.
+ */
+SuffixArray::SuffixArray(UnicodeString uni_str) : uni_str(std::move(uni_str)) {}
+
+/**
+ * @brief Sorts the suffixes of the string, and determines their longest common
+ *   prefixes.
+ */
+void SuffixArray::construct() {
+    std::vector<utf8::uint32_t> alphabet;
+    std::vector<std::int32_t> text;
+    std::vector<std::int32_t> ranks;
+    const std::int32_t max_symbol = ranked_symbols(this->uni_str, alphabet, text);
+    sa_is_suffix_array(text, max_symbol, this->suffixes);
+    kasai_lcp_array(text, this->suffixes, ranks, this->lcp);
+}
+
+/**
+ * @brief Returns a view of the Unicode string this suffix array is built on.
+ *
+ * @return The view. It is valid for as long as this suffix array lives.
+ */
+UnicodeStringView SuffixArray::get_uni_str() const {
+    return this->uni_str;
+}
+
+/**
+ * @brief Returns the starting indices (0-based) of the string's suffixes, in
+ *   ascending lexicographical order of the suffixes.
+ *
+ * @return The suffix array.
+ */
+const std::vector<std::int32_t> &SuffixArray::get_suffixes() const {
+    return this->suffixes;
+}
+
+/**
+ * @brief Returns, per rank, the length of the longest common prefix of the
+ *   suffixes at that rank and at the rank before it.
+ *
+ * @return The longest common prefix array.
+ */
+const std::vector<std::int32_t> &SuffixArray::get_lcp() const {
+    return this->lcp;
+}
+
+/**
+ * @brief Returns the starting index (0-based) of the suffix with rank `rank`.
+ *
+ * @param rank The rank of the suffix, in ascending lexicographical order.
+ * @return The starting index.
+ */
+std::int32_t SuffixArray::suffix_at(int rank) const {
+    return this->suffixes.at(rank);
+}
+
+/**
+ * @brief Returns the length of the longest common prefix of the suffixes with
+ *   ranks `rank - 1` and `rank`.
+ *
+ * @param rank The rank of the latter suffix. Zero yields zero.
+ * @return The length, in code points.
+ */
+std::int32_t SuffixArray::lcp_at(int rank) const {
+    return this->lcp.at(rank);
+}
+
+/**
+ * @brief Returns the number of suffixes in this suffix array. Zero if it has
+ *   not been constructed yet.
+ *
+ * @return The number.
+ */
+int SuffixArray::number_of_suffixes() const {
+    return static_cast<int>(this->suffixes.size());
+}
@@ -0,0 +1,133 @@
+/* Symbols for constructing suffix automata. */
+
+#include "suffix-trees/suffix-automaton.hpp"
+
+using namespace DutchKBQADSCreate::SuffixTrees;
+
+/**
+ * @brief Constructs a suffix automaton for a UTF8-encoded string.
+ *
+ * @param str The string.
+ */
+SuffixAutomaton::SuffixAutomaton(const std::string &str) : SuffixAutomaton(UnicodeString(str)) {}
+
+/**
+ * @brief Constructs a suffix automaton for a UTF32-encoded Unicode string.
+ *
+ * @param uni_str The string.
+ */
+SuffixAutomaton::SuffixAutomaton(UnicodeStringView uni_str) {
+    /* A suffix automaton over `n` code points has at most `2n - 1` states (for
+     * `n` at least 2). Reserve these up-front. */
+    this->states.reserve(2 * static_cast<std::size_t>(uni_str.length) + 1);
+    this->states.push_back({ 0, -1, {} });
+    this->last = 0;
+    for (int idx = 0; idx < uni_str.length; idx++) {
+        this->extend(uni_str.code_point_at(idx));
+    }
+}
+
+/**
+ * @brief Extends the automaton's string by one code point.
+ *
+ * This is the online construction step of Blumer et al. (1985). It takes
+ * amortised constant time (with respect to the string's length).
+ *
+ * @param code_point The code point to append.
+ */
+void SuffixAutomaton::extend(utf8::uint32_t code_point) {
+    const int current = static_cast<int>(this->states.size());
+    this->states.push_back({ this->states[this->last].length + 1, -1, {} });
+    int state = this->last;
+    while (state != -1 && this->states[state].transitions.count(code_point) == 0) {
+        this->states[state].transitions.insert({ code_point, current });
+        state = this->states[state].suffix_link;
+    }
+    if (state == -1) {
+        this->states[current].suffix_link = 0;
+    } else {
+        const int next = this->states[state].transitions.at(code_point);
+        if (this->states[state].length + 1 == this->states[next].length) {
+            this->states[current].suffix_link = next;
+        } else {
+            /* The transition is not 'solid': split off a clone of `next` that
+             * represents only the shorter substrings. */
+            const int clone = static_cast<int>(this->states.size());
+            this->states.push_back({ this->states[state].length + 1,
+                                     this->states[next].suffix_link,
+                                     this->states[next].transitions });
+            while (state != -1 && this->states[state].transitions.at(code_point) == next) {
+                this->states[state].transitions[code_point] = clone;
+                state = this->states[state].suffix_link;
+            }
+            this->states[next].suffix_link = clone;
+            this->states[current].suffix_link = clone;
+        }
+    }
+    this->last = current;
+}
+
+/**
+ * @brief Determines the longest common substring between `other` and this
+ *   automaton's string, in time linear in the length of `other`.
+ *
+ * If multiple longest common substrings exist, the one that ends first within
+ * `other` is selected.
+ *
+ * @param other The string to match against this automaton.
+ * @return The length and ending index (within `other`) of the longest common
+ *   substring.
+ */
+CommonSubstringMatch SuffixAutomaton::longest_common_substring_match(UnicodeStringView other) const {
+    CommonSubstringMatch best { 0, -1 };
+    int state = 0;
+    int length = 0;
+    for (int idx = 0; idx < other.length; idx++) {
+        const utf8::uint32_t code_point = other.code_point_at(idx);
+        /* Shorten the current match until it can be extended by `code_point`. */
+        while (state != 0 && this->states[state].transitions.count(code_point) == 0) {
+            state = this->states[state].suffix_link;
+            length = this->states[state].length;
+        }
+        const auto it = this->states[state].transitions.find(code_point);
+        if (it != this->states[state].transitions.end()) {
+            state = it->second;
+            length++;
+        } else {
+            state = 0;
+            length = 0;
+        }
+        if (length > best.length) {
+            best = { length, idx };
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Returns the longest common substring between `other` and this
+ *   automaton's string, or null if they do not share any code point.
+ *
+ * @param other The string to match against this automaton.
+ * @return The longest common substring.
+ */
+std::optional<std::string> SuffixAutomaton::longest_common_substring(const std::string &other) const {
+    UnicodeString uni_other(other);
+    const CommonSubstringMatch match = this->longest_common_substring_match(uni_other);
+    if (match.length == 0) {
+        return std::nullopt;
+    }
+    return UnicodeString::basic_string_from_unicode_string(
+        uni_other.substring(match.end_index - match.length + 1, match.end_index + 1)
+    );
+}
+
+/**
+ * @brief Returns the number of states of this suffix automaton, including its
+ *   initial state.
+ *
+ * @return The number.
+ */
+int SuffixAutomaton::number_of_states() const {
+    return static_cast<int>(this->states.size());
+}
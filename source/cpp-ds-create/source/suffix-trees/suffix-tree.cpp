@@ -41,7 +41,7 @@ ReferencePair::ReferencePair(ExplicitState *state, explicit_left_right_pointer_p
  * @return The canonised reference pair. Note: only the left pointer is
  *   returned for the reference pair's second entry.
  */
-canon_reference_pair ReferencePair::canonised(UnicodeString uni_str) {
+canon_reference_pair ReferencePair::canonised(UnicodeStringView uni_str) {
     ExplicitState *out_state;
     int out_left_ptr;
     if (this->right_ptr < this->left_ptr) {
@@ -71,11 +71,18 @@ canon_reference_pair ReferencePair::canonised(UnicodeString uni_str) {
 /**
  * @brief Constructs a Ukkonen suffix tree.
  *
- * @param str A UTF32-encoded Unicode string from which to build the tree.
+ * @param str A UTF8-encoded string from which to build the tree.
  */
-SuffixTree::SuffixTree(const std::string &str) : uni_str(str) {
-    this->uni_str = UnicodeString(str);
-    this->auxiliary = std::make_unique<AuxiliaryState>(UnicodeString(str));
+SuffixTree::SuffixTree(const std::string &str) : SuffixTree(UnicodeString(str)) {}
+
+/**
+ * @brief Constructs a Ukkonen suffix tree.
+ *
+ * @param uni_str A UTF32-encoded Unicode string from which to build the tree.
+ *   It may contain sentinel code points outside the Unicode code space.
+ */
+SuffixTree::SuffixTree(UnicodeString uni_str) : uni_str(std::move(uni_str)) {
+    this->auxiliary = std::make_unique<AuxiliaryState>(this->uni_str);
     this->root = this->auxiliary->state_transition_if_present(this->uni_str.code_point_at(0)).value();
     this->leaf_right_ptr = std::make_unique<int>(0);
 }
@@ -192,6 +199,16 @@ void SuffixTree::construct() {
 /**
  * @brief Prints this Ukkonen suffix tree to standard output.
  */
+/**
+ * @brief Returns a view into the UTF32-encoded Unicode string on which this
+ *   suffix tree is based. The view is valid for as long as the tree is.
+ *
+ * @return The view.
+ */
+UnicodeStringView SuffixTree::get_uni_str() const {
+    return this->uni_str;
+}
+
 void SuffixTree::print() {
     std::cout << "SUFFIX TREE" << std::endl;
     this->auxiliary->print(this->uni_str, 0);
@@ -1,10 +1,211 @@
 /* Symbols for working with encoded Unicode strings. */
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include "suffix-trees/unicode-string.hpp"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define UNICODE_STRING_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define UNICODE_STRING_NEON
+#endif
 
 using namespace DutchKBQADSCreate::SuffixTrees;
 
+/**
+ * @brief The number of bytes that the ASCII fast path of UTF8 decoding checks
+ *   and widens at once.
+ */
+const std::size_t ascii_block_size = 16;
+
+/**
+ * @brief Widens the `ascii_block_size` bytes at `bytes` to code points at
+ *   `code_points`, provided that they are all ASCII.
+ *
+ * Uses SSE2 on x86-64 and NEON on AArch64, where both are always available,
+ * and a word-at-a-time check elsewhere.
+ *
+ * @param bytes The bytes to widen.
+ * @param code_points Room for `ascii_block_size` code points.
+ * @return Whether all bytes are ASCII, and thus were widened.
+ */
+static bool widened_ascii_block(const unsigned char *bytes, utf8::uint32_t *code_points) {
+#if defined(UNICODE_STRING_SSE2)
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes));
+    if (_mm_movemask_epi8(block) != 0) {
+        return false;  /* Some byte has its high bit set. */
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low = _mm_unpacklo_epi8(block, zero);
+    const __m128i high = _mm_unpackhi_epi8(block, zero);
+    auto *out = reinterpret_cast<__m128i *>(code_points);
+    _mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+    return true;
+#elif defined(UNICODE_STRING_NEON)
+    const uint8x16_t block = vld1q_u8(bytes);
+    if (vmaxvq_u8(block) >= 0x80) {
+        return false;
+    }
+    const uint16x8_t low = vmovl_u8(vget_low_u8(block));
+    const uint16x8_t high = vmovl_u8(vget_high_u8(block));
+    vst1q_u32(code_points, vmovl_u16(vget_low_u16(low)));
+    vst1q_u32(code_points + 4, vmovl_u16(vget_high_u16(low)));
+    vst1q_u32(code_points + 8, vmovl_u16(vget_low_u16(high)));
+    vst1q_u32(code_points + 12, vmovl_u16(vget_high_u16(high)));
+    return true;
+#else
+    std::uint64_t words[ascii_block_size / sizeof(std::uint64_t)];
+    std::memcpy(words, bytes, ascii_block_size);
+    std::uint64_t high_bits = 0;
+    for (const std::uint64_t word : words) {
+        high_bits |= word & 0x8080808080808080u;
+    }
+    if (high_bits != 0) {
+        return false;
+    }
+    for (std::size_t idx = 0; idx < ascii_block_size; idx++) {
+        code_points[idx] = bytes[idx];
+    }
+    return true;
+#endif
+}
+
+/**
+ * @brief Decodes the UTF8-encoded code point that starts at `bytes`, and
+ *   validates it along the way.
+ *
+ * Like `utf8::is_valid`, this rejects stray continuation bytes, truncated
+ * sequences, overlong encodings, surrogates, and code points beyond U+10FFFF.
+ *
+ * @param bytes The bytes to decode from.
+ * @param available The number of bytes at `bytes`. Minimally 1.
+ * @param code_point The code point to decode into.
+ * @return The number of bytes that encode the code point, or 0 if these bytes
+ *   are not a properly UTF8-encoded code point.
+ */
+static std::size_t decoded_code_point(const unsigned char *bytes, std::size_t available, utf8::uint32_t &code_point) {
+    const unsigned char lead = bytes[0];
+    std::size_t length;
+    utf8::uint32_t minimum;
+    if (lead < 0x80) {
+        code_point = lead;
+        return 1;
+    } else if (lead < 0xc2) {
+        return 0;  /* A continuation byte, or the start of an overlong encoding. */
+    } else if (lead < 0xe0) {
+        length = 2;
+        code_point = lead & 0x1fu;
+        minimum = 0x80;
+    } else if (lead < 0xf0) {
+        length = 3;
+        code_point = lead & 0x0fu;
+        minimum = 0x800;
+    } else if (lead < 0xf5) {
+        length = 4;
+        code_point = lead & 0x07u;
+        minimum = 0x10000;
+    } else {
+        return 0;
+    }
+    if (available < length) {
+        return 0;
+    }
+    for (std::size_t idx = 1; idx < length; idx++) {
+        if ((bytes[idx] & 0xc0u) != 0x80) {
+            return 0;
+        }
+        code_point = (code_point << 6) | (bytes[idx] & 0x3fu);
+    }
+    if (code_point < minimum || code_point > 0x10ffff || (code_point >= 0xd800 && code_point <= 0xdfff)) {
+        return 0;
+    }
+    return length;
+}
+
+/**
+ * @brief Constructs a view into a sequence of UTF32-encoded code points.
+ *
+ * @param code_points The first code point to view.
+ * @param length The number of code points to view.
+ */
+UnicodeStringView::UnicodeStringView(const utf8::uint32_t *code_points, int length) {
+    this->cp = code_points;
+    this->length = length;
+}
+
+/**
+ * @brief Constructs a view into all code points of a UTF32-encoded Unicode
+ *   string. The code points are not copied.
+ *
+ * @param uni_str The Unicode string to view.
+ */
+UnicodeStringView::UnicodeStringView(const UnicodeString &uni_str) {
+    this->cp = uni_str.data();
+    this->length = uni_str.length;
+}
+
+/**
+ * @brief Returns a view into a substring of the viewed code points.
+ *
+ * @param start_index The starting index of the substring. Inclusive.
+ * @param end_index The ending index of the substring. Exclusive.
+ * @return The view into the substring.
+ */
+UnicodeStringView UnicodeStringView::substring(int start_index, int end_index) const {
+    return { this->cp + start_index, end_index - start_index };
+}
+
+/**
+ * @brief Returns the UTF32-encoded code point at the requested `index`.
+ *
+ * @param index The index.
+ * @return The code point.
+ */
+utf8::uint32_t UnicodeStringView::code_point_at(int index) const {
+    return this->cp[index];
+}
+
+/**
+ * @brief Returns the index of the first occurrence of a UTF32-encoded Unicode
+ *   code point, if it occurs in the viewed code points at all.
+ *
+ * @param code_point The code point to search for.
+ * @return If at least one occurrence of `code_point` exists, the index of the
+ *   first occurrence of `code_point`. Otherwise, the C++ null value.
+ */
+std::optional<int> UnicodeStringView::index_of_code_point(utf8::uint32_t code_point) const {
+    const utf8::uint32_t *it = std::find(this->begin(), this->end(), code_point);
+    if (it != this->end()) {
+        return static_cast<int>(std::distance(this->begin(), it));
+    } else {
+        return std::nullopt;
+    }
+}
+
+/**
+ * @brief Returns a pointer to the first viewed code point.
+ *
+ * @return The pointer.
+ */
+const utf8::uint32_t *UnicodeStringView::begin() const {
+    return this->cp;
+}
+
+/**
+ * @brief Returns a pointer just past the last viewed code point.
+ *
+ * @return The pointer.
+ */
+const utf8::uint32_t *UnicodeStringView::end() const {
+    return this->cp + this->length;
+}
+
 /**
  * @brief Checks whether the UTF32-encoded Unicode string has a number of
  *   code points that is not excessive. Otherwise, it throws a
@@ -24,20 +225,47 @@ void UnicodeString::ensure_unicode_string_is_within_length_limit() {
  *
  * @param str The string to construct from.
  */
-UnicodeString::UnicodeString(std::string str) {
-    if (!utf8::is_valid(str.begin(), str.end())) {
-        throw std::logic_error("String \"" + str + "\" is not properly UTF8-encoded!");
-    }
+UnicodeString::UnicodeString(const std::string &str) {
     this->cp = {};
-    utf8::iterator<std::string::const_iterator> it(str.begin(), str.begin(), str.end());
-    utf8::iterator<std::string::const_iterator> end_it(str.end(), str.begin(), str.end());
-    for (; it != end_it; ++it) {
-        this->cp.push_back(*it);
-    }
+    UnicodeString::append_utf8_decoded(str, this->cp);
     this->ensure_unicode_string_is_within_length_limit();
     this->length = static_cast<int>(this->cp.size());
 }
 
+/**
+ * @brief Decodes the UTF8-encoded string `str`, and appends its code points to
+ *   `code_points`.
+ *
+ * This lets callers decode into a buffer that they reuse, instead of into a
+ * fresh `UnicodeString`. Decoding and validation take a single pass, which
+ * widens runs of ASCII a block at a time.
+ *
+ * @param str The string to decode.
+ * @param code_points The code points to append to.
+ */
+void UnicodeString::append_utf8_decoded(const std::string &str, std::vector<utf8::uint32_t> &code_points) {
+    const std::size_t offset = code_points.size();
+    code_points.resize(offset + str.size());  /* Every byte decodes to at most one code point. */
+    const auto *bytes = reinterpret_cast<const unsigned char *>(str.data());
+    utf8::uint32_t *out = code_points.data() + offset;
+    std::size_t idx = 0;
+    while (idx < str.size()) {
+        if (str.size() - idx >= ascii_block_size && widened_ascii_block(bytes + idx, out)) {
+            idx += ascii_block_size;
+            out += ascii_block_size;
+            continue;
+        }
+        const std::size_t length = decoded_code_point(bytes + idx, str.size() - idx, *out);
+        if (length == 0) {
+            code_points.resize(offset);
+            throw std::logic_error("String \"" + str + "\" is not properly UTF8-encoded!");
+        }
+        idx += length;
+        out++;
+    }
+    code_points.resize(static_cast<std::size_t>(out - code_points.data()));
+}
+
 /**
  * @brief Constructs a UTF32-encoded Unicode string from a sequence of
  *   individual UTF32-encoded code points.
@@ -51,21 +279,54 @@ UnicodeString::UnicodeString(const std::vector<utf8::uint32_t> &code_points) {
 }
 
 /**
- * @brief Constructs a substring of the calling UTF32-encoded Unicode string.
+ * @brief Constructs a UTF32-encoded Unicode string by copying the code points
+ *   of a view.
+ *
+ * @param view The view to copy the code points of.
+ */
+UnicodeString::UnicodeString(UnicodeStringView view) {
+    this->cp = std::vector<utf8::uint32_t>(view.begin(), view.end());
+    ensure_unicode_string_is_within_length_limit();
+    this->length = static_cast<int>(this->cp.size());
+}
+
+/**
+ * @brief Appends a single UTF32-encoded code point to the end of this Unicode
+ *   string.
+ *
+ * The code point is not validated, so code points outside the Unicode code
+ * space may be appended. This is useful for appending sentinel symbols.
+ *
+ * @param code_point The code point to append.
+ */
+void UnicodeString::append(utf8::uint32_t code_point) {
+    this->cp.push_back(code_point);
+    this->ensure_unicode_string_is_within_length_limit();
+    this->length = static_cast<int>(this->cp.size());
+}
+
+/**
+ * @brief Appends all code points of `other` to the end of this Unicode string.
  *
- * This method does not simply return a view into the already-existent 'parent'
- * Unicode string; it creates a wholly new UTF32-encoded string. Thus, it is
- * not very memory-efficient.
+ * @param other The code points to append.
+ */
+void UnicodeString::append(UnicodeStringView other) {
+    this->cp.insert(this->cp.end(), other.begin(), other.end());
+    this->ensure_unicode_string_is_within_length_limit();
+    this->length = static_cast<int>(this->cp.size());
+}
+
+/**
+ * @brief Returns a view into a substring of the calling UTF32-encoded Unicode
+ *   string. No code points are copied.
  *
  * @param start_index The starting index of the substring. Inclusive.
  * @param end_index The ending index of the substring. Exclusive.
- * @return The substring.
+ * @return The view into the substring. It is invalidated once this string is
+ *   modified or destructed.
  */
-UnicodeString UnicodeString::substring(int start_index, int end_index) {
-    std::vector<utf8::uint32_t> substring_cp(this->cp.begin() + start_index,
-                                             this->cp.begin() + end_index,
-                                             this->cp.get_allocator());
-    return UnicodeString(substring_cp);
+UnicodeStringView UnicodeString::substring(int start_index, int end_index) const {
+    return UnicodeStringView(*this).substring(start_index, end_index);
 }
 
 /**
@@ -74,7 +335,7 @@ UnicodeString UnicodeString::substring(int start_index, int end_index) {
  * @param index The index.
  * @return The code point.
  */
-utf8::uint32_t UnicodeString::code_point_at(int index) {
+utf8::uint32_t UnicodeString::code_point_at(int index) const {
     return this->cp[index];
 }
 
@@ -87,25 +348,43 @@ utf8::uint32_t UnicodeString::code_point_at(int index) {
  *   the index of the first occurrence of `code_point`. Otherwise, the C++ null
  *   value.
  */
-std::optional<int> UnicodeString::index_of_code_point(utf8::uint32_t code_point) {
-    auto it = std::find(this->cp.begin(), this->cp.end(), code_point);
-    if (it != this->cp.end()) {
-        return std::distance(this->cp.begin(), it);
-    } else {
-        return std::nullopt;
-    }
+std::optional<int> UnicodeString::index_of_code_point(utf8::uint32_t code_point) const {
+    return UnicodeStringView(*this).index_of_code_point(code_point);
+}
+
+/**
+ * @brief Returns a pointer to the first code point of this Unicode string.
+ *
+ * @return The pointer.
+ */
+const utf8::uint32_t *UnicodeString::data() const {
+    return this->cp.data();
 }
 
 /**
  * @brief Returns a basic string made out of C-style `char`s, based on a
  *   UTF32-encoded Unicode string.
  *
+ * The string is sized up front, so that encoding does not reallocate it.
+ *
  * @param uni_str The UTF32-encoded Unicode string.
  * @return The basic string.
  */
-std::basic_string<char> UnicodeString::basic_string_from_unicode_string(UnicodeString uni_str) {
-    std::u32string utf_32_str(uni_str.cp.begin(), uni_str.cp.end(), uni_str.cp.get_allocator());
-    return { utf8::utf32to8(utf_32_str) };
+std::basic_string<char> UnicodeString::basic_string_from_unicode_string(UnicodeStringView uni_str) {
+    std::size_t encoded_length = 0;
+    for (const utf8::uint32_t code_point : uni_str) {
+        encoded_length += code_point < 0x80 ? 1 : code_point < 0x800 ? 2 : code_point < 0x10000 ? 3 : 4;
+    }
+    std::string str(encoded_length, '\0');
+    char *out = str.data();
+    for (const utf8::uint32_t code_point : uni_str) {
+        if (code_point < 0x80) {
+            *out++ = static_cast<char>(code_point);
+        } else {
+            out = utf8::append(code_point, out);
+        }
+    }
+    return str;
 }
 
 /**
@@ -116,8 +395,9 @@ std::basic_string<char> UnicodeString::basic_string_from_unicode_string(UnicodeS
  * @return The basic string.
  */
 std::basic_string<char> UnicodeString::basic_string_from_unicode_code_point(utf8::uint32_t code_point) {
-    std::u32string utf_32_str({ code_point });
-    return { utf8::utf32to8(utf_32_str) };
+    std::string str;
+    utf8::append(code_point, std::back_inserter(str));
+    return str;
 }
 
 /**
@@ -126,7 +406,7 @@ std::basic_string<char> UnicodeString::basic_string_from_unicode_code_point(utf8
  *
  * @return The unique code points.
  */
-std::set<utf8::uint32_t> UnicodeString::unique_code_points() {
+std::set<utf8::uint32_t> UnicodeString::unique_code_points() const {
     std::set<utf8::uint32_t> code_points{};
     auto add_to_code_points = [&code_points] (const utf8::uint32_t &code_point) -> void {
         code_points.insert(code_point);
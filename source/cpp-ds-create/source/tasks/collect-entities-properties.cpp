@@ -1,45 +1,40 @@
 /* Symbols for relating LC-QuAD 2.0 questions to WikiData entities and properties. */
 
-#include <regex>
+#include <algorithm>
+#include <optional>
 #include <set>
+#include <utility>
+#include "caching/binary-sidecar.hpp"
 #include "tasks/collect-entities-properties.hpp"
+#include "tracing/tracer.hpp"
 #include "utilities.hpp"
 
 using namespace DutchKBQADSCreate;
 
-const char *wikidata_ent_prp_regex = "[QP][0-9]+";
-
 /**
  * @brief Returns the entities and properties discoverable in `question`.
  *
  * @param question The LC-QuAD 2.0 question to collect entities and properties
  *   for.
- * @return The collected WikiData entities and properties.
+ * @return The collected WikiData entities and properties, sorted and without
+ *   duplicates.
  */
-std::set<std::string> entities_and_properties_of_question(const Json::Value &question) {
-    const std::string sparql = question["sparql_wikidata"].asString();
-    std::set<std::string> s;
-    const std::regex ent_prp_query(wikidata_ent_prp_regex);
-    for (std::sregex_iterator it(sparql.begin(),
-                              sparql.end(),
-                              ent_prp_query);
-         it != std::sregex_iterator();
-         ++it) {
-        s.insert(it->str());
-    }
-    return s;
+std::vector<WikiData::symbol_id> entities_and_properties_of_question(const Json::Value &question) {
+    return WikiData::symbol_ids_in_sparql(question["sparql_wikidata"].asString());
 }
 
 /**
  * @brief Returns a mapping from questions in `ds_split` to WikiData entities
  *   and properties discovered in those questions' SPARQL answer formulations.
  *
- * @param ds_split The LC-QuAD 2.0 dataset split to make a mapping of.
+ * @param ds_split A reader over the questions of the LC-QuAD 2.0 dataset split
+ *   to make a mapping of. The questions are read one at a time.
  * @return The map.
  */
-q_ent_prp_map DutchKBQADSCreate::question_entities_properties_map(const Json::Value &ds_split) {
+q_ent_prp_map DutchKBQADSCreate::question_entities_properties_map(JsonRecordReader &ds_split) {
     q_ent_prp_map m;
-    for (const auto &question : ds_split) {
+    Json::Value question;
+    while (ds_split.next(question)) {
         const int uid = question["uid"].asInt();
         const auto ent_prp = entities_and_properties_of_question(question);
         m.insert({ uid, ent_prp });
@@ -47,27 +42,6 @@ q_ent_prp_map DutchKBQADSCreate::question_entities_properties_map(const Json::Va
     return m;
 }
 
-/**
- * @brief Returns the question-to-entities-and-properties map, but converted to
- *   a JSON value.
- *
- * @param m The original question-to-entities-and-properties map.
- * @return The map, but converted to a JSON object.
- */
-Json::Value json_from_question_entities_properties_map(const q_ent_prp_map &m) {
-    Json::Value json;
-    for (const auto &q_ent_prp_pair : m) {
-        /* First, add all entities and properties to a JSON array... */
-        Json::Value ent_prp_array = Json::arrayValue;
-        for (const auto &ent_or_prp : q_ent_prp_pair.second) {
-            ent_prp_array.append(ent_or_prp);
-        }
-        /* ...and second, relate this array to a question UID. */
-        json[std::to_string(q_ent_prp_pair.first)] = ent_prp_array;
-    }
-    return json;
-}
-
 /**
  * @brief Returns the name of the targeted questions-to-entities-and-properties
  *   map.
@@ -82,6 +56,11 @@ std::string question_entities_properties_map_file_name(const LCQuADSplit &split)
 /**
  * @brief Saves the question-to-entities-and-properties map `m` to disk.
  *
+ * The file is the same as when it was built as a whole `Json::Value`: the
+ * question UIDs are ordered as strings, and the entities and properties of
+ * each question are ordered by their textual forms (see
+ * `WikiData::textually_precedes`).
+ *
  * @param m The map to save to disk. The file will be saved in the project
  *   root's `resources` subdirectory.
  * @param split The LC-QuAD 2.0 dataset split on which `m` is based. Will
@@ -89,11 +68,27 @@ std::string question_entities_properties_map_file_name(const LCQuADSplit &split)
  */
 void DutchKBQADSCreate::save_question_entities_properties_map(const q_ent_prp_map &m,
                                                               const LCQuADSplit &split) {
+    std::vector<std::pair<std::string, const std::vector<WikiData::symbol_id> *>> members;
+    members.reserve(m.size());
+    for (const auto &q_ent_prp_pair : m) {
+        members.emplace_back(std::to_string(q_ent_prp_pair.first), &q_ent_prp_pair.second);
+    }
+    std::sort(members.begin(), members.end());
     create_directory_if_absent(supplements_dir);
-    Json::Value json = json_from_question_entities_properties_map(m);
-    save_json_to_dataset_file(json,
-                              supplements_dir /
-                              question_entities_properties_map_file_name(split));
+    JsonRecordWriter writer(supplements_dir / question_entities_properties_map_file_name(split),
+                            JsonContainerType::JSON_OBJECT);
+    for (const auto &[uid, ent_prp] : members) {
+        /* First, add all entities and properties to a JSON array... */
+        std::vector<WikiData::symbol_id> textual_ent_prp = *ent_prp;
+        std::sort(textual_ent_prp.begin(), textual_ent_prp.end(), WikiData::textually_precedes);
+        Json::Value ent_prp_array = Json::arrayValue;
+        for (const auto &ent_or_prp : textual_ent_prp) {
+            ent_prp_array.append(WikiData::string_from_symbol_id(ent_or_prp));
+        }
+        /* ...and second, relate this array to a question UID. */
+        writer.write(uid, ent_prp_array);
+    }
+    writer.close();
 }
 
 /**
@@ -108,23 +103,110 @@ Json::Value DutchKBQADSCreate::loaded_json_question_entities_properties_map(cons
                                          question_entities_properties_map_file_name(split));
 }
 
+/**
+ * @brief Returns the questions-to-entities-and-properties map stored in the
+ *   binary sidecar `sidecar`.
+ *
+ * @param sidecar The sidecar, of which the header has already been read.
+ * @return The map.
+ */
+q_ent_prp_map question_entities_properties_map_from_sidecar(Caching::SidecarReader &sidecar) {
+    const std::vector<std::int32_t> uids = sidecar.read_section<std::int32_t>();
+    const std::vector<std::uint32_t> offsets = sidecar.read_section<std::uint32_t>();
+    const std::vector<WikiData::symbol_id> ids = sidecar.read_section<WikiData::symbol_id>();
+    if (offsets.size() != uids.size() + 1 || offsets.back() != ids.size()) {
+        throw std::runtime_error("A question-to-entities-and-properties sidecar is malformed.");
+    }
+    q_ent_prp_map m;
+    for (std::size_t idx = 0; idx < uids.size(); idx++) {
+        /* The UIDs are stored in ascending order, so every insertion is at the end. */
+        m.emplace_hint(m.end(), uids[idx], std::vector<WikiData::symbol_id>(ids.begin() + offsets[idx],
+                                                                             ids.begin() + offsets[idx + 1]));
+    }
+    return m;
+}
+
+/**
+ * @brief Stores the questions-to-entities-and-properties map `m` in a binary
+ *   sidecar of the file `source`: the sorted question UIDs, followed by the
+ *   entities and properties of all questions in compressed sparse row form.
+ *
+ * @param m The map.
+ * @param source The path of the JSON file that `m` was loaded from.
+ * @param fingerprint The fingerprint that `source` had before `m` was loaded
+ *   from it.
+ */
+void save_question_entities_properties_map_sidecar(const q_ent_prp_map &m,
+                                                   const fs::path &source,
+                                                   const Caching::SourceFingerprint &fingerprint) {
+    std::vector<std::int32_t> uids;
+    std::vector<std::uint32_t> offsets;
+    std::vector<WikiData::symbol_id> ids;
+    uids.reserve(m.size());
+    offsets.reserve(m.size() + 1);
+    for (const auto &q_ent_prp_pair : m) {
+        uids.push_back(q_ent_prp_pair.first);
+        offsets.push_back(static_cast<std::uint32_t>(ids.size()));
+        ids.insert(ids.end(), q_ent_prp_pair.second.begin(), q_ent_prp_pair.second.end());
+    }
+    offsets.push_back(static_cast<std::uint32_t>(ids.size()));
+    Caching::SidecarWriter writer(Caching::sidecar_path_for(source),
+                                  Caching::SidecarKind::QUESTION_ENTITIES_PROPERTIES_MAP,
+                                  fingerprint);
+    writer.write_section(uids);
+    writer.write_section(offsets);
+    writer.write_section(ids);
+    writer.commit();
+}
+
 /**
  * @brief Returns the questions-to-entities-and-properties map as a C++ map
  *   loaded from disk.
  *
+ * If `use_binary_cache` is set, the map is read from the binary sidecar of the
+ * map's JSON file instead, provided that the sidecar is up-to-date. If it is
+ * not, the JSON file is parsed, and the sidecar is (re)written for later runs,
+ * unless the JSON file changed while it was parsed.
+ *
  * @param split The LC-QuAD 2.0 dataset split to load the map of.
+ * @param use_binary_cache Whether to read and maintain the binary sidecar.
  * @return The map, represented as a C++ map.
  */
-q_ent_prp_map DutchKBQADSCreate::loaded_question_entities_properties_map(const LCQuADSplit &split) {
+q_ent_prp_map DutchKBQADSCreate::loaded_question_entities_properties_map(const LCQuADSplit &split,
+                                                                         bool use_binary_cache) {
+    const Tracing::Stage stage("load question-entities-properties map");
+    const fs::path source = supplements_dir / (question_entities_properties_map_file_name(split) + ".json");
+    if (use_binary_cache) {
+        const std::unique_ptr<Caching::SidecarReader> sidecar = Caching::opened_sidecar(
+            source,
+            Caching::SidecarKind::QUESTION_ENTITIES_PROPERTIES_MAP
+        );
+        if (sidecar != nullptr) {
+            return question_entities_properties_map_from_sidecar(*sidecar);
+        }
+    }
+    /* Fingerprint the JSON file before parsing it, so that a sidecar is never
+     * recorded as matching changes made to it meanwhile. */
+    std::optional<Caching::SourceFingerprint> fingerprint;
+    if (use_binary_cache) {
+        fingerprint = Caching::source_fingerprint(source);
+    }
     q_ent_prp_map m;
-    const Json::Value json = loaded_json_question_entities_properties_map(split);
-    for (const auto &member_str : json.getMemberNames()) {
+    JsonRecordReader reader(supplements_dir / question_entities_properties_map_file_name(split));
+    std::string member_str;
+    Json::Value ent_prp_array;
+    while (reader.next(member_str, ent_prp_array)) {
         int member = std::stoi(member_str);
-        std::set<std::string> ent_prp_set;
-        for (const auto &ent_or_prp : json[member_str]) {
-            ent_prp_set.insert(ent_or_prp.asString());
+        std::vector<WikiData::symbol_id> ent_prp_ids;
+        for (const auto &ent_or_prp : ent_prp_array) {
+            ent_prp_ids.push_back(WikiData::parsed_symbol_id(ent_or_prp.asString()));
         }
-        m.insert({ member, ent_prp_set });
+        std::sort(ent_prp_ids.begin(), ent_prp_ids.end());
+        ent_prp_ids.erase(std::unique(ent_prp_ids.begin(), ent_prp_ids.end()), ent_prp_ids.end());
+        m.insert({ member, std::move(ent_prp_ids) });
+    }
+    if (fingerprint.has_value() && Caching::fingerprint_matches(fingerprint.value(), source)) {
+        save_question_entities_properties_map_sidecar(m, source, fingerprint.value());
     }
     return m;
 }
@@ -144,7 +226,7 @@ void DutchKBQADSCreate::generate_question_entities_properties_map(const po::vari
                                            "-" +
                                            string_from_natural_language(NaturalLanguage::ENGLISH);
     const LCQuADSplit split = string_to_lc_quad_split_map.at(vm["split"].as<std::string>());
-    const Json::Value ds_split = json_loaded_from_dataset_file(ds_split_file_name);
+    JsonRecordReader ds_split(ds_split_file_name);
     const q_ent_prp_map m = question_entities_properties_map(ds_split);
     save_question_entities_properties_map(m, split);
 }
@@ -0,0 +1,432 @@
+/* Symbols for finalising masked question-answer pairs into columnar files for model training. */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include "tasks/finalise-dataset.hpp"
+#include "tracing/tracer.hpp"
+
+using namespace DutchKBQADSCreate;
+
+/**
+ * @brief Returns the lowercase equivalent of a code point of the Latin-1
+ *   Supplement or Latin Extended-A blocks.
+ *
+ * @param code_point The code point. From U+0080 up to and including U+017F.
+ * @return The lowercase code point, or `code_point` itself if it has none.
+ *   Never U+0130, which has no lowercase code point of its own.
+ */
+static std::uint32_t lowercase_latin_code_point(std::uint32_t code_point) {
+    if (code_point >= 0xc0 && code_point <= 0xde && code_point != 0xd7) {
+        return code_point + 0x20;
+    } else if (code_point == 0x178) {
+        return 0xff;
+    }
+    const bool even_is_uppercase = (code_point >= 0x100 && code_point <= 0x12f) ||
+                                   (code_point >= 0x132 && code_point <= 0x137) ||
+                                   (code_point >= 0x14a && code_point <= 0x177);
+    const bool odd_is_uppercase = (code_point >= 0x139 && code_point <= 0x148) ||
+                                  (code_point >= 0x179 && code_point <= 0x17e);
+    if ((even_is_uppercase && code_point % 2 == 0) || (odd_is_uppercase && code_point % 2 == 1)) {
+        return code_point + 1;
+    }
+    return code_point;
+}
+
+/**
+ * @brief Returns the UTF8-encoded `str`, but with its ASCII, Latin-1
+ *   Supplement and Latin Extended-A letters in lowercase, as Python's
+ *   `str.lower` has them. Letters of other blocks are left as they are.
+ *
+ * @param str The string.
+ * @return The lowercased string.
+ */
+static std::string lowercased(const std::string &str) {
+    std::string lowered;
+    lowered.reserve(str.size());
+    for (std::size_t idx = 0; idx < str.size(); idx++) {
+        const auto byte = static_cast<unsigned char>(str[idx]);
+        if (byte >= 'A' && byte <= 'Z') {
+            lowered.push_back(static_cast<char>(byte + ('a' - 'A')));
+            continue;
+        }
+        /* U+00C0 up to U+017F take two bytes, the first of which is 0xC3,
+         * 0xC4 or 0xC5. */
+        if (byte < 0xc3 || byte > 0xc5 || idx + 1 == str.size() ||
+            (static_cast<unsigned char>(str[idx + 1]) & 0xc0u) != 0x80) {
+            lowered.push_back(str[idx]);
+            continue;
+        }
+        const std::uint32_t code_point = ((byte & 0x1fu) << 6) | (static_cast<unsigned char>(str[idx + 1]) & 0x3fu);
+        idx++;
+        if (code_point == 0x130) {
+            lowered += "i\xcc\x87";  /* `i`, followed by a combining dot above. */
+            continue;
+        }
+        const std::uint32_t lowercase_code_point = lowercase_latin_code_point(code_point);
+        lowered.push_back(static_cast<char>(0xc0u | (lowercase_code_point >> 6)));
+        lowered.push_back(static_cast<char>(0x80u | (lowercase_code_point & 0x3fu)));
+    }
+    return lowered;
+}
+
+/**
+ * @brief Determines whether `character` is an ASCII digit.
+ *
+ * @param character The character.
+ * @return The question's answer.
+ */
+static bool is_ascii_digit(char character) {
+    return character >= '0' && character <= '9';
+}
+
+/**
+ * @brief Determines whether `character` is a lowercase ASCII letter.
+ *
+ * @param character The character.
+ * @return The question's answer.
+ */
+static bool is_lowercase_ascii_letter(char character) {
+    return character >= 'a' && character <= 'z';
+}
+
+/**
+ * @brief Determines whether a masked entity or property (like `q5` or `p31`)
+ *   starts at the index `idx` of `str`.
+ *
+ * @param str The string.
+ * @param idx The index.
+ * @return The question's answer.
+ */
+static bool masked_symbol_starts_at(const std::string &str, std::size_t idx) {
+    return idx + 1 < str.size() && (str[idx] == 'p' || str[idx] == 'q') && is_ascii_digit(str[idx + 1]);
+}
+
+/**
+ * @brief Returns the index at which a match at the end of `str` ends: the size
+ *   of `str`, or, if `str` ends in a line feed, the index of that line feed.
+ *
+ * Matches the semantics of `$` in Python's regular expressions.
+ *
+ * @param str The string.
+ * @return The index.
+ */
+static std::size_t end_anchor(const std::string &str) {
+    return !str.empty() && str.back() == '\n' ? str.size() - 1 : str.size();
+}
+
+/**
+ * @brief Returns `str`, but with every run of spaces replaced by a single
+ *   space.
+ *
+ * @param str The string.
+ * @return The manipulated string.
+ */
+static std::string with_spaces_collapsed(const std::string &str) {
+    std::string collapsed;
+    collapsed.reserve(str.size());
+    for (std::size_t idx = 0; idx < str.size(); idx++) {
+        if (str[idx] != ' ' || idx == 0 || str[idx - 1] != ' ') {
+            collapsed.push_back(str[idx]);
+        }
+    }
+    return collapsed;
+}
+
+/**
+ * @brief Returns `str`, but with every (non-overlapping) occurrence of
+ *   `before` replaced by `after`, from left to right.
+ *
+ * @param str The string.
+ * @param before The substring to replace. Non-empty.
+ * @param after The substring to replace `before` by.
+ * @return The manipulated string.
+ */
+static std::string with_all_replaced(const std::string &str, const std::string &before, const std::string &after) {
+    std::string replaced;
+    std::size_t start = 0;
+    for (std::size_t found = str.find(before); found != std::string::npos; found = str.find(before, start)) {
+        replaced.append(str, start, found - start).append(after);
+        start = found + before.size();
+    }
+    return replaced.append(str, start, std::string::npos);
+}
+
+/**
+ * @brief Post-processes a masked question: lowercases it, adds space around
+ *   masked entities and properties, makes a final question mark standalone,
+ *   and removes duplicate spaces.
+ *
+ * The result is the same as that of `post_processed_question` of the Python
+ * dataset-creating project's `finalise_dataset` module, bar letters outside of
+ * the Latin blocks, which are not lowercased.
+ *
+ * @param question The question to post-process.
+ * @return The post-processed question.
+ */
+std::string DutchKBQADSCreate::post_processed_question(const std::string &question) {
+    const std::string lowered = lowercased(question);
+    std::string spaced;
+    spaced.reserve(lowered.size() + lowered.size() / 4);
+    for (std::size_t idx = 0; idx < lowered.size(); idx++) {
+        if (!masked_symbol_starts_at(lowered, idx)) {
+            spaced.push_back(lowered[idx]);
+            continue;
+        }
+        std::size_t end = idx + 1;
+        while (end < lowered.size() && is_ascii_digit(lowered[end])) {
+            end++;
+        }
+        spaced.append(" ").append(lowered, idx, end - idx).append(" ");
+        idx = end - 1;
+    }
+    const std::size_t anchor = end_anchor(spaced);
+    if (anchor > 0 && spaced[anchor - 1] == '?') {
+        spaced.insert(anchor - 1, " ");
+    }
+    return with_spaces_collapsed(spaced);
+}
+
+/**
+ * @brief Post-processes a masked answer: lowercases it, replaces its special
+ *   symbols by more word-like equivalents, removes the WikiData namespaces of
+ *   its masked entities and properties, renames its variables to `var_1`,
+ *   `var_2`, and so on, and removes excessive spaces.
+ *
+ * The result is the same as that of `post_processed_answer` of the Python
+ * dataset-creating project's `finalise_dataset` module, bar letters outside of
+ * the Latin blocks, which are not lowercased. Variables are renamed in order of
+ * their first occurrence; like in that module, a variable whose name extends
+ * that of an earlier one has the earlier one's name replaced within it.
+ *
+ * @param answer The answer to post-process.
+ * @return The post-processed answer.
+ */
+std::string DutchKBQADSCreate::post_processed_answer(const std::string &answer) {
+    const std::string lowered = lowercased(answer);
+    std::string worded;
+    worded.reserve(lowered.size() * 2);
+    for (const char character : lowered) {
+        switch (character) {
+            case '{': worded += " brack_open "; break;
+            case '}': worded += " brack_close "; break;
+            case '(': worded += " attr_open "; break;
+            case ')': worded += " attr_close "; break;
+            case '.': worded += " sep_dot "; break;
+            case ',': worded += " , "; break;
+            default: worded.push_back(character);
+        }
+    }
+
+    /* Remove namespaces like `wdt:` in `wdt:p31`. */
+    std::string unprefixed;
+    unprefixed.reserve(worded.size());
+    for (std::size_t idx = 0; idx < worded.size();) {
+        if (!is_lowercase_ascii_letter(worded[idx])) {
+            unprefixed.push_back(worded[idx++]);
+            continue;
+        }
+        std::size_t end = idx;
+        while (end < worded.size() && is_lowercase_ascii_letter(worded[end])) {
+            end++;
+        }
+        if (end < worded.size() && worded[end] == ':' && masked_symbol_starts_at(worded, end + 1)) {
+            idx = end + 1;
+            continue;
+        }
+        unprefixed.append(worded, idx, end - idx);
+        idx = end;
+    }
+
+    /* A variable is a `?` followed by anything up until the next space. */
+    std::vector<std::string> variables;
+    for (std::size_t idx = 0; idx < unprefixed.size();) {
+        if (unprefixed[idx] != '?' || idx + 1 == unprefixed.size() || unprefixed[idx + 1] == ' ') {
+            idx++;
+            continue;
+        }
+        const std::size_t end = std::min(unprefixed.find(' ', idx), unprefixed.size());
+        const std::string variable = unprefixed.substr(idx, end - idx);
+        if (std::find(variables.begin(), variables.end(), variable) == variables.end()) {
+            variables.push_back(variable);
+        }
+        idx = end;
+    }
+    std::string renamed = unprefixed;
+    for (std::size_t idx = 0; idx < variables.size(); idx++) {
+        renamed = with_all_replaced(renamed, variables[idx], "var_" + std::to_string(idx + 1));
+    }
+
+    std::string collapsed = with_spaces_collapsed(renamed);
+    const std::size_t anchor = end_anchor(collapsed);
+    if (anchor > 0 && collapsed[anchor - 1] == ' ') {
+        collapsed.erase(anchor - 1, 1);  /* Spaces are collapsed, so there is at most one. */
+    }
+    return collapsed;
+}
+
+/**
+ * @brief Returns the name of the file of a partition of the finalised dataset.
+ *
+ * @param partition The partition: `train`, `validate` or `test`.
+ * @param language The natural language of the partition's questions.
+ * @return The file name, relative to `finalised_dataset_dir`. Includes the
+ *   `.columns` file extension.
+ */
+std::string DutchKBQADSCreate::finalised_partition_file_name(const std::string &partition,
+                                                             const NaturalLanguage &language) {
+    return partition + "-" + string_from_natural_language(language) + ".columns";
+}
+
+/**
+ * @brief Saves the finalised question-answer pairs from the index `begin` up
+ *   to the index `end` of `finalised_pairs` as a partition of the finalised
+ *   dataset.
+ *
+ * The partition is saved in columns, so that model training can map it into
+ * memory and read any pair without parsing the others. The file is a sidecar
+ * (see `Caching::SidecarWriter`) with five sections: the pairs' UIDs (32-bit
+ * integers); the byte offsets of the questions within the next section (64-bit
+ * unsigned integers, followed by the section's size); the UTF8-encoded
+ * questions, one after another; and the offsets and bytes of the answers
+ * likewise. The sidecar's fingerprint is that of the masked pairs file the
+ * partition was finalised from.
+ *
+ * @param finalised_pairs The finalised question-answer pairs.
+ * @param begin The index of the first pair of the partition.
+ * @param end The index past the last pair of the partition. At least `begin`,
+ *   and at most the number of pairs.
+ * @param partition The partition: `train`, `validate` or `test`.
+ * @param language The natural language of the pairs' questions.
+ * @param source The fingerprint of the masked pairs file that the pairs were
+ *   finalised from.
+ */
+void DutchKBQADSCreate::save_finalised_partition(const std::vector<QuestionAnswerPair> &finalised_pairs,
+                                                 std::size_t begin,
+                                                 std::size_t end,
+                                                 const std::string &partition,
+                                                 const NaturalLanguage &language,
+                                                 const Caching::SourceFingerprint &source) {
+    std::vector<std::int32_t> uids;
+    std::vector<std::uint64_t> question_offsets = { 0 };
+    std::vector<std::uint64_t> answer_offsets = { 0 };
+    std::string questions;
+    std::string answers;
+    uids.reserve(end - begin);
+    question_offsets.reserve(end - begin + 1);
+    answer_offsets.reserve(end - begin + 1);
+    for (std::size_t idx = begin; idx < end; idx++) {
+        uids.push_back(static_cast<std::int32_t>(finalised_pairs[idx].uid));
+        questions += finalised_pairs[idx].q;
+        question_offsets.push_back(questions.size());
+        answers += finalised_pairs[idx].a;
+        answer_offsets.push_back(answers.size());
+    }
+    Caching::SidecarWriter writer(finalised_dataset_dir / finalised_partition_file_name(partition, language),
+                                  Caching::FINALISED_DATASET_PARTITION,
+                                  source);
+    writer.write_section(uids);
+    writer.write_section(question_offsets);
+    writer.write_section(questions.data(), questions.size());
+    writer.write_section(answer_offsets);
+    writer.write_section(answers.data(), answers.size());
+    writer.commit();
+}
+
+/**
+ * @brief Post-processes the masked question-answer pairs of an LC-QuAD 2.0
+ *   dataset split, partitions them, and saves the partitions as the finalised
+ *   dataset.
+ *
+ * The pairs of the `test` split make up the `test` partition. Of those of the
+ * `train` split, the first `fraction_to_validate` go to the `validate`
+ * partition, and the others to the `train` partition. This is the same
+ * partitioning as that of the Python dataset-creating project's
+ * `finalise-dataset` task, which saves the partitions as text files instead.
+ * Like it, the pairs are taken in the order of the masked pairs file: by UID
+ * as a string (see `indices_in_uid_string_order`). The masked pairs must have
+ * been saved to disk already.
+ *
+ * @param masked_pairs The masked question-answer pairs of the split, in any
+ *   order.
+ * @param split The LC-QuAD 2.0 dataset split of the pairs.
+ * @param language The natural language of the pairs' questions.
+ * @param fraction_to_validate The fraction (0 and 1 both inclusive) of the
+ *   pairs of the `train` split that go to validation. Has no effect on the
+ *   `test` split.
+ */
+void DutchKBQADSCreate::finalise_question_answer_pairs(const std::vector<QuestionAnswerPair> &masked_pairs,
+                                                       const LCQuADSplit &split,
+                                                       const NaturalLanguage &language,
+                                                       double fraction_to_validate) {
+    if (!(fraction_to_validate >= 0. && fraction_to_validate <= 1.)) {
+        throw std::invalid_argument(std::string("The fraction to validate must lie within [0, 1], but is ") +
+                                    std::to_string(fraction_to_validate) +
+                                    ".");
+    }
+    const Tracing::Stage stage("finalise question-answer pairs");
+    std::vector<QuestionAnswerPair> finalised_pairs;
+    finalised_pairs.reserve(masked_pairs.size());
+    for (const std::size_t idx : indices_in_uid_string_order(masked_pairs)) {
+        finalised_pairs.emplace_back(masked_pairs[idx].uid,
+                                     post_processed_question(masked_pairs[idx].q),
+                                     post_processed_answer(masked_pairs[idx].a));
+    }
+    const Caching::SourceFingerprint source = Caching::source_fingerprint(
+        dataset_dir / (masked_question_answer_pairs_file_name(split, language) + ".json")
+    );
+    create_directory_if_absent(finalised_dataset_dir);
+    if (split == LCQuADSplit::TEST) {
+        save_finalised_partition(finalised_pairs, 0, finalised_pairs.size(), "test", language, source);
+        return;
+    }
+    const auto to_validate = static_cast<std::size_t>(std::floor(static_cast<double>(finalised_pairs.size()) *
+                                                                 fraction_to_validate));
+    save_finalised_partition(finalised_pairs, to_validate, finalised_pairs.size(), "train", language, source);
+    save_finalised_partition(finalised_pairs, 0, to_validate, "validate", language, source);
+}
+
+/**
+ * @brief Finalises the masked question-answer pairs of an LC-QuAD 2.0 dataset
+ *   split into columnar files for model training. See
+ *   `finalise_question_answer_pairs`.
+ *
+ * @param vm The variables map with which to determine which dataset split and
+ *   translation natural language to finalise, and, for the `train` split, the
+ *   fraction of its pairs that go to validation.
+ */
+void DutchKBQADSCreate::finalise_dataset(const po::variables_map &vm) {
+    const std::vector<std::string> required_flags = { "split",
+                                                      "language" };
+    for (const auto &required_flag : required_flags) {
+        if (vm.count(required_flag) == 0) {
+            throw std::invalid_argument(std::string("The \"--") +
+                                        required_flag +
+                                        "\" flag is required.");
+        }
+    }
+    const LCQuADSplit split = string_to_lc_quad_split_map.at(vm["split"].as<std::string>());
+    const NaturalLanguage language = string_to_natural_language_map.at(vm["language"].as<std::string>());
+    if (split == LCQuADSplit::TRAIN && vm.count("fraction-to-validate") == 0) {
+        throw std::invalid_argument(R"(The "--fraction-to-validate" flag is required for the "train" split.)");
+    }
+    const double fraction_to_validate = vm.count("fraction-to-validate") == 0 ?
+                                        0. :
+                                        vm["fraction-to-validate"].as<double>();
+    std::vector<QuestionAnswerPair> masked_pairs;
+    {
+        JsonRecordReader reader(masked_question_answer_pairs_file_name(split, language));
+        std::string uid;
+        Json::Value json_masked_qa_pair;
+        while (reader.next(uid, json_masked_qa_pair)) {
+            masked_pairs.emplace_back(std::stoi(uid),
+                                      json_masked_qa_pair["q"].asString(),
+                                      json_masked_qa_pair["a"].asString());
+        }
+    }
+    std::cout << "Finalising question-answer pairs... ";
+    finalise_question_answer_pairs(masked_pairs, split, language, fraction_to_validate);
+    std::cout << "Done." << std::endl;
+}
@@ -1,32 +1,310 @@
 /* Symbols for retrieving labels for WikiData entities and properties. */
 
-#include <curlpp/Easy.hpp>
-#include <curlpp/Options.hpp>
-#include <curlpp/Infos.hpp>
+#include <algorithm>
 #include <chrono>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <optional>
 #include <thread>
 #include "tasks/label-entities-properties.hpp"
 #include "tasks/collect-entities-properties.hpp"
 #include "utilities.hpp"
+#include "wikidata/query-fetcher.hpp"
+#include "wikidata/batch-sizer.hpp"
+#include "tracing/tracer.hpp"
+#include "concurrency/bounded-queue.hpp"
 
 using namespace DutchKBQADSCreate;
 
 /**
- * @brief Returns the set of entities and properties present in the
+ * @brief Constructs a view of the labels of a single entity or property.
+ *
+ * @param store The store containing the labels.
+ * @param first_span The index of the first label's span in the store.
+ * @param span_count The number of labels.
+ */
+DutchKBQADSCreate::LabelList::LabelList(const LabelStore *store,
+                                        std::uint32_t first_span,
+                                        std::uint32_t span_count)
+        : store(store), first_span(first_span), span_count(span_count) {}
+
+/**
+ * @brief Returns the number of labels.
+ *
+ * @return The number of labels.
+ */
+std::size_t DutchKBQADSCreate::LabelList::size() const {
+    return this->span_count;
+}
+
+/**
+ * @brief Returns whether there are no labels.
+ *
+ * @return The question's answer.
+ */
+bool DutchKBQADSCreate::LabelList::empty() const {
+    return this->span_count == 0;
+}
+
+/**
+ * @brief Returns the label at index `idx`.
+ *
+ * @param idx The index of the label. Must be smaller than `size()`.
+ * @return A view of the label in the store's string pool.
+ */
+std::string_view DutchKBQADSCreate::LabelList::operator[](std::size_t idx) const {
+    const LabelSpan &span = this->store->spans[this->first_span + idx];
+    return std::string_view(this->store->pool).substr(span.offset, span.length);
+}
+
+/**
+ * @brief Constructs an empty label store.
+ */
+DutchKBQADSCreate::LabelStore::LabelStore() : sealed(false) {}
+
+/**
+ * @brief Stores the labels of the entity or property `id`.
+ *
+ * @param id The entity or property. Must not have been added already.
+ * @param labels Its labels, in the order in which they should be stored.
+ */
+void DutchKBQADSCreate::LabelStore::add(WikiData::symbol_id id, const std::vector<std::string> &labels) {
+    if (this->sealed) {
+        throw std::logic_error("Cannot add labels to an already-sealed label store!");
+    }
+    this->entries.push_back({ id,
+                              static_cast<std::uint32_t>(this->spans.size()),
+                              static_cast<std::uint32_t>(labels.size()) });
+    for (const auto &label : labels) {
+        if (this->pool.size() + label.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("The labels do not fit in a single label store.");
+        }
+        this->spans.push_back({ static_cast<std::uint32_t>(this->pool.size()),
+                                static_cast<std::uint32_t>(label.size()) });
+        this->pool += label;
+    }
+}
+
+/**
+ * @brief Prepares the store for lookups. No labels can be added afterwards.
+ */
+void DutchKBQADSCreate::LabelStore::seal() {
+    std::sort(this->entries.begin(), this->entries.end(),
+              [] (const Entry &first, const Entry &second) -> bool {
+                  return first.id < second.id;
+              });
+    const auto duplicate = std::adjacent_find(this->entries.begin(), this->entries.end(),
+                                              [] (const Entry &first, const Entry &second) -> bool {
+                                                  return first.id == second.id;
+                                              });
+    if (duplicate != this->entries.end()) {
+        throw std::invalid_argument(std::string("The labels of \"") +
+                                    WikiData::string_from_symbol_id(duplicate->id) +
+                                    "\" have been stored more than once.");
+    }
+    this->pool.shrink_to_fit();
+    this->spans.shrink_to_fit();
+    this->entries.shrink_to_fit();
+    this->sealed = true;
+}
+
+/**
+ * @brief Returns whether labels have been stored for `id`, even if that is an
+ *   empty list of labels.
+ *
+ * @param id The entity or property.
+ * @return The question's answer.
+ */
+bool DutchKBQADSCreate::LabelStore::contains(WikiData::symbol_id id) const {
+    if (!this->sealed) {
+        throw std::logic_error("The label store must be sealed before looking up labels in it!");
+    }
+    const auto it = std::lower_bound(this->entries.begin(), this->entries.end(), id,
+                                     [] (const Entry &entry, WikiData::symbol_id value) -> bool {
+                                         return entry.id < value;
+                                     });
+    return it != this->entries.end() && it->id == id;
+}
+
+/**
+ * @brief Returns the labels of `id`.
+ *
+ * @param id The entity or property.
+ * @return A view of its labels. If `id` isn't stored, it is treated as if it
+ *   has no labels.
+ */
+LabelList DutchKBQADSCreate::LabelStore::labels(WikiData::symbol_id id) const {
+    if (!this->sealed) {
+        throw std::logic_error("The label store must be sealed before looking up labels in it!");
+    }
+    const auto it = std::lower_bound(this->entries.begin(), this->entries.end(), id,
+                                     [] (const Entry &entry, WikiData::symbol_id value) -> bool {
+                                         return entry.id < value;
+                                     });
+    if (it == this->entries.end() || it->id != id) {
+        return { this, 0, 0 };
+    }
+    return { this, it->first_span, it->span_count };
+}
+
+/**
+ * @brief Returns the number of entities and properties stored.
+ *
+ * @return The number.
+ */
+std::size_t DutchKBQADSCreate::LabelStore::number_of_symbols() const {
+    return this->entries.size();
+}
+
+/**
+ * @brief Returns the entity or property at index `idx`. Once sealed, these are
+ *   in ascending order.
+ *
+ * @param idx The index. Must be smaller than `number_of_symbols()`.
+ * @return The entity or property.
+ */
+WikiData::symbol_id DutchKBQADSCreate::LabelStore::symbol(std::size_t idx) const {
+    return this->entries.at(idx).id;
+}
+
+/**
+ * @brief Returns the labels of the entity or property at index `idx`.
+ *
+ * @param idx The index. Must be smaller than `number_of_symbols()`.
+ * @return A view of the labels.
+ */
+LabelList DutchKBQADSCreate::LabelStore::labels_at(std::size_t idx) const {
+    const Entry &entry = this->entries.at(idx);
+    return { this, entry.first_span, entry.span_count };
+}
+
+/**
+ * @brief Returns the total number of labels stored, over all entities and
+ *   properties.
+ *
+ * @return The number.
+ */
+std::size_t DutchKBQADSCreate::LabelStore::number_of_labels() const {
+    return this->spans.size();
+}
+
+/**
+ * @brief Writes the store to `sidecar`, as three sections: the entries, the
+ *   label spans, and the string pool.
+ *
+ * @param sidecar The sidecar to write to.
+ */
+void DutchKBQADSCreate::LabelStore::write_to(Caching::SidecarWriter &sidecar) const {
+    if (!this->sealed) {
+        throw std::logic_error("Only a sealed label store can be written to a sidecar!");
+    }
+    sidecar.write_section(this->entries);
+    sidecar.write_section(this->spans);
+    sidecar.write_section(this->pool.data(), this->pool.size());
+}
+
+/**
+ * @brief Reads a store written by `write_to` from `sidecar`.
+ *
+ * @param sidecar The sidecar to read from, of which the header has already
+ *   been read.
+ * @return The store, sealed.
+ */
+LabelStore DutchKBQADSCreate::LabelStore::read_from(Caching::SidecarReader &sidecar) {
+    LabelStore store;
+    store.entries = sidecar.read_section<Entry>();
+    store.spans = sidecar.read_section<LabelSpan>();
+    store.pool = sidecar.read_string_section();
+    const bool entries_are_valid = std::all_of(
+        store.entries.begin(), store.entries.end(),
+        [&store] (const Entry &entry) -> bool {
+            return entry.first_span <= store.spans.size() &&
+                   entry.span_count <= store.spans.size() - entry.first_span;
+        }
+    );
+    const bool spans_are_valid = std::all_of(
+        store.spans.begin(), store.spans.end(),
+        [&store] (const LabelSpan &span) -> bool {
+            return span.offset <= store.pool.size() && span.length <= store.pool.size() - span.offset;
+        }
+    );
+    if (!entries_are_valid || !spans_are_valid) {
+        throw std::runtime_error("A label sidecar is malformed.");
+    }
+    store.sealed = true;
+    return store;
+}
+
+/**
+ * @brief Constructs a view of the labels in `store` of the entities and
+ *   properties `ent_prp_ids`.
+ *
+ * @param ent_prp_ids The entities and properties to view the labels of.
+ * @param store The labels of all entities and properties. Must be sealed.
+ */
+DutchKBQADSCreate::LabelSubset::LabelSubset(const std::vector<WikiData::symbol_id> &ent_prp_ids,
+                                            const LabelStore &store)
+        : ent_prp_ids(ent_prp_ids.data()), ent_prp_count(ent_prp_ids.size()), store(&store) {}
+
+/**
+ * @brief Returns the number of entities and properties in the subset.
+ *
+ * @return The number.
+ */
+std::size_t DutchKBQADSCreate::LabelSubset::size() const {
+    return this->ent_prp_count;
+}
+
+/**
+ * @brief Returns whether the subset has no entities and properties.
+ *
+ * @return The question's answer.
+ */
+bool DutchKBQADSCreate::LabelSubset::empty() const {
+    return this->ent_prp_count == 0;
+}
+
+/**
+ * @brief Returns the entity or property at index `idx` of the subset.
+ *
+ * @param idx The index. Must be smaller than `size()`.
+ * @return The entity or property.
+ */
+WikiData::symbol_id DutchKBQADSCreate::LabelSubset::symbol(std::size_t idx) const {
+    if (idx >= this->ent_prp_count) {
+        throw std::out_of_range("Label subset index out of bounds.");
+    }
+    return this->ent_prp_ids[idx];
+}
+
+/**
+ * @brief Returns the labels of the entity or property at index `idx` of the
+ *   subset, looking them up in the store.
+ *
+ * @param idx The index. Must be smaller than `size()`.
+ * @return A view of the labels.
+ */
+LabelList DutchKBQADSCreate::LabelSubset::labels_at(std::size_t idx) const {
+    return this->store->labels(this->symbol(idx));
+}
+
+/**
+ * @brief Returns the entities and properties present in the
  *   question-to-entities-and-properties map of `split`.
  *
  * @param split The split to retrieve the unique entities and properties of.
- * @return The set.
+ * @return The entities and properties, sorted and without duplicates.
  */
-std::set<std::string> DutchKBQADSCreate::unique_entities_and_properties_of_split(const LCQuADSplit &split) {
-    Json::Value json = loaded_json_question_entities_properties_map(split);
-    std::set<std::string> ent_prp_set;
-    for (const auto &member : json.getMemberNames()) {
-        for (const auto &ent_or_prp : json[member]) {
-            ent_prp_set.insert(ent_or_prp.asString());
-        }
+std::vector<WikiData::symbol_id> DutchKBQADSCreate::unique_entities_and_properties_of_split(const LCQuADSplit &split) {
+    const q_ent_prp_map m = loaded_question_entities_properties_map(split);
+    std::vector<WikiData::symbol_id> ent_prp_ids;
+    for (const auto &q_ent_prp_pair : m) {
+        ent_prp_ids.insert(ent_prp_ids.end(), q_ent_prp_pair.second.begin(), q_ent_prp_pair.second.end());
     }
-    return ent_prp_set;
+    std::sort(ent_prp_ids.begin(), ent_prp_ids.end());
+    ent_prp_ids.erase(std::unique(ent_prp_ids.begin(), ent_prp_ids.end()), ent_prp_ids.end());
+    return ent_prp_ids;
 }
 
 /**
@@ -35,107 +313,229 @@ std::set<std::string> DutchKBQADSCreate::unique_entities_and_properties_of_split
  *
  * @param split The LC-QuAD 2.0 dataset split for which to get the file name.
  * @param language The natural language in which the labels are expressed.
+ * @param shard The shard of the split's entities and properties whose labels
+ *   the file holds.
  * @return The file name.
  */
 std::string entity_and_property_labels_file_name(const LCQuADSplit &split,
-                                                 const NaturalLanguage &language) {
+                                                 const NaturalLanguage &language,
+                                                 const Shard &shard) {
     return string_from_lc_quad_split(split) +
            "-" +
            string_from_natural_language(language) +
-           "-entity-property-labels";
+           "-entity-property-labels" +
+           shard.file_name_suffix();
+}
+
+/**
+ * @brief Returns the path, relative to the dataset directory and excluding its
+ *   extension, of the WikiData entity-and-property labels file.
+ *
+ * The compacted labels are stored at this path with a `.json` extension; labels
+ * that have not been compacted yet are stored in a log with a `.jsonl`
+ * extension.
+ *
+ * @param split The LC-QuAD 2.0 dataset split for which to get the path.
+ * @param language The natural language in which the labels are expressed.
+ * @param shard The shard of the split's entities and properties whose labels
+ *   the file holds.
+ * @return The relative path.
+ */
+std::string DutchKBQADSCreate::entity_and_property_labels_relative_path(const LCQuADSplit &split,
+                                                                        const NaturalLanguage &language,
+                                                                        const Shard &shard) {
+    return std::string("supplements/") + entity_and_property_labels_file_name(split, language, shard);
 }
 
 /**
  * @brief Saves the entity-and-property labels to disk.
  *
- * This function appends the supplied entities and properties if a file storing
- * WikiData entities and properties already exists on disk; if said file does
- * not yet exist, this function will also create the file before writing the
- * labels.
+ * This function appends the supplied entities and properties as a single
+ * record to the labels log, creating the log if it does not exist yet. Unlike
+ * rewriting the compacted labels file, this takes time proportional to the size
+ * of `json` only, and a crash can at most lose the record being written. Call
+ * `compact_entity_and_property_labels` to fold the log into the compacted
+ * labels file.
  *
  * @param json The WikiData labels of entities and properties, stored as a JSON
  *   object.
  * @param split The LC-QuAD 2.0 dataset split of which `json` stores the labels.
  * @param language The natural language of the labels of `json`.
+ * @param shard The shard of the split's entities and properties that `json`
+ *   belongs to.
  */
 void DutchKBQADSCreate::save_entity_and_property_labels(const Json::Value &json,
                                                         const LCQuADSplit &split,
-                                                        const NaturalLanguage &language) {
-    const std::string relative_path = std::string("supplements/") +
-                                      entity_and_property_labels_file_name(split, language);
-    if (dataset_file_exists(relative_path + ".json")) {
-        append_json_to_dataset_file(json, relative_path);
-    } else {
-        save_json_to_dataset_file(json, relative_path);
-    }
+                                                        const NaturalLanguage &language,
+                                                        const Shard &shard) {
+    append_json_line_to_dataset_file(json, entity_and_property_labels_relative_path(split, language, shard));
 }
 
 /**
- * @brief Returns the required entity-and-property labels file as a JSON object
+ * @brief Returns the required entity-and-property labels as a JSON object
  *   loaded from disk.
  *
+ * The labels consist of the compacted labels file, overlaid with the records
+ * of the labels log in the order in which they were appended.
+ *
  * @param split The LC-QuAD 2.0 dataset split to target.
  * @param language The natural language to target.
- * @return The loaded labels file as a JSON object, provided that it exists on
- *   disk. If not, an empty JSON object is returned instead.
+ * @param shard The shard of the split's entities and properties to target.
+ * @return The loaded labels as a JSON object. If neither the compacted labels
+ *   file nor the labels log exists on disk, an empty JSON object is returned
+ *   instead.
  */
 Json::Value DutchKBQADSCreate::loaded_json_entity_and_property_labels(const LCQuADSplit &split,
-                                                                      const NaturalLanguage &language) {
-    const std::string relative_path = std::string("supplements/") +
-                                      entity_and_property_labels_file_name(split, language);
+                                                                      const NaturalLanguage &language,
+                                                                      const Shard &shard) {
+    const std::string relative_path = entity_and_property_labels_relative_path(split, language, shard);
+    Json::Value json;  /* an empty JSON object if nothing is found */
     if (dataset_file_exists(relative_path + ".json")) {
-        return json_loaded_from_dataset_file(relative_path);
-    } else {
-        return {};  /* return an empty JSON object if it isn't found */
+        json = json_loaded_from_dataset_file(relative_path);
+    }
+    for (const auto &record : json_lines_loaded_from_dataset_file(relative_path)) {
+        for (const auto &ent_or_prp : record.getMemberNames()) {
+            json[ent_or_prp] = record[ent_or_prp];
+        }
     }
+    return json;
 }
 
 /**
- * @brief Returns the required entity-and-property labels file as a C++ map
- *   loaded from disk.
+ * @brief Folds the labels log of `split` and `language` into the compacted
+ *   labels file, and removes the log afterwards.
+ *
+ * The compacted labels are first written to a temporary file, which then
+ * replaces the compacted labels file. As such, an interrupted compaction
+ * leaves both the log and the previous compacted labels file intact.
  *
  * @param split The LC-QuAD 2.0 dataset split to target.
  * @param language The natural language to target.
- * @return The loaded labels file as a C++ map, provided that it exists on
- *   disk. If not, an empty C++ map is returned instead.
+ * @param shard The shard of the split's entities and properties to target.
  */
-ent_prp_label_map DutchKBQADSCreate::loaded_entity_and_property_labels(const LCQuADSplit &split,
-                                                                       const NaturalLanguage &language) {
-    ent_prp_label_map m;
-    Json::Value json = loaded_json_entity_and_property_labels(split, language);
+void DutchKBQADSCreate::compact_entity_and_property_labels(const LCQuADSplit &split,
+                                                           const NaturalLanguage &language,
+                                                           const Shard &shard) {
+    if (!dataset_file_exists(entity_and_property_labels_relative_path(split, language, shard) + ".jsonl")) {
+        return;  /* There is nothing to compact. */
+    }
+    compact_entity_and_property_labels(loaded_json_entity_and_property_labels(split, language, shard),
+                                       split,
+                                       language,
+                                       shard);
+}
+
+/**
+ * @brief Replaces the compacted labels file of `split` and `language` by
+ *   `json`, and removes the labels log afterwards. See the overload without
+ *   `json`, which loads the labels from disk itself.
+ *
+ * @param json All labels of `split` and `language`, as a JSON object; that is,
+ *   the compacted labels file overlaid with the labels log, as returned by
+ *   `loaded_json_entity_and_property_labels`.
+ * @param split The LC-QuAD 2.0 dataset split to target.
+ * @param language The natural language to target.
+ * @param shard The shard of the split's entities and properties to target.
+ */
+void DutchKBQADSCreate::compact_entity_and_property_labels(const Json::Value &json,
+                                                           const LCQuADSplit &split,
+                                                           const NaturalLanguage &language,
+                                                           const Shard &shard) {
+    const std::string relative_path = entity_and_property_labels_relative_path(split, language, shard);
+    save_json_to_dataset_file(json, relative_path + ".compacting");
+    fs::rename(dataset_dir / (relative_path + ".compacting.json"),
+               dataset_dir / (relative_path + ".json"));
+    fs::remove(dataset_dir / (relative_path + ".jsonl"));
+}
+
+/**
+ * @brief Returns the entity-and-property labels of `json` in a sealed label
+ *   store.
+ *
+ * @param json A mapping from entities and properties to arrays of labels, as
+ *   returned by `loaded_json_entity_and_property_labels`.
+ * @return The label store.
+ */
+LabelStore DutchKBQADSCreate::label_store_from_json(const Json::Value &json) {
+    LabelStore store;
+    std::vector<std::string> labels;
     for (const auto &member : json.getMemberNames()) {
-        m.insert({ member, {} });
+        labels.clear();
         for (const auto &ent_prp_label : json[member]) {
-            m[member].push_back(ent_prp_label.asString());
+            labels.push_back(ent_prp_label.asString());
         }
+        store.add(WikiData::parsed_symbol_id(member), labels);
     }
-    return m;
+    store.seal();
+    return store;
 }
 
 /**
- * @brief Returns a subset of the mapping from entities and properties to
- *   labels, containing only key-value pairs whose keys are entries in
- *   `ent_prp_set`.
+ * @brief Returns the required entity-and-property labels loaded from disk, in
+ *   a sealed label store.
  *
- * @param ent_prp_set The set of entities and properties to include in the
- *   mapping subset.
- * @param all A complete mapping from entities and properties to labels, even
- *   including entries whose keys are not part of `ent_prp_set`.
- * @return The subset of the map.
+ * If `use_binary_cache` is set and the labels log is empty, the labels are
+ * read from the binary sidecar of the compacted labels file instead, provided
+ * that the sidecar is up-to-date. If it is not, the compacted labels file is
+ * parsed, and the sidecar is (re)written for later runs, unless the file
+ * changed while it was parsed. While the labels log is non-empty, no sidecar
+ * is used, as the log would have to be parsed anyway.
+ *
+ * @param split The LC-QuAD 2.0 dataset split to target.
+ * @param language The natural language to target.
+ * @param use_binary_cache Whether to read and maintain the binary sidecar.
+ * @return The loaded labels, provided that they exist on disk. If not, an
+ *   empty label store is returned instead.
  */
-ent_prp_label_map DutchKBQADSCreate::entity_and_property_labels_subset(const std::set<std::string> &ent_prp_set,
-                                                                       const ent_prp_label_map &all) {
-    ent_prp_label_map sub_map;
-    for (const auto &ent_or_prp : ent_prp_set) {
-        if (all.find(ent_or_prp) == all.end()) {
-            /* Entity or property isn't even listed. Treat as if it has no
-             * labels. */
-            sub_map.insert({ ent_or_prp, {} });
-        } else {
-            sub_map.insert({ ent_or_prp, all.at(ent_or_prp) });
+LabelStore DutchKBQADSCreate::loaded_entity_and_property_labels(const LCQuADSplit &split,
+                                                                const NaturalLanguage &language,
+                                                                bool use_binary_cache) {
+    const Tracing::Stage stage("load labels");
+    const std::string relative_path = entity_and_property_labels_relative_path(split, language, whole_shard);
+    const fs::path source = dataset_dir / (relative_path + ".json");
+    const bool cacheable = use_binary_cache &&
+                           fs::exists(source) &&
+                           !dataset_file_exists(relative_path + ".jsonl");
+    if (cacheable) {
+        const std::unique_ptr<Caching::SidecarReader> sidecar = Caching::opened_sidecar(
+            source,
+            Caching::SidecarKind::ENTITY_PROPERTY_LABELS
+        );
+        if (sidecar != nullptr) {
+            return LabelStore::read_from(*sidecar);
         }
     }
-    return sub_map;
+    /* Fingerprint the labels file before parsing it, so that a sidecar is
+     * never recorded as matching changes made to it meanwhile. */
+    std::optional<Caching::SourceFingerprint> fingerprint;
+    if (cacheable) {
+        fingerprint = Caching::source_fingerprint(source);
+    }
+    const LabelStore store = label_store_from_json(loaded_json_entity_and_property_labels(split, language));
+    if (fingerprint.has_value() && Caching::fingerprint_matches(fingerprint.value(), source)) {
+        Caching::SidecarWriter writer(Caching::sidecar_path_for(source),
+                                      Caching::SidecarKind::ENTITY_PROPERTY_LABELS,
+                                      fingerprint.value());
+        store.write_to(writer);
+        writer.commit();
+    }
+    return store;
+}
+
+/**
+ * @brief Returns the labels of the entities and properties `ent_prp_ids`, as
+ *   a lazy view into `all`; no labels are copied, and nothing is allocated.
+ *
+ * @param ent_prp_ids The entities and properties to include in the subset.
+ *   Must outlive the subset.
+ * @param all The labels of all entities and properties, even including those
+ *   not part of `ent_prp_ids`.
+ * @return The subset, in the order of `ent_prp_ids`. Entities and properties
+ *   that aren't even stored in `all` are treated as if they have no labels.
+ */
+LabelSubset DutchKBQADSCreate::entity_and_property_labels_subset(const std::vector<WikiData::symbol_id> &ent_prp_ids,
+                                                                 const LabelStore &all) {
+    return { ent_prp_ids, all };
 }
 
 /**
@@ -149,192 +549,69 @@ ent_prp_label_map DutchKBQADSCreate::entity_and_property_labels_subset(const std
  *   and properties needs to be performed.
  * @param language The natural language in which the labelling needs to be
  *   performed.
- * @return The set of WikiData entities and properties that still require
- *   labelling.
- */
-std::set<std::string> DutchKBQADSCreate::entities_and_properties_requiring_labeling(const LCQuADSplit &split,
-                                                                                    const NaturalLanguage &language) {
-    Json::Value current_json = loaded_json_entity_and_property_labels(split, language);
-    const std::set<std::string> ent_prp_total = unique_entities_and_properties_of_split(split);
-    std::set<std::string> ent_prp_labelled;
-    for (const auto &ent_or_prp : current_json.getMemberNames()) {
-        ent_prp_labelled.insert(ent_or_prp);
-    }
-    std::cout << "" << "(Found " << ent_prp_labelled.size() << " already-labelled symbols.)" << std::endl;
-    std::set<std::string> ent_prp_to_label;
-    std::set_difference(ent_prp_total.begin(), ent_prp_total.end(),
-                        ent_prp_labelled.begin(), ent_prp_labelled.end(),
-                        std::inserter(ent_prp_to_label, ent_prp_to_label.begin()));
-    return ent_prp_to_label;
-}
-
-/**
- * @brief Partitions the provided set of entities and properties into (mostly)
- *   `part_size`-sized sets.
- *
- * @param ent_prp_set The entities and properties to partition.
- * @param part_size The size that the partition's parts should maximally have.
- *   All or all but one of the parts will be of this size. The very last part
- *   may be of a smaller size than `part_size`, but its size is guaranteed to
- *   be at least 1.
- * @return The parts of the partition: smaller sets of minimally 1 and
- *   maximally `part_size` size.
+ * @return The WikiData entities and properties that still require labelling,
+ *   sorted.
  */
-ent_prp_partitioning DutchKBQADSCreate::entity_property_partitioning(const std::set<std::string> &ent_prp_set,
-                                                                     int part_size) {
-    if ((part_size < 0) || (static_cast<size_t>(part_size) > ent_prp_set.size())) {
-        throw std::invalid_argument(std::string("Part size ") +
-                                    std::to_string(part_size) +
-                                    " is inappropriate for entity and" +
-                                    " property set of length " +
-                                    std::to_string(ent_prp_set.size()) +
-                                    ".");
-    }
-    ent_prp_partitioning partitioning;
-    int count = 0;
-    for (const auto &ent_or_prp : ent_prp_set) {
-        if ((count % part_size) == 0) {
-            partitioning.emplace_back();  /* begin a new part */
-        }
-        partitioning[partitioning.size() - 1].insert(ent_or_prp);
-        count++;
-    }
-    return partitioning;
+std::vector<WikiData::symbol_id> DutchKBQADSCreate::entities_and_properties_requiring_labeling(
+        const LCQuADSplit &split,
+        const NaturalLanguage &language) {
+    return entities_and_properties_requiring_labeling(unique_entities_and_properties_of_split(split),
+                                                      loaded_json_entity_and_property_labels(split, language));
 }
 
 /**
- * @brief Returns a WikiData SPARQL query for obtaining labels associated with
- *   the entity or property `ent_or_prp`.
+ * @brief Returns the entities and properties of `ent_prp_total` that have no
+ *   labels in `current_json` yet.
  *
- * @param ent_or_prp The WikiData entity or property to get the labels of.
- * @param language The natural language in which the labels should be
- *   expressed.
- * @param indent_level The indentation level of the query. Must be
- *   non-negative.
- * @return The query.
+ * @param ent_prp_total The entities and properties that require labels,
+ *   sorted and without duplicates.
+ * @param current_json The labels obtained so far, as returned by
+ *   `loaded_json_entity_and_property_labels`.
+ * @return The entities and properties that still require labelling, sorted.
  */
-std::string wikidata_labelling_query_for_one_entity_or_property(const std::string &ent_or_prp,
-                                                                const NaturalLanguage &language,
-                                                                int indent_level) {
-    if (indent_level < 0) {
-        throw std::invalid_argument("Indent level must be non-negative!");
-    }
-    const char tab = '\t';
-    const char nl = '\n';
-    const std::string sparql_nl(" .\n");
-    const std::string indent(indent_level, tab);
-    return indent + "SELECT DISTINCT ?id ?label WHERE {" + nl +
-           indent + tab + "BIND(\"" + ent_or_prp + "\" AS ?id)" + sparql_nl +
-           indent + tab + '{' + nl +
-           indent + tab + tab + "wd:" + ent_or_prp + " rdfs:label ?label" + sparql_nl +
-           indent + tab + "} UNION {" + nl +
-           indent + tab + tab + "wd:" + ent_or_prp + " skos:altLabel ?label" + sparql_nl +
-           indent + tab + '}' + nl +
-           indent + tab + "FILTER(LANG(?label) = \"" + string_from_natural_language(language) + "\")" + sparql_nl +
-           indent + "}" + nl;
+std::vector<WikiData::symbol_id> DutchKBQADSCreate::entities_and_properties_requiring_labeling(
+        const std::vector<WikiData::symbol_id> &ent_prp_total,
+        const Json::Value &current_json) {
+    std::vector<WikiData::symbol_id> ent_prp_labelled;
+    for (const auto &ent_or_prp : current_json.getMemberNames()) {
+        ent_prp_labelled.push_back(WikiData::parsed_symbol_id(ent_or_prp));
+    }
+    std::sort(ent_prp_labelled.begin(), ent_prp_labelled.end());
+    std::cout << "" << "(Found " << ent_prp_labelled.size() << " already-labelled symbols.)" << std::endl;
+    std::vector<WikiData::symbol_id> ent_prp_to_label;
+    std::set_difference(ent_prp_total.begin(), ent_prp_total.end(),
+                        ent_prp_labelled.begin(), ent_prp_labelled.end(),
+                        std::back_inserter(ent_prp_to_label));
+    return ent_prp_to_label;
 }
 
 /**
  * @brief Returns a WikiData SPARQL query for obtaining labels associated with
  *   multiple entities and properties, collected in `ent_prp_part`.
  *
+ * The entities and properties are listed once, in a `VALUES` clause, so that
+ * the query grows by only a few bytes per entity or property.
+ *
  * @param ent_prp_part The partition part containing one or more entities and
  *   properties.
  * @param language A natural language to express the labels in.
  * @return The query.
  */
-std::string wikidata_labelling_query_for_entities_and_properties(const std::set<std::string> &ent_prp_part,
+std::string wikidata_labelling_query_for_entities_and_properties(const std::vector<WikiData::symbol_id> &ent_prp_part,
                                                                  const NaturalLanguage &language) {
-    std::string query = std::string("SELECT ?id ?label WHERE {\n");
-    int count = 0;
+    std::string query = std::string("SELECT DISTINCT ?id ?label WHERE {\n");
+    query += "\tVALUES ?item {";
     for (const auto &ent_or_prp : ent_prp_part) {
-        query += "\t{\n";
-        query += wikidata_labelling_query_for_one_entity_or_property(ent_or_prp,
-                                                                     language,
-                                                                     2);
-        query += "\t}\n";
-        if (static_cast<size_t>(count) != ent_prp_part.size() - 1) {
-            query += "\tUNION\n";
-        }
-        count++;
+        query += " wd:" + WikiData::string_from_symbol_id(ent_or_prp);
     }
+    query += " }\n";
+    query += "\t{ ?item rdfs:label ?label . } UNION { ?item skos:altLabel ?label . }\n";
+    query += "\tFILTER(LANG(?label) = \"" + string_from_natural_language(language) + "\") .\n";
+    query += "\tBIND(STRAFTER(STR(?item), STR(wd:)) AS ?id) .\n";
     query += "}";
     return query;
 }
 
-/**
- * @brief Encodes a string for usage in a URL.
- *
- * This function's implementation is derived from a StackOverflow answer given
- * here:
- *   https://stackoverflow.com/a/17708801
- *
- * @param str The string to encode for use in URLs.
- * @return The encoded string.
- */
-std::string url_encoded_string(const std::string &str) {
-    std::ostringstream encoded;
-    encoded.fill('0');
-    encoded << std::hex;
-    for (char c : str) {
-        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
-            /* Pass unreserved characters as-is. See RFC 3986, section 2.3. */
-            encoded << c;
-        } else {
-            /* Percent-encode reserved characters. See RFC 3986, section 2.2. */
-            encoded << std::uppercase;
-            encoded << '%' << std::setw(2) << int((unsigned char) c);
-            encoded << std::nouppercase;
-        }
-    }
-    return encoded.str();
-}
-
-const std::string wikidata_query_service_url = "https://query.wikidata.org/";
-
-/**
- * @brief Writes binary data items from a source location, `ptr`, to a stream
- *   handled by a caller, doing this without printing anything to standard
- *   output.
- *
- * Normally, this `fwrite`-like function has a fourth parameter: `FILE *stream`,
- * pointing to a stream to which the data items should be written. This method,
- * being a callback for `curlpp`, omits this parameter.
- *
- * @param ptr The location where data items are to be obtained from.
- * @param size The size in bytes of each single data item. For `curl` and
- *   `curlpp`, this size is always 1 (byte).
- * @param n_mem The number of data items.
- * @return The number of bytes successfully written to the target stream, which
- *   is handled by the consuming `curlpp` code. If this number of bytes does
- *   equal the total size of all data items, an error is supposed to be raised
- *   by the caller.
- */
-size_t muted_write_function([[maybe_unused]] char *ptr, size_t size, size_t n_mem_b) {
-    return size * n_mem_b;
-}
-
-/**
- * @brief Sets request headers for querying WikiData, meant for obtaining the
- *   labels of entities and properties.
- *
- * @param request The base request object to add request headers to.
- * @param ent_prp_part Entities and properties to obtain labels of.
- * @param language The natural language to obtain the labels in.
- */
-void set_wikidata_request_headers(curlpp::Easy &request,
-                                  const std::set<std::string> &ent_prp_part,
-                                  const NaturalLanguage &language) {
-    const std::string query = wikidata_labelling_query_for_entities_and_properties(ent_prp_part, language);
-    const std::string encoded = url_encoded_string(query);
-    request.setOpt(new curlpp::Options::HttpHeader({ "Accept: application/json",
-                                                     "User-Agent: Curlpp/0.8.1" }));
-    request.setOpt(new curlpp::Options::Url(wikidata_query_service_url +
-                                            "sparql?query=" +
-                                            encoded));
-    request.setOpt(new curlpp::Options::WriteFunction(muted_write_function));
-}
-
 /**
  * @brief Returns the same entity-and-property labels JSON as what WikiData
  *   gave directly, except that it has been reduced to only the essential
@@ -344,12 +621,12 @@ void set_wikidata_request_headers(curlpp::Easy &request,
  * @param unstructured The unstructured, raw labels JSON given by WikiData.
  * @return The cleaned-up JSON.
  */
-Json::Value restructured_wikidata_entity_and_property_labels(const std::set<std::string> &ent_prp_part,
+Json::Value restructured_wikidata_entity_and_property_labels(const std::vector<WikiData::symbol_id> &ent_prp_part,
                                                              const Json::Value &unstructured) {
     Json::Value output;
     for (const auto &ent_or_prp : ent_prp_part) {
         /* Initially, each entity and property has an empty array of labels. */
-        output[ent_or_prp] = Json::arrayValue;
+        output[WikiData::string_from_symbol_id(ent_or_prp)] = Json::arrayValue;
     }
     for (const auto &binding : unstructured) {
         /* For each binding, which is essentially a single
@@ -361,88 +638,395 @@ Json::Value restructured_wikidata_entity_and_property_labels(const std::set<std:
     return output;
 }
 
-const int too_many_requests_seconds_to_wait = 5;
-const int query_interval_seconds_to_wait = 3;
+/**
+ * @brief Returns the labels in `language` for the specified set of entities
+ *   and properties, `ent_prp_part`, given WikiData's response to the labelling
+ *   query of the part.
+ *
+ * @param ent_prp_part An entity-and-property part of a partition.
+ * @param response_body The body of WikiData's response.
+ * @return A mapping from entities and properties to arrays of zero or more
+ *   labels.
+ */
+Json::Value entity_and_property_labels_of_part(const std::vector<WikiData::symbol_id> &ent_prp_part,
+                                               const std::string &response_body) {
+    std::stringstream result(response_body);
+    Json::Value json;
+    result >> json;
+    return restructured_wikidata_entity_and_property_labels(ent_prp_part, json["results"]["bindings"]);
+}
 
 /**
- * @brief Performs the WikiData query for obtaining entity and property labels,
- *   retrying when various types of network issues arise.
+ * @brief Labels the entities and properties of `ent_prp_ids` of which
+ *   `label_cache` holds unexpired labels, and returns the others.
+ *
+ * The labels taken from the cache are saved like freshly-fetched labels are,
+ * and added to `all_labels`.
  *
- * @param request The WikiData label-extraction request to perform.
+ * @param ent_prp_ids The entities and properties that require labelling.
+ * @param label_cache The cache to take labels from.
+ * @param split The LC-QuAD 2.0 dataset split to work on.
+ * @param language The natural language to get labels for.
+ * @param shard The shard of the split's entities and properties to work on.
+ * @param all_labels The labels obtained so far, as a JSON object.
+ * @param quiet Whether to report how many labels were taken from the cache
+ *   (`false`) or not (`true`).
+ * @return The entities and properties that still require labelling, in the
+ *   order of `ent_prp_ids`.
  */
-void perform_wikidata_entity_and_property_labels_request(curlpp::Easy &request) {
-    std::optional<size_t> res_code = std::nullopt;
-    do {
-        if (res_code.has_value() && res_code == 429) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(too_many_requests_seconds_to_wait * 1000));
-        } else if (res_code.has_value()) {
-            throw std::runtime_error(std::string("Received response code ") +
-                                     std::to_string(res_code.value()) +
-                                     " from WikiData. Aborting.");
+std::vector<WikiData::symbol_id> entities_and_properties_labelled_from_cache(
+        const std::vector<WikiData::symbol_id> &ent_prp_ids,
+        const Caching::LabelResponseCache &label_cache,
+        const LCQuADSplit &split,
+        const NaturalLanguage &language,
+        const Shard &shard,
+        Json::Value &all_labels,
+        bool quiet) {
+    std::vector<WikiData::symbol_id> uncached;
+    Json::Value cached_labels = Json::objectValue;
+    for (const auto &ent_or_prp : ent_prp_ids) {
+        const std::vector<std::string> *labels = label_cache.fresh_labels(ent_or_prp, language);
+        if (labels == nullptr) {
+            uncached.push_back(ent_or_prp);
+            continue;
+        }
+        Json::Value labels_json = Json::arrayValue;
+        for (const auto &label : *labels) {
+            labels_json.append(label);
+        }
+        cached_labels[WikiData::string_from_symbol_id(ent_or_prp)] = std::move(labels_json);
+    }
+    static Tracing::Counter &labels_from_cache = Tracing::counter("labelling.symbols-from-cache");
+    labels_from_cache.add(static_cast<std::int64_t>(cached_labels.size()));
+    if (!cached_labels.empty()) {
+        save_entity_and_property_labels(cached_labels, split, language, shard);
+        for (const auto &ent_or_prp : cached_labels.getMemberNames()) {
+            all_labels[ent_or_prp] = cached_labels[ent_or_prp];
         }
-        request.perform();
-        res_code = curlpp::Infos::ResponseCode::get(request);
-    } while (res_code.has_value() && res_code.value() != 200);
-    std::this_thread::sleep_for(std::chrono::milliseconds(query_interval_seconds_to_wait * 1000));
+    }
+    if (!quiet) {
+        std::cout << "(Took " << cached_labels.size() << " symbols' labels from the label cache.)" << std::endl;
+    }
+    return uncached;
 }
 
 /**
- * @brief Returns the labels in `language` for the specified set of entities
- *   and properties, `ent_prp_part`.
- *
- * @param ent_prp_part An entity-and-property part of a partition.
- * @param language The natural language to get the labels in.
- * @return A mapping from entities and properties to arrays of zero or more
- *   labels in the required `language`.
+ * @brief A response to a labelling query, as fetched from WikiData.
  */
-Json::Value entity_and_property_labels_of_part(const std::set<std::string> &ent_prp_part,
-                                               const NaturalLanguage &language) {
-    curlpp::Easy request;
-    set_wikidata_request_headers(request, ent_prp_part, language);
-    perform_wikidata_entity_and_property_labels_request(request);
+struct FetchedLabelsPart {
+    std::vector<WikiData::symbol_id> ent_prp_part;
+    std::string body;
+};
 
-    std::stringstream result;
-    result << request;
-    Json::Value json;
-    result >> json;
+/**
+ * @brief The labels of the entities and properties of a labelling query, as
+ *   parsed from its response.
+ */
+struct ParsedLabelsPart {
+    /**
+     * @brief The number of entities and properties the query was for.
+     */
+    std::size_t part_size;
+    Json::Value labels;
+};
 
-    return restructured_wikidata_entity_and_property_labels(ent_prp_part, json["results"]["bindings"]);
+/**
+ * @brief The number of labelling responses that may wait to be parsed, and
+ *   the number of parsed responses that may wait to be saved, per in-flight
+ *   query.
+ */
+const std::size_t labelling_queue_capacity_per_query = 2;
+
+/**
+ * @brief Parses the labelling responses popped from `fetched`, and pushes the
+ *   labels to `parsed`, until `fetched` is closed and empty or `parsed` is
+ *   closed. Serves as the parsing stage of labelling.
+ *
+ * @param fetched The responses to parse.
+ * @param parsed The queue to push the labels to.
+ */
+void parse_labels_parts(Concurrency::BoundedQueue<FetchedLabelsPart> &fetched,
+                        Concurrency::BoundedQueue<ParsedLabelsPart> &parsed) {
+    for (std::optional<FetchedLabelsPart> part = fetched.pop(); part.has_value(); part = fetched.pop()) {
+        const Tracing::Stage stage("parse labels");
+        ParsedLabelsPart parsed_part { part->ent_prp_part.size(),
+                                       entity_and_property_labels_of_part(part->ent_prp_part, part->body) };
+        if (!parsed.push(std::move(parsed_part))) {
+            return;  /* The saver has stopped. */
+        }
+    }
+}
+
+/**
+ * @brief Saves the labels popped from `parsed` to the labels log and the label
+ *   cache, and adds them to `all_labels`, until `parsed` is closed and empty.
+ *   Serves as the saving stage of labelling.
+ *
+ * All labels that are waiting by the time the saver gets to them are saved
+ * together, in a single record of the labels log and of the cache.
+ *
+ * @param parsed The labels to save.
+ * @param split The LC-QuAD 2.0 dataset split to work on.
+ * @param language The natural language of the labels.
+ * @param shard The shard of the split's entities and properties to work on.
+ * @param label_cache A cache of labels shared by all splits, or null to not
+ *   use one.
+ * @param require_labelling The number of entities and properties to label in
+ *   total, for reporting progress.
+ * @param quiet Whether to report on progress (`false`) or not (`true`).
+ * @param all_labels The labels obtained so far, as a JSON object.
+ */
+void save_labels_parts(Concurrency::BoundedQueue<ParsedLabelsPart> &parsed,
+                       const LCQuADSplit &split,
+                       const NaturalLanguage &language,
+                       const Shard &shard,
+                       Caching::LabelResponseCache *label_cache,
+                       std::size_t require_labelling,
+                       bool quiet,
+                       Json::Value &all_labels) {
+    static Tracing::Counter &labels_fetched = Tracing::counter("labelling.symbols-fetched");
+    std::size_t labelled = 0;
+    for (std::optional<ParsedLabelsPart> part = parsed.pop(); part.has_value(); part = parsed.pop()) {
+        const Tracing::Stage stage("save labels");
+        Json::Value labels = std::move(part->labels);
+        std::size_t part_size = part->part_size;
+        for (std::optional<ParsedLabelsPart> next = parsed.try_pop(); next.has_value(); next = parsed.try_pop()) {
+            for (const auto &ent_or_prp : next->labels.getMemberNames()) {
+                labels[ent_or_prp] = std::move(next->labels[ent_or_prp]);
+            }
+            part_size += next->part_size;
+        }
+        save_entity_and_property_labels(labels, split, language, shard);
+        if (label_cache != nullptr) {
+            label_cache->store(labels, language);
+        }
+        for (const auto &ent_or_prp : labels.getMemberNames()) {
+            all_labels[ent_or_prp] = labels[ent_or_prp];
+        }
+        labelled += part_size;
+        labels_fetched.add(static_cast<std::int64_t>(part_size));
+        if (!quiet) {
+            printf("\rRetrieved labels for %7zu/%7zu entities and properties (%6.2lf%%)",
+                   labelled,
+                   require_labelling,
+                   (static_cast<double>(labelled) / static_cast<double>(require_labelling)) * 100.);
+            std::cout << std::flush;
+        }
+    }
 }
 
 /**
- * @brief Retrieves labels for WikiData entities and properties, serving a
- *   backend to `label_entities_and_properties`.
+ * @brief The largest number of entities and properties to label in a single
+ *   WikiData query, unless `--part-size` asks for more.
+ */
+const int max_labelling_batch_size = 1000;
+
+/**
+ * @brief Retrieves labels for the WikiData entities and properties
+ *   `ent_prp_total` that have not been labelled yet, and returns the labels
+ *   of all of them.
  *
+ * Entities and properties are labelled in batches, with up to `in_flight`
+ * queries in flight at once; whenever a query completes, the next batch is
+ * queried for straight away, so that no query waits for slower ones. Each
+ * batch's labels are appended to the labels log as soon as they arrive, so
+ * that an interrupted run resumes where it left off; once all entities and
+ * properties are labelled, the log is compacted. Responses are parsed on one
+ * thread and saved on another, fed through bounded queues, so that fetching
+ * continues meanwhile; if either falls behind, handing on new responses waits
+ * for it. An `AdaptiveBatchSizer` adapts the size of each next batch to the
+ * observed query latencies. Batches whose query times out or fails on the
+ * server's side are split up again, and retried as smaller batches.
+ *
+ * @param ent_prp_total The entities and properties to label, sorted and
+ *   without duplicates.
  * @param split The LC-QuAD 2.0 dataset split to work on.
  * @param language The natural language to get labels for.
  * @param part_size The number of entities and properties to obtain labels for
- *   before saving to disk. The smaller, the more frequently is saved, but the
- *   slower the program runs.
+ *   in the first queries. Later queries adapt this number. Minimally 1.
+ * @param in_flight The number of WikiData queries to have in flight at once.
+ *   Minimally 1.
  * @param quiet Whether to report on progress (`false`) or not (`true`).
+ * @param label_cache A cache of labels shared by all splits, or null to not
+ *   use one. Entities and properties with unexpired labels in the cache are
+ *   labelled from it rather than queried for; labels fetched from WikiData are
+ *   added to it.
+ * @param shard The shard of `ent_prp_total` to label. Its labels are stored in
+ *   files of their own, which the `merge-shards` task later merges.
+ * @return The labels of all stored entities and properties of `split`,
+ *   `language` and `shard`, both those labelled earlier and those labelled
+ *   now, as a JSON object.
  */
-void label_entity_property_partitions_backend(const LCQuADSplit &split,
-                                              const NaturalLanguage &language,
-                                              int part_size,
-                                              bool quiet) {
-    std::set<std::string> require_labelling = entities_and_properties_requiring_labeling(split, language);
-    ent_prp_partitioning partitioning = entity_property_partitioning(require_labelling, part_size);
-    int count = 0;
+Json::Value DutchKBQADSCreate::labelled_entities_and_properties(const std::vector<WikiData::symbol_id> &ent_prp_total,
+                                                                const LCQuADSplit &split,
+                                                                const NaturalLanguage &language,
+                                                                int part_size,
+                                                                int in_flight,
+                                                                bool quiet,
+                                                                Caching::LabelResponseCache *label_cache,
+                                                                const Shard &shard) {
+    if (part_size < 1) {
+        throw std::invalid_argument(std::string("Part size ") +
+                                    std::to_string(part_size) +
+                                    " is inappropriate: it must be at least 1.");
+    }
+    const Tracing::Stage stage("label entities and properties");
+    static Tracing::Counter &batches_split = Tracing::counter("labelling.batches-split");
+    const auto [shard_start, shard_end] = shard.bounds(ent_prp_total.size());
+    const std::vector<WikiData::symbol_id> ent_prp_shard(ent_prp_total.begin() + shard_start,
+                                                         ent_prp_total.begin() + shard_end);
+    Json::Value all_labels = loaded_json_entity_and_property_labels(split, language, shard);
+    std::vector<WikiData::symbol_id> require_labelling = entities_and_properties_requiring_labeling(ent_prp_shard,
+                                                                                                   all_labels);
+    if (label_cache != nullptr) {
+        require_labelling = entities_and_properties_labelled_from_cache(require_labelling,
+                                                                        *label_cache,
+                                                                        split,
+                                                                        language,
+                                                                        shard,
+                                                                        all_labels,
+                                                                        quiet);
+    }
+    std::deque<WikiData::symbol_id> remaining(require_labelling.begin(), require_labelling.end());
+    WikiData::AdaptiveBatchSizer sizer(part_size, 1, std::max(part_size, max_labelling_batch_size));
+    WikiData::FetcherSettings settings;
+    settings.max_in_flight = in_flight;
+    WikiData::QueryFetcher fetcher(settings);
     if (!quiet) {
         std::cout << "\rStarting with labelling entities and properties...";
         std::cout << std::flush;
     }
-    for (const auto &part : partitioning) {
-        Json::Value labels = entity_and_property_labels_of_part(part, language);
-        save_entity_and_property_labels(labels, split, language);
-        if (!quiet) {
-            printf("\rRetrieved labels for part %5d/%5d (%6.2lf%%)",
-                   count + 1,
-                   static_cast<int>(partitioning.size()),
-                   ((count + 1.) / static_cast<float>(partitioning.size())) * 100.);
-            std::cout << std::flush;
+
+    /* Fetch on this thread, and parse and save on two others, so that no new
+     * queries wait for earlier responses to be parsed and saved. */
+    Concurrency::BoundedQueue<FetchedLabelsPart> fetched(labelling_queue_capacity_per_query *
+                                                         static_cast<std::size_t>(in_flight));
+    Concurrency::BoundedQueue<ParsedLabelsPart> parsed(labelling_queue_capacity_per_query *
+                                                       static_cast<std::size_t>(in_flight));
+    std::exception_ptr parser_error;
+    std::exception_ptr saver_error;
+    std::thread parser([&] () -> void {
+        try {
+            parse_labels_parts(fetched, parsed);
+        } catch (...) {
+            parser_error = std::current_exception();
+        }
+        fetched.close();
+        parsed.close();
+    });
+    std::thread saver([&] () -> void {
+        try {
+            save_labels_parts(parsed, split, language, shard, label_cache, require_labelling.size(), quiet, all_labels);
+        } catch (...) {
+            saver_error = std::current_exception();
+        }
+        parsed.close();
+        fetched.close();
+    });
+    std::exception_ptr fetcher_error;
+    try {
+        /* The batches by query index. A batch is emptied once it needs no
+         * (re)fetching any more. */
+        ent_prp_partitioning batches;
+        auto next_query = [&] (std::size_t index) -> std::optional<std::string> {
+            /* Batches are made up only once a query slot is free, so that
+             * each takes the batch size adapted to all latencies so far. */
+            if (remaining.empty()) {
+                return std::nullopt;
+            }
+            std::vector<WikiData::symbol_id> batch;
+            while (static_cast<int>(batch.size()) < sizer.batch_size() && !remaining.empty()) {
+                batch.push_back(remaining.front());
+                remaining.pop_front();
+            }
+            batches.push_back(std::move(batch));
+            return wikidata_labelling_query_for_entities_and_properties(batches[index], language);
+        };
+        auto on_response = [&] (std::size_t index, const std::string &body, std::chrono::milliseconds latency) {
+            /* Batches complete in any order; each is handed on as soon as it
+             * arrives, waiting only if the parser falls behind. */
+            sizer.register_success(static_cast<int>(batches[index].size()), latency);
+            if (!fetched.push({ std::move(batches[index]), body })) {
+                throw std::runtime_error("Stopped labelling, as parsing or saving labels failed.");
+            }
+            batches[index].clear();
+        };
+        auto on_failure = [&] (std::size_t index, [[maybe_unused]] const std::string &reason) -> bool {
+            sizer.register_failure(static_cast<int>(batches[index].size()));
+            if (batches[index].size() == 1) {
+                return true;  /* This batch can't be split any further: retry it as-is. */
+            }
+            remaining.insert(remaining.begin(), batches[index].begin(), batches[index].end());
+            batches[index].clear();
+            batches_split.add();
+            return false;
+        };
+        fetcher.fetch(next_query, on_response, on_failure);
+    } catch (...) {
+        fetcher_error = std::current_exception();
+    }
+    /* Let the parser and saver finish the responses fetched so far, even if
+     * fetching failed, so that a restarted run need not fetch them again. */
+    fetched.close();
+    parser.join();
+    saver.join();
+    for (const auto &error : { parser_error, saver_error, fetcher_error }) {
+        if (error) {
+            std::rethrow_exception(error);
         }
-        count++;
     }
+    if (dataset_file_exists(entity_and_property_labels_relative_path(split, language, shard) + ".jsonl")) {
+        compact_entity_and_property_labels(all_labels, split, language, shard);
+    }
+    if (label_cache != nullptr && label_cache->worth_compacting()) {
+        label_cache->compact();
+    }
+    return all_labels;
+}
+
+/**
+ * @brief Folds the labels log of an LC-QuAD 2.0 dataset split into its
+ *   compacted entity-and-property labels file.
+ *
+ * Labelling compacts its labels log by itself once it completes, so this is
+ * only needed after an interrupted labelling run that will not be resumed.
+ *
+ * @param vm The variables map with which to determine which LC-QuAD 2.0
+ *   dataset split, and labels in which natural language, to compact, and
+ *   optionally of which shard.
+ */
+void DutchKBQADSCreate::compact_entity_and_property_labels(const po::variables_map &vm) {
+    if (vm.count("split") == 0) {
+        throw std::invalid_argument(std::string(R"(The "--split" flag )") +
+                                    "is required.");
+    } else if (vm.count("language") == 0) {
+        throw std::invalid_argument(std::string(R"(The "--language" flag )") +
+                                    "is required.");
+    }
+    const LCQuADSplit split = string_to_lc_quad_split_map.at(vm["split"].as<std::string>());
+    const NaturalLanguage language = string_to_natural_language_map.at(vm["language"].as<std::string>());
+    compact_entity_and_property_labels(split, language, requested_shard(vm));
+}
+
+/**
+ * @brief Returns the label cache requested by the command-line flags
+ *   `--label-cache` and `--label-cache-ttl`.
+ *
+ * @param vm The variables map with which to determine whether to use a label
+ *   cache, and after how many days its labels expire.
+ * @return The cache, or null if no cache should be used.
+ */
+std::unique_ptr<Caching::LabelResponseCache> DutchKBQADSCreate::opened_label_cache(const po::variables_map &vm) {
+    if (vm.count("label-cache") != 0 && !vm["label-cache"].as<bool>()) {
+        return nullptr;
+    }
+    const int ttl_days = vm.count("label-cache-ttl") == 0 ? 0 : vm["label-cache-ttl"].as<int>();
+    if (ttl_days < 0) {
+        throw std::invalid_argument(std::string("The label cache TTL must be at least 0 days, but is ") +
+                                    std::to_string(ttl_days) +
+                                    ".");
+    }
+    return std::make_unique<Caching::LabelResponseCache>(std::chrono::hours(24 * ttl_days));
 }
 
 /**
@@ -452,8 +1036,10 @@ void label_entity_property_partitions_backend(const LCQuADSplit &split,
  * @param vm The variables map with which to determine how to approach the
  *   labelling operation. It determines which LC-QuAD 2.0 dataset split to
  *   collect entity-and-property labels for, in what natural language the
- *   labels should be expressed, how often to save to disk, and whether to
- *   report progress.
+ *   labels should be expressed, how many entities and properties to start
+ *   labelling per query, how many queries to have in flight at once,
+ *   whether to report progress, and optionally which shard of the entities
+ *   and properties to label.
  */
 void DutchKBQADSCreate::label_entities_and_properties(const po::variables_map &vm) {
     if (vm.count("split") == 0) {
@@ -472,6 +1058,16 @@ void DutchKBQADSCreate::label_entities_and_properties(const po::variables_map &v
     const LCQuADSplit split = string_to_lc_quad_split_map.at(vm["split"].as<std::string>());
     const NaturalLanguage language = string_to_natural_language_map.at(vm["language"].as<std::string>());
     const int part_size = vm["part-size"].as<int>();
+    const int in_flight = vm.count("in-flight") == 0 ? 1 : vm["in-flight"].as<int>();
     const bool quiet = vm["quiet"].as<bool>();
-    label_entity_property_partitions_backend(split, language, part_size, quiet);
+    const Shard shard = requested_shard(vm);
+    std::unique_ptr<Caching::LabelResponseCache> label_cache = opened_label_cache(vm);
+    labelled_entities_and_properties(unique_entities_and_properties_of_split(split),
+                                     split,
+                                     language,
+                                     part_size,
+                                     in_flight,
+                                     quiet,
+                                     label_cache.get(),
+                                     shard);
 }
@@ -1,10 +1,19 @@
 /* Symbols for masking question-answer pairs. */
 
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <utility>
 #include <cassert>
-#include <regex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <exception>
+#include <unordered_map>
+#include <unordered_set>
 #include "tasks/mask-question-answer-pairs.hpp"
+#include "caching/masking-manifest.hpp"
+#include "tracing/tracer.hpp"
 #include "tasks/collect-entities-properties.hpp"
 #include "tasks/label-entities-properties.hpp"
 #include "utilities.hpp"
@@ -34,31 +43,15 @@ DutchKBQADSCreate::QuestionAnswerPair::QuestionAnswerPair(int uid,
  *   question the matching operation was performed in.
  * @param ent_or_prp The entity or property associated with this label.
  */
-DutchKBQADSCreate::LabelMatch::LabelMatch(const std::string &label,
+DutchKBQADSCreate::LabelMatch::LabelMatch(std::string_view label,
                                           const index_range &match_bounds,
-                                          const std::string &ent_or_prp) {
+                                          WikiData::symbol_id ent_or_prp) {
     this->ent_or_prp = ent_or_prp;
     this->label = label;
     this->match_bounds = match_bounds;
 }
 
 
-std::optional<index_range> DutchKBQADSCreate::LabelMatch::match_label_in_sentence(const std::string &label,
-                                                                                  const std::string &sentence) {
-    std::string inner_re = label;
-    inner_re = std::regex_replace(inner_re, std::regex("(\\[)"), "\\[");
-    inner_re = std::regex_replace(inner_re, std::regex("(\\])"), "\\]");
-    std::regex re("(" + inner_re + ")");
-    std::smatch label_re_match;
-    if (std::regex_search(sentence, label_re_match, re)) {
-        int start_idx = static_cast<int>(label_re_match.position(0));
-        return index_range(start_idx, start_idx + label_re_match.length(0) - 1);
-    } else {
-        return std::nullopt;
-    }
-}
-
-
 /**
  * @brief Compares this label match against another, determining whether this
  *   match appears earlier in the matched-against string than `other`.
@@ -137,37 +130,45 @@ bool DutchKBQADSCreate::LabelMatch::collision_present_in_label_matches(std::vect
 const std::string variant_suffix = "replaced-no-errors";
 
 /**
- * @brief Returns the translated questions as a JSON object loaded from disk.
+ * @brief Returns the translated questions loaded from disk, keyed by their
+ *   UIDs.
+ *
+ * The questions are read one at a time, so that only their strings are held
+ * in memory, not a JSON representation of the entire file.
  *
  * @param split The LC-QuAD 2.0 dataset split to target.
  * @param language The natural language in which the questions must have been
  *   translated.
- * @return The translated questions as a JSON object.
+ * @return The translated questions.
  */
-Json::Value translated_questions_json(const LCQuADSplit &split,
-                                      const NaturalLanguage &language) {
+std::unordered_map<std::string, std::string> translated_questions(const LCQuADSplit &split,
+                                                                  const NaturalLanguage &language) {
     std::string file_name = string_from_lc_quad_split(split) +
                             "-" +
                             string_from_natural_language(language) +
                             "-" +
                             variant_suffix;
-    Json::Value json = json_loaded_from_dataset_file(file_name);
-    return json;
+    std::unordered_map<std::string, std::string> questions;
+    JsonRecordReader reader(file_name);
+    std::string uid_str;
+    Json::Value question;
+    while (reader.next(uid_str, question)) {
+        questions.insert({ uid_str, question.asString() });
+    }
+    return questions;
 }
 
 /**
- * @brief Returns the original LC-QuAD 2.0 dataset split (which includes both
- *   questions and answers) as a JSON object loaded from disk.
+ * @brief Returns the file name of the original LC-QuAD 2.0 dataset split,
+ *   which includes both questions and answers.
  *
  * @param split The LC-QuAD 2.0 dataset split to target.
- * @return The translated questions as a JSON object.
+ * @return The file name. Without `.json` file extension.
  */
-Json::Value original_questions_and_answers_json(const LCQuADSplit &split) {
-    std::string file_name = string_from_lc_quad_split(split) +
-                            "-" +
-                            string_from_natural_language(NaturalLanguage::ENGLISH);
-    Json::Value json = json_loaded_from_dataset_file(file_name);
-    return json;
+std::string original_questions_and_answers_file_name(const LCQuADSplit &split) {
+    return string_from_lc_quad_split(split) +
+           "-" +
+           string_from_natural_language(NaturalLanguage::ENGLISH);
 }
 
 /**
@@ -183,52 +184,210 @@ Json::Value original_questions_and_answers_json(const LCQuADSplit &split) {
  */
 std::vector<QuestionAnswerPair> DutchKBQADSCreate::question_answer_pairs(const LCQuADSplit &split,
                                                                          const NaturalLanguage &language) {
+    const Tracing::Stage stage("load question-answer pairs");
     std::vector<QuestionAnswerPair> pairs;
-    const Json::Value trl_q = translated_questions_json(split, language);
-    const Json::Value ori_qa = original_questions_and_answers_json(split);
-    for (const auto &qa : ori_qa) {
+    std::unordered_map<std::string, std::string> trl_q = translated_questions(split, language);
+    JsonRecordReader ori_qa(original_questions_and_answers_file_name(split));
+    Json::Value qa;
+    while (ori_qa.next(qa)) {
         int uid = qa["uid"].asInt();
-        const std::string uid_str = std::to_string(uid);
+        auto trl_q_it = trl_q.find(std::to_string(uid));
+        /* Like indexing a JSON object, treat an untranslated question as empty. */
+        std::string question = trl_q_it == trl_q.end() ? "" : std::move(trl_q_it->second);
         pairs.emplace_back(QuestionAnswerPair(uid,
-                                              trl_q[uid_str].asString(),
+                                              std::move(question),
                                               qa["sparql_wikidata"].asString()));
     }
     return pairs;
 }
 
+/**
+ * @brief Constructs an index over the labels of entities and properties.
+ *
+ * @param ent_prp_labels The labels of zero or more entities and properties.
+ *   Typically, this is the store returned by
+ *   `loaded_entity_and_property_labels`. The index does not refer to it once
+ *   constructed.
+ */
+DutchKBQADSCreate::LabelIndex::LabelIndex(const LabelStore &ent_prp_labels) {
+    const Tracing::Stage stage("build label index");
+    static Tracing::Counter &automaton_compiles = Tracing::counter("label-index.automaton-compiles");
+    static Tracing::Counter &automaton_patterns = Tracing::counter("label-index.automaton-patterns");
+    this->symbols.reserve(ent_prp_labels.number_of_symbols());
+    this->first_label_pattern.reserve(ent_prp_labels.number_of_symbols() + 1);
+    this->label_pattern_ids.reserve(ent_prp_labels.number_of_labels());
+    for (std::size_t idx = 0; idx < ent_prp_labels.number_of_symbols(); idx++) {
+        this->symbols.push_back(ent_prp_labels.symbol(idx));
+        this->first_label_pattern.push_back(static_cast<std::uint32_t>(this->label_pattern_ids.size()));
+        const LabelList labels = ent_prp_labels.labels_at(idx);
+        for (std::size_t label_idx = 0; label_idx < labels.size(); label_idx++) {
+            const std::string_view label = labels[label_idx];
+            /* Empty labels can never be matched. */
+            this->label_pattern_ids.push_back(label.empty() ?
+                                              StringMatching::no_automaton_entry :
+                                              this->automaton.add_pattern(std::string(label)));
+        }
+    }
+    this->first_label_pattern.push_back(static_cast<std::uint32_t>(this->label_pattern_ids.size()));
+    this->automaton.compile();
+    automaton_compiles.add();
+    automaton_patterns.add(static_cast<std::int64_t>(this->label_pattern_ids.size()));
+}
+
+/**
+ * @brief Returns the first occurrence of every indexed label that occurs in
+ *   `sentence`.
+ *
+ * @param sentence The sentence to search in.
+ * @return A mapping from the labels' pattern IDs to their first occurrences.
+ */
+StringMatching::first_pattern_matches DutchKBQADSCreate::LabelIndex::label_occurrences_in_sentence(
+        const std::string &sentence) const {
+    return this->automaton.first_matches(sentence);
+}
+
+/**
+ * @brief Returns the label matches of all labels of the entity or property
+ *   `ent_or_prp`, ordered as the labels themselves are.
+ *
+ * @param ent_or_prp The entity or property.
+ * @param occurrences The label occurrences within some sentence, as returned by
+ *   `label_occurrences_in_sentence`.
+ * @return The label matches, whose labels view into this index. Labels that do
+ *   not occur in the sentence have
+ *   their `match_bounds` set to `{ no_label_match_pos, no_label_match_pos }`.
+ *   If `ent_or_prp` isn't indexed, it is treated as if it has no labels.
+ */
+std::vector<LabelMatch> DutchKBQADSCreate::LabelIndex::label_matches_for_entity_or_property(
+        WikiData::symbol_id ent_or_prp,
+        const StringMatching::first_pattern_matches &occurrences) const {
+    std::vector<LabelMatch> label_matches;
+    const auto it = std::lower_bound(this->symbols.begin(), this->symbols.end(), ent_or_prp);
+    if (it == this->symbols.end() || *it != ent_or_prp) {
+        return label_matches;
+    }
+    const std::size_t symbol_idx = it - this->symbols.begin();
+    for (std::uint32_t idx = this->first_label_pattern[symbol_idx];
+         idx < this->first_label_pattern[symbol_idx + 1];
+         idx++) {
+        const int pattern_id = this->label_pattern_ids[idx];
+        const auto occurrence = occurrences.find(pattern_id);
+        if (occurrence == occurrences.end()) {
+            std::pair<int, int> empty_match_bounds = { no_label_match_pos, no_label_match_pos };
+            label_matches.emplace_back(pattern_id == StringMatching::no_automaton_entry ?
+                                       std::string_view() :
+                                       std::string_view(this->automaton.pattern(pattern_id)),
+                                       empty_match_bounds,
+                                       ent_or_prp);
+        } else {
+            label_matches.emplace_back(this->automaton.pattern(pattern_id), occurrence->second, ent_or_prp);
+        }
+    }
+    return label_matches;
+}
+
+/**
+ * @brief Returns the match of the first label of the entity or property
+ *   `ent_or_prp` that occurs in a sentence; that is, the match that
+ *   `LabelMatch::best_label_match` would select from the result of
+ *   `label_matches_for_entity_or_property`, but without materialising the
+ *   matches of the other labels.
+ *
+ * @param ent_or_prp The entity or property.
+ * @param occurrences The label occurrences within some sentence, as returned by
+ *   `label_occurrences_in_sentence`.
+ * @return The label match, whose label views into this index, or null if none
+ *   of the labels of `ent_or_prp` occurs in the sentence.
+ */
+std::optional<LabelMatch> DutchKBQADSCreate::LabelIndex::first_label_match_for_entity_or_property(
+        WikiData::symbol_id ent_or_prp,
+        const StringMatching::first_pattern_matches &occurrences) const {
+    const auto it = std::lower_bound(this->symbols.begin(), this->symbols.end(), ent_or_prp);
+    if (it == this->symbols.end() || *it != ent_or_prp) {
+        return std::nullopt;
+    }
+    const std::size_t symbol_idx = it - this->symbols.begin();
+    for (std::uint32_t idx = this->first_label_pattern[symbol_idx];
+         idx < this->first_label_pattern[symbol_idx + 1];
+         idx++) {
+        const int pattern_id = this->label_pattern_ids[idx];
+        const auto occurrence = occurrences.find(pattern_id);
+        if (occurrence != occurrences.end()) {
+            return LabelMatch(this->automaton.pattern(pattern_id), occurrence->second, ent_or_prp);
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Returns the closest approximate match of any label of the entity or
+ *   property `ent_or_prp` in a sentence, provided that it is close enough.
+ *
+ * Of the labels whose approximate matches are equally close, the first is
+ * chosen, as `first_label_match_for_entity_or_property` does for exact
+ * matches.
+ *
+ * @param ent_or_prp The entity or property.
+ * @param matcher A matcher for approximate occurrences in the sentence.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its match. See `StringMatching::ApproximateMatcher::best_match`.
+ * @return The label match, whose label views into this index, or null if none
+ *   of the labels of `ent_or_prp` approximately occurs in the sentence.
+ */
+std::optional<LabelMatch> DutchKBQADSCreate::LabelIndex::approximate_label_match_for_entity_or_property(
+        WikiData::symbol_id ent_or_prp,
+        const StringMatching::ApproximateMatcher &matcher,
+        int max_edit_distance) const {
+    const auto it = std::lower_bound(this->symbols.begin(), this->symbols.end(), ent_or_prp);
+    if (it == this->symbols.end() || *it != ent_or_prp) {
+        return std::nullopt;
+    }
+    const std::size_t symbol_idx = it - this->symbols.begin();
+    std::optional<LabelMatch> best;
+    int best_distance = max_edit_distance + 1;
+    for (std::uint32_t idx = this->first_label_pattern[symbol_idx];
+         idx < this->first_label_pattern[symbol_idx + 1] && best_distance > 0;
+         idx++) {
+        const int pattern_id = this->label_pattern_ids[idx];
+        if (pattern_id == StringMatching::no_automaton_entry) {
+            continue;
+        }
+        const std::string &label = this->automaton.pattern(pattern_id);
+        const std::optional<StringMatching::ApproximateMatch> match = matcher.best_match(label,
+                                                                                         best_distance - 1);
+        if (match.has_value()) {
+            best.emplace(label, match->bounds, ent_or_prp);
+            best->is_approximate = true;
+            best_distance = match->distance;
+        }
+    }
+    return best;
+}
+
 /**
  * @brief Returns the label to use for this combination of question and entity
  *   or property, or null if no appropriate label can be found.
  *
- * @param question The question.
  * @param ent_or_prp The entity or property.
- * @param labels The labels for `ent_or_prp`.
+ * @param label_index An index over the labels of all entities and properties.
+ * @param occurrences The occurrences of labels in the question, as returned by
+ *   `label_index.label_occurrences_in_sentence`.
  * @param map A mapping from entities and properties to labels. The entities
  *   and properties that previously have already received a label.
  * @return The label to use, or a null value if no appropriate label could be
  *   found.
  */
-ent_or_prp_chosen_label DutchKBQADSCreate::selected_label_for_entity_or_property(const std::string &question,
-                                                                                 const std::string &ent_or_prp,
-                                                                                 const std::vector<std::string> &labels,
-                                                                                 const ent_prp_chosen_label_map &map) {
-    if (labels.empty()) {
-        /* No labels exist for this entity or property. Skip. */
-        return std::nullopt;
-    }
-    std::vector<LabelMatch> label_matches;
-    for (const auto &label : labels) {
-        std::optional<index_range> match_bounds = LabelMatch::match_label_in_sentence(label, question);
-        if (!match_bounds.has_value()) {
-            std::pair<int, int> empty_match_bounds = { no_label_match_pos, no_label_match_pos };
-            label_matches.emplace_back(label, empty_match_bounds, ent_or_prp);
-        } else {
-            label_matches.emplace_back(label, match_bounds.value(), ent_or_prp);
-        }
-    }
-    std::optional<LabelMatch> best = LabelMatch::best_label_match(label_matches);
+ent_or_prp_chosen_label DutchKBQADSCreate::selected_label_for_entity_or_property(
+        WikiData::symbol_id ent_or_prp,
+        const LabelIndex &label_index,
+        const StringMatching::first_pattern_matches &occurrences,
+        const ent_prp_chosen_label_map &map) {
+    /* Only the selected match is constructed, so that selecting a label does
+     * not allocate, however many labels `ent_or_prp` has. */
+    std::optional<LabelMatch> best = label_index.first_label_match_for_entity_or_property(ent_or_prp,
+                                                                                          occurrences);
     if (best.has_value()) {
-        return std::pair<std::string, LabelMatch>(ent_or_prp, best.value());
+        return std::pair<WikiData::symbol_id, LabelMatch>(ent_or_prp, best.value());
     } else {
         return std::nullopt;
     }
@@ -239,26 +398,49 @@ ent_or_prp_chosen_label DutchKBQADSCreate::selected_label_for_entity_or_property
  *   present in a questions, or null if one or more entities or properties
  *   could not be assigned an appropriate label.
  *
+ * The question is scanned only once, regardless of the number of labels its
+ * entities and properties have. If `max_edit_distance` is positive, entities
+ * and properties none of whose labels occur in the question exactly are
+ * matched approximately instead, so that, for example, an inflected label can
+ * still be masked. This takes a pass over the question per label of those
+ * entities and properties.
+ *
  * @param question The question.
  * @param entities_properties The question's entities and properties.
- * @param ent_prp_labels A mapping from entities and properties to zero or more
- *   labels.
+ * @param label_index An index over the labels of all entities and properties.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly.
  * @return For each entity and property of the question, a single (substring of a)
  *   label, representing the selected label. Null is returned if one or more
  *   entities or properties could not be assigned a satisfactory label.
  */
 ent_prp_chosen_label_map DutchKBQADSCreate::selected_labels_for_entities_and_properties(
         const std::string &question,
-        const std::set<std::string> &entities_properties,
-        const DutchKBQADSCreate::ent_prp_label_map &ent_prp_labels) {
-    ent_prp_chosen_label_map map = std::map<std::string, LabelMatch>();
+        const std::vector<WikiData::symbol_id> &entities_properties,
+        const LabelIndex &label_index,
+        int max_edit_distance) {
+    ent_prp_chosen_label_map map = std::map<WikiData::symbol_id, LabelMatch>();
+    const StringMatching::first_pattern_matches occurrences = label_index.label_occurrences_in_sentence(question);
+    /* Only decode the question for approximate matching once it is needed. */
+    std::optional<StringMatching::ApproximateMatcher> approximate_matcher;
     for (const auto &ent_or_prp : entities_properties) {
         /* Try to associate entities and properties to appropriate labels. */
-        const std::vector<std::string> &ent_or_prp_labels = ent_prp_labels.at(ent_or_prp);
-        ent_or_prp_chosen_label label = selected_label_for_entity_or_property(question,
-                                                                              ent_or_prp,
-                                                                              ent_or_prp_labels,
+        ent_or_prp_chosen_label label = selected_label_for_entity_or_property(ent_or_prp,
+                                                                              label_index,
+                                                                              occurrences,
                                                                               map);
+        if (!label.has_value() && max_edit_distance > 0) {
+            if (!approximate_matcher.has_value()) {
+                approximate_matcher.emplace(question);
+            }
+            std::optional<LabelMatch> approximate_match =
+                label_index.approximate_label_match_for_entity_or_property(ent_or_prp,
+                                                                           approximate_matcher.value(),
+                                                                           max_edit_distance);
+            if (approximate_match.has_value()) {
+                label = std::pair<WikiData::symbol_id, LabelMatch>(ent_or_prp, approximate_match.value());
+            }
+        }
         if (label.has_value()) {
             map->insert(label.value());
         } else {
@@ -274,70 +456,116 @@ ent_prp_chosen_label_map DutchKBQADSCreate::selected_labels_for_entities_and_pro
 }
 
 /**
- * @brief Masks a single label within the supplied question, given the current
- *   states of the entity- and property counters and the already-existent
- *   mask names for entities and properties masked earlier on in the masking
- *   process.
+ * @brief Returns the mask of an entity or property, given the current states
+ *   of the entity- and property counters and the already-existent masks for
+ *   entities and properties masked earlier on in the masking process.
  *
- * @param q The question in which to replace.
- * @param match The label match to replace for.
+ * @param ent_or_prp The entity or property to return the mask of.
  * @param ent_counter The entity counter.
  * @param prp_counter The property counter.
  * @param mask_map A mapping from entities and properties to mask names (or
- *   simply "masks"). Used to determine whether the current label match already
- *   has a mask name assigned to it.
+ *   simply "masks"). If `ent_or_prp` has no mask assigned to it yet, a new
+ *   one is created, stored, and the corresponding counter is incremented.
+ * @return The mask.
  */
-void DutchKBQADSCreate::mask_single_entity_or_property_in_question(std::string &q,
-                                                                   const LabelMatch &match,
+const std::string &DutchKBQADSCreate::mask_for_entity_or_property(WikiData::symbol_id ent_or_prp,
                                                                    int &ent_counter,
                                                                    int &prp_counter,
                                                                    ent_prp_mask_map &mask_map) {
-    std::string replacement;
-    const auto potential_replacement = mask_map.find(match.ent_or_prp);
-    if (potential_replacement == mask_map.end()) {
-        /* No already-existing mask name. Create a new one. */
-        switch (wiki_data_symbol_for_entity_or_property(match.ent_or_prp)) {
-            case WikiDataSymbol::ENTITY:
-                replacement = std::string("Q") + std::to_string(ent_counter);
-                ent_counter++;
-                break;
-            case WikiDataSymbol::PROPERTY:
-                replacement = std::string("P") + std::to_string(prp_counter);
-                prp_counter++;
-                break;
-        }
-        mask_map.insert({ match.ent_or_prp, replacement });
-    } else {
+    const auto potential_mask = mask_map.find(ent_or_prp);
+    if (potential_mask != mask_map.end()) {
         /* Mask name already exists. Use it. */
-        replacement = potential_replacement->second;
+        return potential_mask->second;
+    }
+    /* No already-existing mask name. Create a new one. */
+    std::string mask;
+    switch (WikiData::symbol_type(ent_or_prp)) {
+        case WikiDataSymbol::ENTITY:
+            mask = std::string("Q") + std::to_string(ent_counter);
+            ent_counter++;
+            break;
+        case WikiDataSymbol::PROPERTY:
+            mask = std::string("P") + std::to_string(prp_counter);
+            prp_counter++;
+            break;
     }
-    q = std::regex_replace(q, std::regex("(" + match.label + ")"), replacement);
+    return mask_map.insert({ ent_or_prp, mask }).first->second;
 }
 
 /**
- * @brief Masks a single label within the supplied answer, given the current
- *   state of the already-existent mask names for entities and properties
- *   masked earlier on in the masking process.
+ * @brief Returns `q` with the label matches `matches` replaced by the masks of
+ *   their entities and properties.
  *
- * @param q The question in which to replace.
- * @param match The label match to replace for.
- * @param mask_map A mapping from entities and properties to mask names (or
- *   simply "masks"). Used to determine whether the current label match already
- *   has a mask name assigned to it.
- */
-void DutchKBQADSCreate::mask_single_entity_or_property_in_answer(std::string &a,
-                                                                 const LabelMatch &match,
-                                                                 ent_prp_mask_map &mask_map) {
-    const auto potential_replacement = mask_map.find(match.ent_or_prp);
-    if (potential_replacement == mask_map.end()) {
-        throw std::runtime_error(std::string("Logical error: ") +
-                                 "mask map is missing for \"" +
-                                 match.ent_or_prp +
-                                 "\" (" +
-                                 match.label +
-                                 ")!");
-    }
-    a = std::regex_replace(a, std::regex("(" + match.ent_or_prp + ")"), potential_replacement->second);
+ * The question is rewritten in a single pass: the text in between matches is
+ * copied verbatim, and each match is replaced at its known bounds. As such,
+ * only the matched occurrence of each label is masked, and labels are never
+ * interpreted as patterns.
+ *
+ * @param q The question to mask.
+ * @param matches The label matches within `q`, sorted by their position in `q`
+ *   and without collisions (see `LabelMatch::collision_present_in_label_matches`).
+ * @param mask_map A mapping from entities and properties to masks. Must contain
+ *   the entity or property of every match.
+ * @return The masked question.
+ */
+std::string DutchKBQADSCreate::question_with_labels_masked(const std::string &q,
+                                                           const std::vector<LabelMatch> &matches,
+                                                           const ent_prp_mask_map &mask_map) {
+    std::string masked;
+    masked.reserve(q.size());
+    std::size_t copied_until = 0;
+    for (const auto &match : matches) {
+        const auto mask = mask_map.find(match.ent_or_prp);
+        if (mask == mask_map.end()) {
+            throw std::runtime_error(std::string("Logical error: ") +
+                                     "mask map is missing for \"" +
+                                     WikiData::string_from_symbol_id(match.ent_or_prp) +
+                                     "\" (" +
+                                     std::string(match.label) +
+                                     ")!");
+        }
+        const auto match_start = static_cast<std::size_t>(match.match_bounds.first);
+        const auto match_end = static_cast<std::size_t>(match.match_bounds.second) + 1;  /* exclusive */
+        if (match_start < copied_until || match_end > q.size()) {
+            throw std::invalid_argument("Label matches must be sorted, non-colliding, and lie within the question.");
+        }
+        masked.append(q, copied_until, match_start - copied_until);
+        masked += mask->second;
+        copied_until = match_end;
+    }
+    masked.append(q, copied_until, std::string::npos);
+    return masked;
+}
+
+/**
+ * @brief Returns the SPARQL answer `a` with its entities and properties
+ *   replaced by their masks.
+ *
+ * The answer is rewritten in a single pass over the identifiers found by
+ * `WikiData::symbol_occurrences_in_sparql`. Only whole identifiers are
+ * replaced, so masking `Q1` leaves `Q10` intact.
+ *
+ * @param a The answer to mask.
+ * @param mask_map A mapping from entities and properties to masks. Identifiers
+ *   without a mask are left as-is.
+ * @return The masked answer.
+ */
+std::string DutchKBQADSCreate::answer_with_entities_and_properties_masked(const std::string &a,
+                                                                          const ent_prp_mask_map &mask_map) {
+    std::string masked;
+    masked.reserve(a.size());
+    std::size_t copied_until = 0;
+    for (const auto &occurrence : WikiData::symbol_occurrences_in_sparql(a)) {
+        const auto mask = mask_map.find(occurrence.id);
+        if (mask == mask_map.end()) {
+            continue;
+        }
+        masked.append(a, copied_until, occurrence.start - copied_until);
+        masked += mask->second;
+        copied_until = occurrence.end;
+    }
+    masked.append(a, copied_until, std::string::npos);
+    return masked;
 }
 
 /**
@@ -346,107 +574,543 @@ void DutchKBQADSCreate::mask_single_entity_or_property_in_answer(std::string &a,
  * @param qa_pair The question-answer pair to mask.
  * @param entities_properties The unique entities and properties present within
  *   this question-answer pair.
- * @param ent_prp_labels A mapping from entities and properties to labels.
+ * @param label_index An index over the labels of all entities and properties.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly. See
+ *   `selected_labels_for_entities_and_properties`.
  * @return The masked equivalent of `qa_pair`.
  */
 std::optional<QuestionAnswerPair> DutchKBQADSCreate::masked_question_answer_pair(
         const QuestionAnswerPair &qa_pair,
-        const std::set<std::string> &entities_properties,
-        const ent_prp_label_map &ent_prp_labels) {
+        const std::vector<WikiData::symbol_id> &entities_properties,
+        const LabelIndex &label_index,
+        int max_edit_distance) {
+    static Tracing::Counter &masked = Tracing::counter("masking.pairs-masked");
+    static Tracing::Counter &rejected_no_label = Tracing::counter("masking.pairs-rejected.missing-label");
+    static Tracing::Counter &rejected_collision = Tracing::counter("masking.pairs-rejected.label-collision");
+    static Tracing::Counter &matched_approximately = Tracing::counter("masking.labels-matched-approximately");
     ent_prp_chosen_label_map labels_map = selected_labels_for_entities_and_properties(qa_pair.q,
                                                                                       entities_properties,
-                                                                                      ent_prp_labels);
+                                                                                      label_index,
+                                                                                      max_edit_distance);
     if (!labels_map.has_value()) {
         /* One or more entities and/or properties haven't gotten an appropriate
          * label assigned to them; masking cannot be performed. */
+        rejected_no_label.add();
         return std::nullopt;
     }
+    /* Masks are numbered in the textual order of the entities and properties,
+     * so that `P10` is masked before `P9`. */
+    std::vector<WikiData::symbol_id> mask_order = entities_properties;
+    std::sort(mask_order.begin(), mask_order.end(), WikiData::textually_precedes);
     std::vector<LabelMatch> label_matches;
-    for (const auto &ent_or_prp : entities_properties) {
+    for (const auto &ent_or_prp : mask_order) {
         label_matches.push_back(labels_map.value().at(ent_or_prp));
     }
     if (LabelMatch::collision_present_in_label_matches(label_matches)) {
+        rejected_collision.add();
         return std::nullopt;
     }
-    std::string replaced_q = qa_pair.q;
-    std::string replaced_a = qa_pair.a;
     int ent_counter = 1;
     int prp_counter = 1;
     ent_prp_mask_map mask_map;
+    for (const auto &ent_or_prp : mask_order) {
+        mask_for_entity_or_property(ent_or_prp, ent_counter, prp_counter, mask_map);
+    }
+    LabelMatch::sorted_label_matches(label_matches);
+    masked.add();
     for (const auto &label_match : label_matches) {
-        mask_single_entity_or_property_in_question(replaced_q,
-                                                   label_match,
-                                                   ent_counter,
-                                                   prp_counter,
-                                                   mask_map);
-        mask_single_entity_or_property_in_answer(replaced_a, label_match, mask_map);
-    }
-    return QuestionAnswerPair(qa_pair.uid, replaced_q, replaced_a);
+        if (label_match.is_approximate) {
+            matched_approximately.add();
+        }
+    }
+    return QuestionAnswerPair(qa_pair.uid,
+                              question_with_labels_masked(qa_pair.q, label_matches, mask_map),
+                              answer_with_entities_and_properties_masked(qa_pair.a, mask_map));
+}
+
+/**
+ * @brief The number of question-answer pairs a masking worker claims at once.
+ *   Large enough to keep contention on the shared work counter low; small
+ *   enough to balance the work between workers.
+ */
+const std::size_t masking_chunk_size = 64;
+
+/**
+ * @brief The number of milliseconds between two successive progress reports
+ *   during masking.
+ */
+const int masking_progress_interval_milliseconds = 100;
+
+/**
+ * @brief Masks question-answer pairs claimed from a shared work counter until
+ *   all pairs have been claimed, serving as the body of one masking worker.
+ *
+ * Each worker only reads the shared question-answer pairs, map and index, and
+ * only writes to the entries of `masked` belonging to pairs it claimed itself.
+ * Thus, no locking is needed.
+ *
+ * @param qa_pairs All question-answer pairs to mask.
+ * @param questions_entities_properties A mapping from question UIDs to the
+ *   entities and properties present within them.
+ * @param label_index An index over the labels of all entities and properties.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly.
+ * @param next_idx The index of the next question-answer pair to claim.
+ * @param completed The number of question-answer pairs masked so far.
+ * @param masked The output. For each question-answer pair, at the same index,
+ *   its masked equivalent, or null if it could not be masked.
+ */
+void mask_question_answer_pairs_worker(const std::vector<QuestionAnswerPair> &qa_pairs,
+                                       const q_ent_prp_map &questions_entities_properties,
+                                       const LabelIndex &label_index,
+                                       int max_edit_distance,
+                                       std::atomic<std::size_t> &next_idx,
+                                       std::atomic<std::size_t> &completed,
+                                       std::vector<std::optional<QuestionAnswerPair>> &masked) {
+    while (true) {
+        const std::size_t chunk_start = next_idx.fetch_add(masking_chunk_size);
+        if (chunk_start >= qa_pairs.size()) {
+            return;
+        }
+        const std::size_t chunk_end = std::min(chunk_start + masking_chunk_size, qa_pairs.size());
+        for (std::size_t idx = chunk_start; idx < chunk_end; idx++) {
+            const QuestionAnswerPair &qa_pair = qa_pairs[idx];
+            const std::vector<WikiData::symbol_id> &question_entities_properties =
+                questions_entities_properties.at(qa_pair.uid);
+            std::optional<QuestionAnswerPair> masked_pair = masked_question_answer_pair(qa_pair,
+                                                                                        question_entities_properties,
+                                                                                        label_index,
+                                                                                        max_edit_distance);
+            if (masked_pair.has_value()) {
+                masked[idx].emplace(masked_pair.value());
+            }
+        }
+        completed.fetch_add(chunk_end - chunk_start);
+    }
+}
+
+/**
+ * @brief Returns the question-answer pairs of the shard `shard` of an LC-QuAD
+ *   2.0 dataset split, in their original order.
+ *
+ * @param split The LC-QuAD 2.0 dataset split to target.
+ * @param language The natural language of the pairs' questions.
+ * @param shard The shard of the split's pairs to return.
+ * @return The pairs.
+ */
+std::vector<QuestionAnswerPair> sharded_question_answer_pairs(const LCQuADSplit &split,
+                                                              const NaturalLanguage &language,
+                                                              const Shard &shard) {
+    std::vector<QuestionAnswerPair> qa_pairs = question_answer_pairs(split, language);
+    if (!shard.is_whole()) {
+        const auto [shard_start, shard_end] = shard.bounds(qa_pairs.size());
+        qa_pairs = std::vector<QuestionAnswerPair>(qa_pairs.begin() + static_cast<std::ptrdiff_t>(shard_start),
+                                                   qa_pairs.begin() + static_cast<std::ptrdiff_t>(shard_end));
+    }
+    return qa_pairs;
 }
 
 /**
  * @brief Masks all question-answer pairs present in the LC-QuAD 2.0 dataset
- *   split-natural language pair and returns the results as a JSON object.
+ *   split-natural language pair and returns the results.
+ *
+ * The pairs are divided over `threads` workers. The result does not depend on
+ * the number of workers: masking a pair only depends on the pair itself.
  *
  * @param split The LC-QuAD 2.0 dataset split to target.
  * @param language The natural language to target. Is the natural language of
  *   the translation, not that of the original LC-QuAD 2.0 dataset.
  * @param quiet Whether to report on progress (`false`) or not (`true`).
- * @return The masked question-answer pairs as a JSON object.
+ * @param threads The number of threads to mask with. Minimally 1.
+ * @param use_binary_cache Whether to load the supplements from (and maintain)
+ *   their binary sidecars.
+ * @param shard The shard of the split's question-answer pairs to mask.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly.
+ * @return The pairs that could be masked, in their original order.
  */
-Json::Value DutchKBQADSCreate::masked_question_answer_pairs(const LCQuADSplit &split,
+std::vector<QuestionAnswerPair> DutchKBQADSCreate::masked_question_answer_pairs(const LCQuADSplit &split,
                                                             const NaturalLanguage &language,
-                                                            bool quiet) {
-    Json::Value json;
-    const std::vector<QuestionAnswerPair> qa_pairs = question_answer_pairs(split, language);
-    const q_ent_prp_map questions_entities_properties = loaded_question_entities_properties_map(split);
-    const ent_prp_label_map ent_prp_labels = loaded_entity_and_property_labels(split, language);
-    std::size_t counter = 0;
-    for (const auto &qa_pair : qa_pairs) {
-        const std::set<std::string> &question_entities_properties = questions_entities_properties.at(qa_pair.uid);
-        const ent_prp_label_map q_ent_prp_labels = entity_and_property_labels_subset(question_entities_properties,
-                                                                                     ent_prp_labels);
-        const std::optional<QuestionAnswerPair> masked = masked_question_answer_pair(qa_pair,
-                                                                                     question_entities_properties,
-                                                                                     q_ent_prp_labels);
-        if (masked.has_value()) {
-            Json::Value json_masked_qa_pair;
-            json_masked_qa_pair["q"] = masked.value().q;
-            json_masked_qa_pair["a"] = masked.value().a;
-            json[std::to_string(qa_pair.uid)] = json_masked_qa_pair;
+                                                            bool quiet,
+                                                            int threads,
+                                                            bool use_binary_cache,
+                                                            const Shard &shard,
+                                                            int max_edit_distance) {
+    if (threads < 1) {
+        throw std::invalid_argument(std::string("The number of threads must be at least 1, but is ") +
+                                    std::to_string(threads) +
+                                    ".");
+    }
+    return masked_question_answer_pairs(sharded_question_answer_pairs(split, language, shard),
+                                        loaded_question_entities_properties_map(split, use_binary_cache),
+                                        loaded_entity_and_property_labels(split, language, use_binary_cache),
+                                        quiet,
+                                        threads,
+                                        max_edit_distance);
+}
+
+/**
+ * @brief Masks the question-answer pairs `qa_pairs`, given their entities and
+ *   properties and the labels thereof, and returns the results. Unlike the
+ *   overload that takes a dataset split, nothing is loaded from disk.
+ *
+ * @param qa_pairs The question-answer pairs to mask.
+ * @param questions_entities_properties The entities and properties of every
+ *   pair of `qa_pairs`, keyed by the pairs' UIDs.
+ * @param ent_prp_labels The labels of the entities and properties.
+ * @param quiet Whether to report on progress (`false`) or not (`true`).
+ * @param threads The number of threads to mask with. Minimally 1.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly. Minimally 0.
+ * @return The pairs that could be masked, in their original order.
+ */
+std::vector<QuestionAnswerPair> DutchKBQADSCreate::masked_question_answer_pairs(
+        const std::vector<QuestionAnswerPair> &qa_pairs,
+        const q_ent_prp_map &questions_entities_properties,
+        const LabelStore &ent_prp_labels,
+        bool quiet,
+        int threads,
+        int max_edit_distance) {
+    if (threads < 1) {
+        throw std::invalid_argument(std::string("The number of threads must be at least 1, but is ") +
+                                    std::to_string(threads) +
+                                    ".");
+    }
+    return masked_question_answer_pairs(qa_pairs,
+                                        questions_entities_properties,
+                                        LabelIndex(ent_prp_labels),
+                                        quiet,
+                                        threads,
+                                        max_edit_distance);
+}
+
+/**
+ * @brief Masks the question-answer pairs `qa_pairs`, given their entities and
+ *   properties and an index over the labels thereof, and returns the results.
+ *   Lets callers that mask several batches of pairs build the index once.
+ *
+ * @param qa_pairs The question-answer pairs to mask.
+ * @param questions_entities_properties The entities and properties of every
+ *   pair of `qa_pairs`, keyed by the pairs' UIDs.
+ * @param label_index An index over the labels of the entities and properties.
+ * @param quiet Whether to report on progress (`false`) or not (`true`).
+ * @param threads The number of threads to mask with. Minimally 1.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly. Minimally 0.
+ * @return The pairs that could be masked, in their original order.
+ */
+std::vector<QuestionAnswerPair> DutchKBQADSCreate::masked_question_answer_pairs(
+        const std::vector<QuestionAnswerPair> &qa_pairs,
+        const q_ent_prp_map &questions_entities_properties,
+        const LabelIndex &label_index,
+        bool quiet,
+        int threads,
+        int max_edit_distance) {
+    if (threads < 1) {
+        throw std::invalid_argument(std::string("The number of threads must be at least 1, but is ") +
+                                    std::to_string(threads) +
+                                    ".");
+    } else if (max_edit_distance < 0) {
+        throw std::invalid_argument(std::string("The largest edit distance must be at least 0, but is ") +
+                                    std::to_string(max_edit_distance) +
+                                    ".");
+    }
+    const Tracing::Stage stage("mask question-answer pairs");
+    std::vector<std::optional<QuestionAnswerPair>> masked(qa_pairs.size());
+    std::atomic<std::size_t> next_idx = 0;
+    std::atomic<std::size_t> completed = 0;
+    std::atomic<bool> failed = false;
+    std::vector<std::exception_ptr> worker_errors(threads);
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < threads; worker++) {
+        workers.emplace_back([&, worker] () -> void {
+            try {
+                mask_question_answer_pairs_worker(qa_pairs,
+                                                  questions_entities_properties,
+                                                  label_index,
+                                                  max_edit_distance,
+                                                  next_idx,
+                                                  completed,
+                                                  masked);
+            } catch (...) {
+                worker_errors[worker] = std::current_exception();
+                failed = true;
+                next_idx = qa_pairs.size();  /* Make the other workers stop early. */
+            }
+        });
+    }
+    /* Report progress from here, rather than from within the workers. */
+    while (!quiet && !failed.load() && completed.load() < qa_pairs.size()) {
+        printf("\rMasking question-answer pairs... (%6.2lf%%)",
+               (static_cast<double>(completed.load()) / static_cast<double>(qa_pairs.size())) * 100.);
+        std::cout << std::flush;
+        std::this_thread::sleep_for(std::chrono::milliseconds(masking_progress_interval_milliseconds));
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (const auto &worker_error : worker_errors) {
+        if (worker_error) {
+            std::rethrow_exception(worker_error);
         }
-        if (!quiet) {
-            printf("\rMasking question-answer pairs... (%6.2lf%%)",
-                   (static_cast<double>(counter) / static_cast<double>(qa_pairs.size())) * 100.);
-            std::cout << std::flush;
+    }
+
+    /* Merge in the original order of the pairs, independently of which worker
+     * masked which pair. */
+    std::vector<QuestionAnswerPair> masked_pairs;
+    for (auto &masked_pair : masked) {
+        if (masked_pair.has_value()) {
+            masked_pairs.push_back(std::move(masked_pair.value()));
         }
-        counter++;
     }
     if (!quiet) {
+        printf("\rMasking question-answer pairs... (%6.2lf%%)", 100.);
         std::cout << std::endl << "Done." << std::endl;
     }
-    return json;
+    return masked_pairs;
+}
+
+/**
+ * @brief Returns the name of the masked question-answer pairs file.
+ *
+ * @param split The LC-QuAD 2.0 dataset split of which the file stores the
+ *   pairs.
+ * @param language The natural language of the questions of the file.
+ * @param shard The shard of the split's pairs that the file stores.
+ * @return The file name. Without `.json` file extension.
+ */
+std::string DutchKBQADSCreate::masked_question_answer_pairs_file_name(const LCQuADSplit &split,
+                                                                      const NaturalLanguage &language,
+                                                                      const Shard &shard) {
+    return string_from_lc_quad_split(split) +
+           "-" +
+           string_from_natural_language(language) +
+           "-" +
+           "replaced-no-errors-masked" +
+           shard.file_name_suffix();
+}
+
+/**
+ * @brief Returns the indices of `qa_pairs` in the order in which masked
+ *   question-answer pairs files store the pairs: by UID, compared as strings
+ *   (so `"1015"` precedes `"308"`).
+ *
+ * This is the order in which jsoncpp keeps the members of an object, and thus
+ * the order in which the files were saved when they were built as a whole
+ * `Json::Value`. Finalising the dataset partitions the pairs in this order.
+ *
+ * @param qa_pairs The question-answer pairs. Their UIDs must be unique.
+ * @return The indices.
+ */
+std::vector<std::size_t> DutchKBQADSCreate::indices_in_uid_string_order(const std::vector<QuestionAnswerPair> &qa_pairs) {
+    std::vector<std::string> uids;
+    uids.reserve(qa_pairs.size());
+    for (const auto &qa_pair : qa_pairs) {
+        uids.push_back(std::to_string(qa_pair.uid));
+    }
+    std::vector<std::size_t> indices(qa_pairs.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::sort(indices.begin(), indices.end(), [&uids] (std::size_t first, std::size_t second) -> bool {
+        return uids[first] < uids[second];
+    });
+    return indices;
 }
 
 /**
  * @brief Saves the masked question-answer pairs to disk.
  *
- * @param json A JSON object in which the keys are UIDs and the values are
- *   sub-objects containing the translated questions and the original
- *   SPARQL WikiData answer queries; both have their entities and properties
- *   masked.
- * @param split The LC-QuAD 2.0 dataset split of which `json` stores the labels.
- * @param language The natural language of the labels of `json`.
- */
-void DutchKBQADSCreate::save_masked_question_answer_pairs_json(const Json::Value &json,
-                                                               const LCQuADSplit &split,
-                                                               const NaturalLanguage &language) {
-    const std::string file_name = string_from_lc_quad_split(split) +
-                                  "-" +
-                                  string_from_natural_language(language) +
-                                  "-" +
-                                  "replaced-no-errors-masked";
-    save_json_to_dataset_file(json, file_name);
+ * The pairs are saved as a JSON object in which the keys are UIDs and the
+ * values are sub-objects containing the translated questions and the original
+ * SPARQL WikiData answer queries; both have their entities and properties
+ * masked. The object is written pair by pair, in the order of
+ * `indices_in_uid_string_order` whatever the order of `masked_pairs`, and is
+ * pretty-printed, as it is the end product of the dataset creation process.
+ *
+ * @param masked_pairs The masked question-answer pairs.
+ * @param split The LC-QuAD 2.0 dataset split of which `masked_pairs` stores the
+ *   pairs.
+ * @param language The natural language of the questions of `masked_pairs`.
+ * @param shard The shard of the split's pairs that `masked_pairs` stores.
+ */
+void DutchKBQADSCreate::save_masked_question_answer_pairs(const std::vector<QuestionAnswerPair> &masked_pairs,
+                                                          const LCQuADSplit &split,
+                                                          const NaturalLanguage &language,
+                                                          const Shard &shard) {
+    const Tracing::Stage stage("save masked question-answer pairs");
+    JsonRecordWriter writer(masked_question_answer_pairs_file_name(split, language, shard),
+                            JsonContainerType::JSON_OBJECT,
+                            true);
+    for (const std::size_t idx : indices_in_uid_string_order(masked_pairs)) {
+        Json::Value json_masked_qa_pair;
+        json_masked_qa_pair["q"] = masked_pairs[idx].q;
+        json_masked_qa_pair["a"] = masked_pairs[idx].a;
+        writer.write(std::to_string(masked_pairs[idx].uid), json_masked_qa_pair);
+    }
+    writer.close();
+}
+
+/**
+ * @brief Returns the hash of all inputs that masking the question-answer pair
+ *   `qa_pair` depends on: its question, its answer, its entities and
+ *   properties, the labels of those, and how closely labels must match.
+ *
+ * @param qa_pair The question-answer pair.
+ * @param entities_properties The entities and properties of `qa_pair`.
+ * @param ent_prp_labels The labels of (at least) the entities and properties
+ *   of `qa_pair`.
+ * @param max_edit_distance The largest edit distance allowed between a label
+ *   and its approximate match.
+ * @return The hash.
+ */
+std::uint64_t DutchKBQADSCreate::masking_input_hash(const QuestionAnswerPair &qa_pair,
+                                                    const std::vector<WikiData::symbol_id> &entities_properties,
+                                                    const LabelStore &ent_prp_labels,
+                                                    int max_edit_distance) {
+    Caching::InputHasher hasher;
+    hasher.add(static_cast<std::uint64_t>(max_edit_distance));
+    hasher.add(qa_pair.q);
+    hasher.add(qa_pair.a);
+    hasher.add(static_cast<std::uint64_t>(entities_properties.size()));
+    for (const WikiData::symbol_id ent_or_prp : entities_properties) {
+        hasher.add(static_cast<std::uint64_t>(ent_or_prp));
+        if (!ent_prp_labels.contains(ent_or_prp)) {
+            /* Tell an unlabelled entity or property apart from one without
+             * labels. */
+            hasher.add(~static_cast<std::uint64_t>(0));
+            continue;
+        }
+        const LabelList labels = ent_prp_labels.labels(ent_or_prp);
+        hasher.add(static_cast<std::uint64_t>(labels.size()));
+        for (std::size_t idx = 0; idx < labels.size(); idx++) {
+            hasher.add(labels[idx]);
+        }
+    }
+    return hasher.digest();
+}
+
+/**
+ * @brief Masks the question-answer pairs of an LC-QuAD 2.0 dataset split, and
+ *   saves the masked pairs to disk along with a manifest of the hashes of the
+ *   pairs' inputs (see `masking_input_hash`).
+ *
+ * If `incremental` is set and the manifest of an earlier run still describes
+ * the saved masked pairs, only the pairs whose inputs hash differently than
+ * they did in that run (or that are new) are masked. The masked equivalents
+ * of the other pairs are taken from the saved masked pairs instead. Thus,
+ * after fixing a few translations or adding a few labels, updating the masked
+ * pairs takes time proportional to the number of affected pairs, bar reading
+ * and writing the files. The result is the same as that of masking all pairs.
+ *
+ * @param split The LC-QuAD 2.0 dataset split to target.
+ * @param language The natural language to target. Is the natural language of
+ *   the translation, not that of the original LC-QuAD 2.0 dataset.
+ * @param quiet Whether to report on progress (`false`) or not (`true`).
+ * @param threads The number of threads to mask with. Minimally 1.
+ * @param use_binary_cache Whether to load the supplements from (and maintain)
+ *   their binary sidecars.
+ * @param incremental Whether to only mask the pairs whose inputs changed
+ *   (`true`), or all pairs (`false`).
+ * @param shard The shard of the split's question-answer pairs to mask.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly. Minimally 0.
+ * @return The number of pairs that were masked anew.
+ */
+std::size_t DutchKBQADSCreate::update_masked_question_answer_pairs(const LCQuADSplit &split,
+                                                                   const NaturalLanguage &language,
+                                                                   bool quiet,
+                                                                   int threads,
+                                                                   bool use_binary_cache,
+                                                                   bool incremental,
+                                                                   const Shard &shard,
+                                                                   int max_edit_distance) {
+    if (threads < 1) {
+        throw std::invalid_argument(std::string("The number of threads must be at least 1, but is ") +
+                                    std::to_string(threads) +
+                                    ".");
+    } else if (max_edit_distance < 0) {
+        throw std::invalid_argument(std::string("The largest edit distance must be at least 0, but is ") +
+                                    std::to_string(max_edit_distance) +
+                                    ".");
+    }
+    const std::vector<QuestionAnswerPair> qa_pairs = sharded_question_answer_pairs(split, language, shard);
+    const q_ent_prp_map questions_entities_properties = loaded_question_entities_properties_map(split,
+                                                                                                use_binary_cache);
+    const LabelStore ent_prp_labels = loaded_entity_and_property_labels(split, language, use_binary_cache);
+    const std::string file_name = masked_question_answer_pairs_file_name(split, language, shard);
+    const std::optional<Caching::MaskingManifest> previous_manifest =
+        incremental ? Caching::MaskingManifest::loaded(file_name) : std::nullopt;
+
+    Caching::MaskingManifest manifest(file_name);
+    std::vector<QuestionAnswerPair> changed_pairs;
+    std::unordered_set<int> unchanged_uids;
+    for (const auto &qa_pair : qa_pairs) {
+        const std::uint64_t input_hash = masking_input_hash(qa_pair,
+                                                            questions_entities_properties.at(qa_pair.uid),
+                                                            ent_prp_labels,
+                                                            max_edit_distance);
+        if (previous_manifest.has_value() && previous_manifest->unchanged(qa_pair.uid, input_hash)) {
+            unchanged_uids.insert(qa_pair.uid);
+        } else {
+            changed_pairs.push_back(qa_pair);
+        }
+        manifest.record(qa_pair.uid, input_hash);
+    }
+    static Tracing::Counter &pairs_unchanged = Tracing::counter("masking.pairs-unchanged");
+    pairs_unchanged.add(static_cast<std::int64_t>(unchanged_uids.size()));
+
+    /* Pairs with unchanged inputs that are absent from the saved masked pairs
+     * could not be masked before, and cannot be now. */
+    std::unordered_map<int, QuestionAnswerPair> masked_pairs_by_uid;
+    if (!unchanged_uids.empty()) {
+        const Tracing::Stage stage("load unchanged masked question-answer pairs");
+        JsonRecordReader reader(file_name);
+        std::string uid;
+        Json::Value json_masked_qa_pair;
+        while (reader.next(uid, json_masked_qa_pair)) {
+            const int masked_uid = std::stoi(uid);
+            if (unchanged_uids.count(masked_uid) > 0) {
+                masked_pairs_by_uid.emplace(masked_uid, QuestionAnswerPair(masked_uid,
+                                                                           json_masked_qa_pair["q"].asString(),
+                                                                           json_masked_qa_pair["a"].asString()));
+            }
+        }
+    }
+    if (!quiet && previous_manifest.has_value()) {
+        std::cout << "The inputs of " << changed_pairs.size() << " of " << qa_pairs.size() << " "
+                  << "question-answer pairs changed since they were last masked." << std::endl;
+    }
+    if (!changed_pairs.empty()) {
+        const std::vector<QuestionAnswerPair> newly_masked_pairs = masked_question_answer_pairs(
+            changed_pairs,
+            questions_entities_properties,
+            ent_prp_labels,
+            quiet,
+            threads,
+            max_edit_distance
+        );
+        for (const auto &masked_pair : newly_masked_pairs) {
+            masked_pairs_by_uid.emplace(masked_pair.uid, masked_pair);
+        }
+    }
+
+    std::vector<QuestionAnswerPair> masked_pairs;
+    masked_pairs.reserve(masked_pairs_by_uid.size());
+    for (const auto &qa_pair : qa_pairs) {
+        const auto masked_pair = masked_pairs_by_uid.find(qa_pair.uid);
+        if (masked_pair != masked_pairs_by_uid.end()) {
+            masked_pairs.push_back(masked_pair->second);
+        }
+    }
+    if (!quiet) {
+        std::cout << "Saving... ";
+    }
+    save_masked_question_answer_pairs(masked_pairs, split, language, shard);
+    manifest.save();
+    if (!quiet) {
+        std::cout << "Done." << std::endl;
+    }
+    return changed_pairs.size();
 }
 
 /**
@@ -455,7 +1119,10 @@ void DutchKBQADSCreate::save_masked_question_answer_pairs_json(const Json::Value
  *   saves these masked pairs to disk.
  *
  * @param vm The variables map with which to determine which dataset split
- *   and translation natural language to use in the masking operation.
+ *   and translation natural language to use in the masking operation, and
+ *   optionally with how many threads to mask, whether to use binary
+ *   sidecars, whether to only mask the pairs whose inputs changed, which
+ *   shard of the pairs to mask, and how closely labels must match.
  */
 void DutchKBQADSCreate::mask_question_answer_pairs(const po::variables_map &vm) {
     const std::vector<std::string> required_flags = { "split",
@@ -471,8 +1138,17 @@ void DutchKBQADSCreate::mask_question_answer_pairs(const po::variables_map &vm)
     const LCQuADSplit split = string_to_lc_quad_split_map.at(vm["split"].as<std::string>());
     const NaturalLanguage language = string_to_natural_language_map.at(vm["language"].as<std::string>());
     const bool quiet = vm["quiet"].as<bool>();
-    Json::Value json = masked_question_answer_pairs(split, language, quiet);
-    std::cout << "Saving... ";
-    save_masked_question_answer_pairs_json(json, split, language);
-    std::cout << "Done." << std::endl;
+    const int threads = vm.count("threads") == 0 ? 1 : vm["threads"].as<int>();
+    const bool use_binary_cache = vm.count("binary-cache") == 0 || vm["binary-cache"].as<bool>();
+    const bool incremental = vm.count("incremental") == 0 || vm["incremental"].as<bool>();
+    const Shard shard = requested_shard(vm);
+    const int max_edit_distance = vm.count("max-edit-distance") == 0 ? 0 : vm["max-edit-distance"].as<int>();
+    update_masked_question_answer_pairs(split,
+                                        language,
+                                        quiet,
+                                        threads,
+                                        use_binary_cache,
+                                        incremental,
+                                        shard,
+                                        max_edit_distance);
 }
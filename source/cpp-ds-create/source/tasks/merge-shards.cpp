@@ -0,0 +1,238 @@
+/* Symbols for merging the output of sharded tasks. */
+
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include "tasks/merge-shards.hpp"
+#include "caching/masking-manifest.hpp"
+#include "tasks/label-entities-properties.hpp"
+#include "tasks/mask-question-answer-pairs.hpp"
+
+using namespace DutchKBQADSCreate;
+
+/**
+ * @brief Determines whether labels of the shard `shard` of a split's entities
+ *   and properties are stored on disk, compacted or not.
+ *
+ * @param split The LC-QuAD 2.0 dataset split to target.
+ * @param language The natural language of the labels.
+ * @param shard The shard to look for.
+ * @return Whether a labels file of shard `shard` exists, either its compacted
+ *   labels file or its labels log.
+ */
+bool DutchKBQADSCreate::entity_and_property_label_shard_exists(const LCQuADSplit &split,
+                                                               const NaturalLanguage &language,
+                                                               const Shard &shard) {
+    const std::string relative_path = entity_and_property_labels_relative_path(split, language, shard);
+    return dataset_file_exists(relative_path + ".json") || dataset_file_exists(relative_path + ".jsonl");
+}
+
+/**
+ * @brief Determines whether the masked question-answer pairs of the shard
+ *   `shard` of a split are stored on disk.
+ *
+ * @param split The LC-QuAD 2.0 dataset split to target.
+ * @param language The natural language of the pairs' questions.
+ * @param shard The shard to look for.
+ * @return Whether the masked question-answer pairs file of shard `shard`
+ *   exists.
+ */
+bool DutchKBQADSCreate::masked_question_answer_pair_shard_exists(const LCQuADSplit &split,
+                                                                 const NaturalLanguage &language,
+                                                                 const Shard &shard) {
+    return dataset_file_exists(masked_question_answer_pairs_file_name(split, language, shard) + ".json");
+}
+
+/**
+ * @brief Merges the entity-and-property labels of all `shard_count` shards of
+ *   a split into the split's compacted labels file, and removes the shards'
+ *   files afterwards.
+ *
+ * Labels that the split's own labels files already hold are retained. As in
+ * compaction, the merged labels replace the compacted labels file in one
+ * rename, so an interrupted merge leaves all files intact.
+ *
+ * @param split The LC-QuAD 2.0 dataset split to target.
+ * @param language The natural language of the labels.
+ * @param shard_count The number of shards that labelling was divided into.
+ */
+void DutchKBQADSCreate::merge_entity_and_property_label_shards(const LCQuADSplit &split,
+                                                               const NaturalLanguage &language,
+                                                               int shard_count) {
+    for (int index = 0; index < shard_count; index++) {
+        if (!entity_and_property_label_shard_exists(split, language, Shard(index, shard_count))) {
+            throw std::runtime_error(std::string("The labels of shard ") +
+                                     std::to_string(index) +
+                                     " of " +
+                                     std::to_string(shard_count) +
+                                     " are missing.");
+        }
+    }
+    Json::Value json = loaded_json_entity_and_property_labels(split, language);
+    for (int index = 0; index < shard_count; index++) {
+        const Json::Value shard_json = loaded_json_entity_and_property_labels(split,
+                                                                              language,
+                                                                              Shard(index, shard_count));
+        for (const auto &ent_or_prp : shard_json.getMemberNames()) {
+            json[ent_or_prp] = shard_json[ent_or_prp];
+        }
+    }
+    compact_entity_and_property_labels(json, split, language);
+    for (int index = 0; index < shard_count; index++) {
+        const std::string relative_path = entity_and_property_labels_relative_path(split,
+                                                                                   language,
+                                                                                   Shard(index, shard_count));
+        fs::remove(dataset_dir / (relative_path + ".json"));
+        fs::remove(dataset_dir / (relative_path + ".jsonl"));
+    }
+}
+
+/**
+ * @brief Merges the masked question-answer pairs of all `shard_count` shards
+ *   of a split into the split's masked question-answer pairs file, and removes
+ *   the shards' files afterwards.
+ *
+ * Every shard's file is ordered by UID as a string (see
+ * `indices_in_uid_string_order`), so the shards are merged such that the
+ * merged file is ordered likewise, as an unsharded run would have saved it.
+ * The shards are read record by record, and written to a temporary file that
+ * then replaces the masked pairs file. If every shard has an up-to-date masking manifest,
+ * the manifests are merged as well, so that the merged pairs can be updated
+ * incrementally.
+ *
+ * @param split The LC-QuAD 2.0 dataset split to target.
+ * @param language The natural language of the pairs' questions.
+ * @param shard_count The number of shards that masking was divided into.
+ */
+void DutchKBQADSCreate::merge_masked_question_answer_pair_shards(const LCQuADSplit &split,
+                                                                 const NaturalLanguage &language,
+                                                                 int shard_count) {
+    for (int index = 0; index < shard_count; index++) {
+        if (!masked_question_answer_pair_shard_exists(split, language, Shard(index, shard_count))) {
+            throw std::runtime_error(std::string("The masked question-answer pairs of shard ") +
+                                     std::to_string(index) +
+                                     " of " +
+                                     std::to_string(shard_count) +
+                                     " are missing.");
+        }
+    }
+    const std::string file_name = masked_question_answer_pairs_file_name(split, language);
+    /* The merged pairs can only be updated incrementally if every shard's can. */
+    std::optional<Caching::MaskingManifest> manifest = Caching::MaskingManifest(file_name);
+    for (int index = 0; index < shard_count && manifest.has_value(); index++) {
+        const std::optional<Caching::MaskingManifest> shard_manifest = Caching::MaskingManifest::loaded(
+            masked_question_answer_pairs_file_name(split, language, Shard(index, shard_count))
+        );
+        if (shard_manifest.has_value()) {
+            manifest->record_all(shard_manifest.value());
+        } else {
+            manifest.reset();
+        }
+    }
+    {
+        JsonRecordWriter writer(file_name + ".merging", JsonContainerType::JSON_OBJECT, true);
+        std::vector<std::unique_ptr<JsonRecordReader>> readers;
+        std::vector<std::string> uids(shard_count);
+        std::vector<Json::Value> masked_pairs(shard_count);
+        std::vector<bool> exhausted(shard_count);
+        for (int index = 0; index < shard_count; index++) {
+            readers.push_back(std::make_unique<JsonRecordReader>(
+                masked_question_answer_pairs_file_name(split, language, Shard(index, shard_count))
+            ));
+            exhausted[index] = !readers[index]->next(uids[index], masked_pairs[index]);
+        }
+        while (true) {
+            int next_index = -1;
+            for (int index = 0; index < shard_count; index++) {
+                if (!exhausted[index] && (next_index < 0 || uids[index] < uids[next_index])) {
+                    next_index = index;
+                }
+            }
+            if (next_index < 0) {
+                break;
+            }
+            writer.write(uids[next_index], masked_pairs[next_index]);
+            const std::string previous_uid = uids[next_index];
+            exhausted[next_index] = !readers[next_index]->next(uids[next_index], masked_pairs[next_index]);
+            if (!exhausted[next_index] && !(previous_uid < uids[next_index])) {
+                throw std::runtime_error(std::string("The masked question-answer pairs of shard ") +
+                                         std::to_string(next_index) +
+                                         " of " +
+                                         std::to_string(shard_count) +
+                                         " are not ordered by UID.");
+            }
+        }
+        writer.close();
+    }
+    fs::rename(dataset_dir / (file_name + ".merging.json"), dataset_dir / (file_name + ".json"));
+    if (manifest.has_value()) {
+        manifest->save();
+    } else {
+        Caching::MaskingManifest::remove(file_name);
+    }
+    for (int index = 0; index < shard_count; index++) {
+        const std::string shard_file_name = masked_question_answer_pairs_file_name(split,
+                                                                                   language,
+                                                                                   Shard(index, shard_count));
+        fs::remove(dataset_dir / (shard_file_name + ".json"));
+        Caching::MaskingManifest::remove(shard_file_name);
+    }
+}
+
+/**
+ * @brief Merges the output of the shards of the labelling and masking tasks
+ *   of an LC-QuAD 2.0 dataset split into the files that the unsharded tasks
+ *   would have produced.
+ *
+ * Either kind of output is merged if at least one of its shards is found, in
+ * which case all of its shards must be present.
+ *
+ * @param vm The variables map with which to determine which LC-QuAD 2.0
+ *   dataset split and natural language to merge the shards of, and how many
+ *   shards there are.
+ */
+void DutchKBQADSCreate::merge_shards(const po::variables_map &vm) {
+    const std::vector<std::string> required_flags = { "split",
+                                                      "language",
+                                                      "shard-count" };
+    for (const auto &required_flag : required_flags) {
+        if (vm.count(required_flag) == 0) {
+            throw std::invalid_argument(std::string("The \"--") +
+                                        required_flag +
+                                        "\" flag is required.");
+        }
+    }
+    const LCQuADSplit split = string_to_lc_quad_split_map.at(vm["split"].as<std::string>());
+    const NaturalLanguage language = string_to_natural_language_map.at(vm["language"].as<std::string>());
+    const int shard_count = vm["shard-count"].as<int>();
+    if (shard_count < 2) {
+        /* The single shard's files are the unsharded task's files. */
+        throw std::invalid_argument(std::string("Only output of at least 2 shards can be merged, but ") +
+                                    "the number of shards is " +
+                                    std::to_string(shard_count) +
+                                    ".");
+    }
+    bool labels_found = false;
+    bool masked_pairs_found = false;
+    for (int index = 0; index < shard_count; index++) {
+        const Shard shard(index, shard_count);
+        labels_found = labels_found || entity_and_property_label_shard_exists(split, language, shard);
+        masked_pairs_found = masked_pairs_found || masked_question_answer_pair_shard_exists(split, language, shard);
+    }
+    if (!labels_found && !masked_pairs_found) {
+        throw std::invalid_argument(std::string("No shards of ") +
+                                    std::to_string(shard_count) +
+                                    " were found to merge.");
+    }
+    if (labels_found) {
+        std::cout << "Merging entity-and-property labels... ";
+        merge_entity_and_property_label_shards(split, language, shard_count);
+        std::cout << "Done." << std::endl;
+    }
+    if (masked_pairs_found) {
+        std::cout << "Merging masked question-answer pairs... ";
+        merge_masked_question_answer_pair_shards(split, language, shard_count);
+        std::cout << "Done." << std::endl;
+    }
+}
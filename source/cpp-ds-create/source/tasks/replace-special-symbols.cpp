@@ -1,75 +1,14 @@
 /* Symbols for replacing special symbols in translated datasets. */
 
-#include <regex>
 #include <stdexcept>
+#include <algorithm>
+#include <cctype>
+#include "utf8.h"
 #include "utilities.hpp"
 #include "tasks/replace-special-symbols.hpp"
 
 using namespace DutchKBQADSCreate;
 
-/**
- * @brief Returns a RegEx for finding the keys of a symbol replacement map.
- *
- * @param replace_map The symbol replacement map.
- * @return The RegEx.
- */
-std::regex symbol_replacement_search_query(const std::map<std::string, std::string> &replace_map) {
-    std::string search_query = "(";
-    bool is_first = true;
-    for (const auto &pair : replace_map) {
-        if (is_first) {
-            is_first = false;
-        } else {
-            search_query += "|";  /* separate capturing groups */
-        }
-        search_query += std::string("(") + pair.first + ")";
-    }
-    search_query += ")";
-    return std::regex(search_query);
-}
-
-/**
- * @brief Returns the input string, but with specified symbols replaced.
- *
- * @param str The string to replace symbols in.
- * @param replace_map The symbol replacement map.
- * @param search_query A RegEx for finding the keys of `replace_map`.
- * @return The string with symbols replaced.
- */
-std::string string_with_symbols_replaced(std::string str,
-                                         const std::map<std::string, std::string> &replace_map,
-                                         const std::regex &search_query) {
-    std::string replaced = str;  /* the string, but with symbols replaced */
-    for (std::sregex_iterator it(str.begin(), str.end(), search_query);
-         it != std::sregex_iterator();
-         ++it) {
-        /* iterate over all symbols to replace */
-        std::string matched_symbol = string_with_regex_characters_escaped(it->str());
-        std::regex matched_symbol_query("(" + matched_symbol + ")");
-        replaced = std::regex_replace(replaced, matched_symbol_query, replace_map.at(matched_symbol));
-    }
-    return replaced;
-}
-
-/**
- * @brief Returns the JSON data, but with the symbols specified in
- *   `replace_map` replaced.
- *
- * @param json The JSON data to replace symbols in.
- * @param replace_map A mapping from symbols to replace to their replacements.
- * @return The JSON data, but with the specified symbols replaced.
- */
-Json::Value DutchKBQADSCreate::json_with_symbols_replaced(Json::Value json,
-                                                          const std::map<std::string, std::string> &replace_map) {
-    std::regex search_query = symbol_replacement_search_query(replace_map);
-    for (const auto &key : json.getMemberNames()) {
-        json[key] = string_with_symbols_replaced(json[key].asString(),
-                                                 replace_map,
-                                                 search_query);
-    }
-    return json;
-}
-
 /* These HTML character entities have been taken from the W3C's Wiki:
  *   https://www.w3.org/wiki/Common_HTML_entities_used_for_typography
  * This source was last referenced on August 3rd, 2022.
@@ -111,94 +50,140 @@ const std::map<std::string, std::string> html_character_entity_map = {
     {"&gt;", ">"}
 };
 
-const std::regex html_entity_query("((&#[0-9]{1,4};)|(&[a-z]+;))");
-const std::regex code_point_query("[0-9]{1,4}");
-
 /**
- * A type of HTML entity.
+ * @brief The longest decimal code of an HTML numeric entity that is decoded.
+ *   Seven digits suffice for the largest Unicode code point, U+10FFFF.
  */
-enum HTMLEntityType {
-    CHARACTER,
-    NUMERIC
-};
+const std::size_t max_numeric_entity_digits = 7;
 
 /**
- * @brief Determines and returns the type of the supplied HTML entity.
+ * @brief Compiles a symbol replacer.
  *
- * For performance, this function won't check whether `html_entity` is indeed
- * an HTML entity; it will only check what type the entity is, given that it
- * is an HTML entity.
- *
- * @param html_entity The HTML entity to determine the type of.
- * @return The HTML entity type.
+ * @param replace_map A mapping from symbols to replace to their replacements.
+ *   The symbols are matched literally.
+ * @param replace_html_entities Whether to also replace HTML character entities
+ *   (see `html_character_entity_map`) and decimal HTML numeric entities by
+ *   their referents.
  */
-HTMLEntityType html_entity_type(const std::string &html_entity) {
-    return html_character_entity_map.count(html_entity) == 0 ?
-           HTMLEntityType::NUMERIC :
-           HTMLEntityType::CHARACTER;
+DutchKBQADSCreate::SymbolReplacer::SymbolReplacer(const std::map<std::string, std::string> &replace_map,
+                                                  bool replace_html_entities)
+        : replace_html_entities(replace_html_entities) {
+    auto add_replacement = [this] (const std::string &symbol, const std::string &replacement) -> void {
+        if (symbol.empty()) {
+            throw std::invalid_argument("Cannot replace the empty symbol.");
+        }
+        const int pattern_id = this->automaton.add_pattern(symbol);
+        this->replacements.resize(pattern_id + 1);
+        this->replacements[pattern_id] = replacement;
+    };
+    for (const auto &pair : replace_map) {
+        add_replacement(pair.first, pair.second);
+    }
+    if (replace_html_entities) {
+        for (const auto &pair : html_character_entity_map) {
+            add_replacement(pair.first, pair.second);
+        }
+    }
+    this->automaton.compile();
 }
 
 /**
- * @brief Returns the input string, but with the given HTML character entity
- *   replaced by its referent.
+ * @brief Returns the length of the decimal HTML numeric entity at byte `idx`
+ *   of `str`, and writes its referent to `output`.
  *
- * @param str The string to replace in.
- * @param entity The HTML character entity to replace.
- * @return The string with the HTML character entity replaced.
+ * @param str The string to decode an entity in.
+ * @param idx The index in `str` at which the entity must start.
+ * @param output The string to append the entity's referent, UTF8-encoded, to.
+ * @return The length of the entity in bytes, or 0 if no decodable entity starts
+ *   at `idx`. In the latter case, `output` is left as is.
  */
-std::string string_with_html_character_entity_replaced(const std::string &str,
-                                                       const std::string &entity) {
-    return std::regex_replace(str,
-                              std::regex("(" + entity + ")"),
-                              html_character_entity_map.at(entity));
+std::size_t DutchKBQADSCreate::SymbolReplacer::decoded_numeric_entity(const std::string &str,
+                                                                      std::size_t idx,
+                                                                      std::string &output) {
+    if (idx + 3 > str.size() || str[idx] != '&' || str[idx + 1] != '#') {
+        return 0;
+    }
+    utf8::uint32_t code_point = 0;
+    std::size_t end = idx + 2;
+    while (end < str.size() && end - (idx + 2) < max_numeric_entity_digits && std::isdigit(static_cast<unsigned char>(str[end]))) {
+        code_point = code_point * 10 + static_cast<utf8::uint32_t>(str[end] - '0');
+        end++;
+    }
+    const bool is_well_formed = end > idx + 2 && end < str.size() && str[end] == ';';
+    /* Surrogates and code points beyond U+10FFFF cannot be encoded as UTF8. */
+    const bool is_valid_code_point = code_point <= 0x10FFFF && (code_point < 0xD800 || code_point > 0xDFFF);
+    if (!is_well_formed || !is_valid_code_point) {
+        return 0;
+    }
+    utf8::append(code_point, std::back_inserter(output));
+    return end + 1 - idx;
 }
 
 /**
- * @brief Returns the input string, but with the given HTML numeric entity
- *   replaced by its referent.
+ * @brief Returns `str` with all symbols replaced.
  *
- * This function will only convert entities with numeric codes between #0 and
- * #255 (both ends inclusive).
+ * The string is rewritten in a single left-to-right pass. Where several
+ * symbols start at the same position, the longest one is replaced. Replaced
+ * text is never scanned again, so that, for example, `&amp;lt;` becomes
+ * `&lt;` rather than `<`.
  *
- * @param str The string to replace in.
- * @param entity The HTML numeric entity to replace.
- * @return The string with the HTML numeric entity replaced.
+ * @param str The string to replace symbols in.
+ * @return The string with symbols replaced.
  */
-std::string string_with_html_numeric_entity_replaced(const std::string &str,
-                                                     const std::string &entity) {
-    std::smatch code_point_match;  /* Stores only the four digits (U+0000) of the entity. */
-    std::regex_search(entity,
-                      code_point_match,
-                      code_point_query);
-    std::string referent { static_cast<char>(std::stoi(code_point_match.str())) };
-    return std::regex_replace(str,
-                              std::regex("(" + entity + ")"),
-                              referent);
+std::string DutchKBQADSCreate::SymbolReplacer::replaced(const std::string &str) const {
+    std::vector<StringMatching::pattern_match> matches = this->automaton.all_matches(str);
+    /* The automaton reports matches by their ends; order them by their starts,
+     * longest first. */
+    std::sort(matches.begin(), matches.end(),
+              [] (const StringMatching::pattern_match &first, const StringMatching::pattern_match &second) -> bool {
+                  if (first.second.first != second.second.first) {
+                      return first.second.first < second.second.first;
+                  }
+                  return first.second.second > second.second.second;
+              });
+    std::string output;
+    output.reserve(str.size());
+    std::size_t next_match = 0;
+    std::size_t idx = 0;
+    while (idx < str.size()) {
+        while (next_match < matches.size() && static_cast<std::size_t>(matches[next_match].second.first) < idx) {
+            next_match++;  /* skip matches overlapping already replaced text */
+        }
+        if (next_match < matches.size() && static_cast<std::size_t>(matches[next_match].second.first) == idx) {
+            const StringMatching::pattern_match &match = matches[next_match];
+            output += this->replacements[match.first];
+            idx = static_cast<std::size_t>(match.second.second) + 1;
+            continue;
+        }
+        if (this->replace_html_entities && str[idx] == '&') {
+            const std::size_t entity_length = decoded_numeric_entity(str, idx, output);
+            if (entity_length > 0) {
+                idx += entity_length;
+                continue;
+            }
+        }
+        output += str[idx];
+        idx++;
+    }
+    return output;
 }
 
 /**
- * @brief Returns the input string, but with HTML entities replaced.
+ * @brief Returns the JSON data, but with the symbols specified in
+ *   `replace_map` replaced.
  *
- * @param str The string to replace HTML entities in.
- * @return The string with HTML entities replaced by the symbols they refer to.
+ * @param json The JSON data to replace symbols in.
+ * @param replace_map A mapping from symbols to replace to their replacements.
+ *   The symbols are matched literally.
+ * @return The JSON data, but with the specified symbols replaced.
  */
-std::string string_with_html_entities_replaced(std::string str) {
-    std::string replaced = str;  /* the string with HTML entities replaced */
-    for (std::sregex_iterator it(str.begin(), str.end(), html_entity_query);
-         it != std::sregex_iterator();
-         ++it) {
-        /* iterate over all HTML entities to replace */
-        std::string matched_entity = it->str();
-        switch (html_entity_type(matched_entity)) {
-            case HTMLEntityType::CHARACTER:
-                replaced = string_with_html_character_entity_replaced(replaced, matched_entity);
-                break;
-            case HTMLEntityType::NUMERIC:
-                replaced = string_with_html_numeric_entity_replaced(replaced, matched_entity);
-                break;
-        }
+Json::Value DutchKBQADSCreate::json_with_symbols_replaced(Json::Value json,
+                                                          const std::map<std::string, std::string> &replace_map) {
+    const SymbolReplacer replacer(replace_map, false);
+    for (const auto &key : json.getMemberNames()) {
+        json[key] = replacer.replaced(json[key].asString());
     }
-    return replaced;
+    return json;
 }
 
 /**
@@ -209,8 +194,9 @@ std::string string_with_html_entities_replaced(std::string str) {
  * @return The JSON data, but with the HTML entities replaced.
  */
 Json::Value DutchKBQADSCreate::json_with_html_entities_replaced(Json::Value json) {
+    const SymbolReplacer replacer({}, true);
     for (const auto &key : json.getMemberNames()) {
-        json[key] = string_with_html_entities_replaced(json[key].asString());
+        json[key] = replacer.replaced(json[key].asString());
     }
     return json;
 }
@@ -218,6 +204,9 @@ Json::Value DutchKBQADSCreate::json_with_html_entities_replaced(Json::Value json
 /**
  * @brief Replaces various special symbols in the designated file.
  *
+ * The file is processed one question at a time, rather than loaded into memory
+ * as a whole. Symbols and HTML entities are replaced in one pass per question.
+ *
  * @param vm The variables map with which to determine which file to replace
  *   special symbols in, and where to save results to.
  */
@@ -231,13 +220,18 @@ void DutchKBQADSCreate::replace_special_symbols_in_dataset_file(const po::variab
     }
     std::string load_file_name = vm["load-file-name"].as<std::string>();
     std::string save_file_name = vm["save-file-name"].as<std::string>();
-    Json::Value json = json_loaded_from_dataset_file(load_file_name);
-    std::map<std::string, std::string> replace_map {
-            {string_with_regex_characters_escaped("_"), " " },
-            {string_with_regex_characters_escaped("{"), "" },
-            {string_with_regex_characters_escaped("}"), "" }
+    const std::map<std::string, std::string> replace_map {
+            {"_", " " },
+            {"{", "" },
+            {"}", "" }
     };
-    json = json_with_symbols_replaced(json, replace_map);
-    json = json_with_html_entities_replaced(json);
-    save_json_to_dataset_file(json, save_file_name);
+    const SymbolReplacer replacer(replace_map, true);
+    JsonRecordReader reader(load_file_name);
+    JsonRecordWriter writer(save_file_name, JsonContainerType::JSON_OBJECT);
+    std::string key;
+    Json::Value question;
+    while (reader.next(key, question)) {
+        writer.write(key, replacer.replaced(question.asString()));
+    }
+    writer.close();
 }
@@ -0,0 +1,169 @@
+/* Symbols for running the dataset-creating tasks as a single in-process pipeline. */
+
+#include <algorithm>
+#include <iostream>
+#include "tasks/run-pipeline.hpp"
+#include "tasks/collect-entities-properties.hpp"
+#include "tasks/finalise-dataset.hpp"
+#include "tasks/label-entities-properties.hpp"
+#include "tasks/mask-question-answer-pairs.hpp"
+#include "caching/masking-manifest.hpp"
+#include "wikidata/symbol-ids.hpp"
+
+using namespace DutchKBQADSCreate;
+
+/**
+ * @brief Runs the tasks `generate-question-entities-properties-map`,
+ *   `label-entities-and-properties` and `mask-question-answer-pairs` one after
+ *   another, passing their results on in memory.
+ *
+ * The original dataset split and the translated questions are read only once.
+ * The question-to-entities-and-properties map is derived from the pairs'
+ * answers, and only saved if `checkpoints` is set. Labels are fetched for the
+ * entities and properties that have none yet; like in the labelling task, they
+ * are always saved, so that an interrupted pipeline does not have to query
+ * WikiData for them again. Finally, the masked pairs are saved, along with
+ * their masking manifest. If `finalise` is set, the masked pairs are then
+ * finalised as by the `finalise-dataset` task, without reading them back.
+ *
+ * Replacing special symbols is not part of the pipeline, as the translated
+ * questions it produces are post-processed outside of this program before
+ * they can be masked.
+ *
+ * @param split The LC-QuAD 2.0 dataset split to work on.
+ * @param language The natural language of the translated questions, and thus
+ *   of the labels used for masking.
+ * @param part_size The number of entities and properties to start labelling
+ *   per query with. Minimally 1.
+ * @param in_flight The number of WikiData queries to have in flight at once.
+ *   Minimally 1.
+ * @param threads The number of threads to mask with. Minimally 1.
+ * @param checkpoints Whether to save the question-to-entities-and-properties
+ *   map, like the standalone task does.
+ * @param quiet Whether to report on progress (`false`) or not (`true`).
+ * @param label_cache A cache of labels shared by all splits, or null to not
+ *   use one.
+ * @param max_edit_distance The largest edit distance to allow between a label
+ *   and its approximate match, or 0 to only match labels exactly.
+ * @param finalise Whether to finalise the masked pairs.
+ * @param fraction_to_validate The fraction (0 and 1 both inclusive) of the
+ *   pairs of the `train` split that go to validation when finalising.
+ */
+void DutchKBQADSCreate::run_pipeline(const LCQuADSplit &split,
+                                     const NaturalLanguage &language,
+                                     int part_size,
+                                     int in_flight,
+                                     int threads,
+                                     bool checkpoints,
+                                     bool quiet,
+                                     Caching::LabelResponseCache *label_cache,
+                                     int max_edit_distance,
+                                     bool finalise,
+                                     double fraction_to_validate) {
+    const std::vector<QuestionAnswerPair> qa_pairs = question_answer_pairs(split, language);
+
+    q_ent_prp_map questions_entities_properties;
+    std::vector<WikiData::symbol_id> ent_prp_total;
+    for (const auto &qa_pair : qa_pairs) {
+        std::vector<WikiData::symbol_id> ent_prp = WikiData::symbol_ids_in_sparql(qa_pair.a);
+        ent_prp_total.insert(ent_prp_total.end(), ent_prp.begin(), ent_prp.end());
+        questions_entities_properties.insert({ qa_pair.uid, std::move(ent_prp) });
+    }
+    std::sort(ent_prp_total.begin(), ent_prp_total.end());
+    ent_prp_total.erase(std::unique(ent_prp_total.begin(), ent_prp_total.end()), ent_prp_total.end());
+    if (checkpoints) {
+        save_question_entities_properties_map(questions_entities_properties, split);
+    }
+
+    const LabelStore ent_prp_labels = label_store_from_json(labelled_entities_and_properties(ent_prp_total,
+                                                                                              split,
+                                                                                              language,
+                                                                                              part_size,
+                                                                                              in_flight,
+                                                                                              quiet,
+                                                                                              label_cache));
+    if (!quiet) {
+        std::cout << std::endl;
+    }
+
+    const std::vector<QuestionAnswerPair> masked_pairs = masked_question_answer_pairs(qa_pairs,
+                                                                                      questions_entities_properties,
+                                                                                      ent_prp_labels,
+                                                                                      quiet,
+                                                                                      threads,
+                                                                                      max_edit_distance);
+    if (!quiet) {
+        std::cout << "Saving... ";
+    }
+    save_masked_question_answer_pairs(masked_pairs, split, language);
+    /* Let the masking task update the masked pairs incrementally later on. */
+    Caching::MaskingManifest manifest(masked_question_answer_pairs_file_name(split, language));
+    for (const auto &qa_pair : qa_pairs) {
+        manifest.record(qa_pair.uid, masking_input_hash(qa_pair,
+                                                        questions_entities_properties.at(qa_pair.uid),
+                                                        ent_prp_labels,
+                                                        max_edit_distance));
+    }
+    manifest.save();
+    if (!quiet) {
+        std::cout << "Done." << std::endl;
+    }
+    if (finalise) {
+        if (!quiet) {
+            std::cout << "Finalising... ";
+        }
+        finalise_question_answer_pairs(masked_pairs, split, language, fraction_to_validate);
+        if (!quiet) {
+            std::cout << "Done." << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief Creates the masked dataset of an LC-QuAD 2.0 dataset split from its
+ *   original and translated versions in a single run. See the other overload.
+ *
+ * @param vm The variables map with which to determine which dataset split and
+ *   translation natural language to work on, how to label and mask,
+ *   whether to save intermediate results, and whether and how to finalise.
+ */
+void DutchKBQADSCreate::run_pipeline(const po::variables_map &vm) {
+    const std::vector<std::string> required_flags = { "split",
+                                                      "language",
+                                                      "part-size",
+                                                      "quiet" };
+    for (const auto &required_flag : required_flags) {
+        if (vm.count(required_flag) == 0) {
+            throw std::invalid_argument(std::string("The \"--") +
+                                        required_flag +
+                                        "\" flag is required.");
+        }
+    }
+    const LCQuADSplit split = string_to_lc_quad_split_map.at(vm["split"].as<std::string>());
+    const NaturalLanguage language = string_to_natural_language_map.at(vm["language"].as<std::string>());
+    const int part_size = vm["part-size"].as<int>();
+    const int in_flight = vm.count("in-flight") == 0 ? 1 : vm["in-flight"].as<int>();
+    const int threads = vm.count("threads") == 0 ? 1 : vm["threads"].as<int>();
+    const bool checkpoints = vm.count("checkpoints") != 0 && vm["checkpoints"].as<bool>();
+    const bool quiet = vm["quiet"].as<bool>();
+    const int max_edit_distance = vm.count("max-edit-distance") == 0 ? 0 : vm["max-edit-distance"].as<int>();
+    const bool finalise = vm.count("finalise") != 0 && vm["finalise"].as<bool>();
+    if (finalise && split == LCQuADSplit::TRAIN && vm.count("fraction-to-validate") == 0) {
+        throw std::invalid_argument(R"(The "--fraction-to-validate" flag is required to finalise the "train" split.)");
+    }
+    const double fraction_to_validate = vm.count("fraction-to-validate") == 0 ?
+                                        0. :
+                                        vm["fraction-to-validate"].as<double>();
+    std::unique_ptr<Caching::LabelResponseCache> label_cache = opened_label_cache(vm);
+    run_pipeline(split,
+                 language,
+                 part_size,
+                 in_flight,
+                 threads,
+                 checkpoints,
+                 quiet,
+                 label_cache.get(),
+                 max_edit_distance,
+                 finalise,
+                 fraction_to_validate);
+}
@@ -0,0 +1,316 @@
+/* Symbols for tracing where the tasks spend their time and memory. */
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <utility>
+#include "tracing/tracer.hpp"
+#if defined(_WIN32)
+    #define NOMINMAX  /* Keep `std::max` usable. */
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+using namespace DutchKBQADSCreate;
+using namespace DutchKBQADSCreate::Tracing;
+
+/**
+ * @brief Constructs a counter that has counted nothing yet.
+ */
+Counter::Counter() : count(0) {}
+
+/**
+ * @brief Adds `amount` to this counter.
+ *
+ * @param amount The amount to add. Non-negative.
+ */
+void Counter::add(std::int64_t amount) {
+    this->count.fetch_add(amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the amount counted so far.
+ *
+ * @return The amount.
+ */
+std::int64_t Counter::value() const {
+    return this->count.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Constructs a disabled tracer, whose clock starts now.
+ */
+Tracer::Tracer() : enabled(false), origin(tracing_clock::now()) {}
+
+/**
+ * @brief Starts collecting stage runs.
+ */
+void Tracer::enable() {
+    this->enabled = true;
+}
+
+/**
+ * @brief Determines whether stage runs are collected.
+ *
+ * @return The question's answer.
+ */
+bool Tracer::is_enabled() const {
+    return this->enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the number of microseconds between the start of tracing and
+ *   `time`.
+ *
+ * @param time The point in time.
+ * @return The number of microseconds.
+ */
+std::int64_t Tracer::microseconds_since_origin(tracing_clock::time_point time) const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - this->origin).count();
+}
+
+/**
+ * @brief Returns the counter named `name`, creating it if it does not exist
+ *   yet.
+ *
+ * @param name The name of the counter.
+ * @return The counter. Valid for as long as this tracer exists.
+ */
+Counter &Tracer::counter(const std::string &name) {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    std::unique_ptr<Counter> &counter = this->counters[name];
+    if (!counter) {
+        counter = std::make_unique<Counter>();
+    }
+    return *counter;
+}
+
+/**
+ * @brief Adds the completed stage run `run` to the trace, if tracing is
+ *   enabled.
+ *
+ * @param run The stage run.
+ */
+void Tracer::record(StageRun run) {
+    if (!this->is_enabled()) {
+        return;
+    }
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    this->runs.push_back(std::move(run));
+}
+
+/**
+ * @brief Returns the current values of all counters, keyed by name.
+ *
+ * @return The values.
+ */
+std::map<std::string, std::int64_t> Tracer::counter_values() const {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    std::map<std::string, std::int64_t> values;
+    for (const auto &[name, counter] : this->counters) {
+        values.insert({ name, counter->value() });
+    }
+    return values;
+}
+
+/**
+ * @brief Writes the trace to `path` in the Chrome trace event format.
+ *
+ * Every stage run becomes a complete (`X`) event. The process's peak resident
+ * set size is written as a counter (`C`) track, sampled at the end of every
+ * stage run, and the final values of all counters are written as counter
+ * events at the end of the trace.
+ *
+ * @param path The path of the trace file.
+ */
+void Tracer::write_chrome_trace(const fs::path &path) const {
+    std::vector<StageRun> runs;
+    {
+        const std::lock_guard<std::mutex> lock(this->mutex);
+        runs = this->runs;
+    }
+    std::sort(runs.begin(), runs.end(), [] (const StageRun &first, const StageRun &second) {
+        return first.start + first.duration < second.start + second.duration;
+    });
+    Json::Value events = Json::arrayValue;
+    for (const auto &run : runs) {
+        Json::Value event;
+        event["name"] = run.name;
+        event["cat"] = "stage";
+        event["ph"] = "X";
+        event["ts"] = static_cast<Json::Int64>(run.start);
+        event["dur"] = static_cast<Json::Int64>(run.duration);
+        event["pid"] = 1;
+        event["tid"] = run.thread;
+        event["args"]["peak-rss-bytes"] = static_cast<Json::Int64>(run.peak_rss);
+        events.append(event);
+        Json::Value rss_event;
+        rss_event["name"] = "peak-rss-bytes";
+        rss_event["ph"] = "C";
+        rss_event["ts"] = static_cast<Json::Int64>(run.start + run.duration);
+        rss_event["pid"] = 1;
+        rss_event["args"]["value"] = static_cast<Json::Int64>(run.peak_rss);
+        events.append(rss_event);
+    }
+    const std::int64_t end = this->microseconds_since_origin(tracing_clock::now());
+    for (const auto &[name, value] : this->counter_values()) {
+        Json::Value counter_event;
+        counter_event["name"] = name;
+        counter_event["ph"] = "C";
+        counter_event["ts"] = static_cast<Json::Int64>(end);
+        counter_event["pid"] = 1;
+        counter_event["args"]["value"] = static_cast<Json::Int64>(value);
+        events.append(counter_event);
+    }
+    Json::Value trace;
+    trace["traceEvents"] = events;
+    trace["displayTimeUnit"] = "ms";
+
+    std::ofstream file(path, std::ofstream::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::string("Trace file \"") +
+                                 path.string() +
+                                 "\" won't open!");
+    }
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    const std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+    writer->write(trace, &file);
+    file << "\n";
+}
+
+/**
+ * @brief Writes a summary of the trace to `out`: per stage, how often it ran,
+ *   its total and longest wall time, and the peak resident set size after
+ *   it; followed by the values of all counters that counted anything.
+ *
+ * @param out The stream to write to.
+ */
+void Tracer::write_summary(std::ostream &out) const {
+    struct StageTotals {
+        std::size_t runs = 0;
+        std::int64_t total_duration = 0;
+        std::int64_t longest_duration = 0;
+        std::int64_t peak_rss = 0;
+    };
+    std::map<std::string, StageTotals> totals;
+    {
+        const std::lock_guard<std::mutex> lock(this->mutex);
+        for (const auto &run : this->runs) {
+            StageTotals &stage_totals = totals[run.name];
+            stage_totals.runs++;
+            stage_totals.total_duration += run.duration;
+            stage_totals.longest_duration = std::max(stage_totals.longest_duration, run.duration);
+            stage_totals.peak_rss = std::max(stage_totals.peak_rss, run.peak_rss);
+        }
+    }
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "Stages (runs, total seconds, longest seconds, peak RSS MiB):" << std::endl;
+    for (const auto &[name, stage_totals] : totals) {
+        out << "  " << name << ": "
+            << stage_totals.runs << ", "
+            << static_cast<double>(stage_totals.total_duration) / 1e6 << ", "
+            << static_cast<double>(stage_totals.longest_duration) / 1e6 << ", "
+            << static_cast<double>(stage_totals.peak_rss) / (1024. * 1024.) << std::endl;
+    }
+    out << "Counters:" << std::endl;
+    for (const auto &[name, value] : this->counter_values()) {
+        if (value != 0) {
+            out << "  " << name << ": " << value << std::endl;
+        }
+    }
+    out << "Peak RSS: " << static_cast<double>(peak_resident_set_size()) / (1024. * 1024.) << " MiB" << std::endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+/**
+ * @brief Returns the index of the calling thread, assigning it one if it has
+ *   none yet.
+ *
+ * @return The index.
+ */
+static int current_thread_index() {
+    static std::atomic<int> next_thread_index = 0;
+    thread_local const int thread_index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    return thread_index;
+}
+
+/**
+ * @brief Starts a run of the stage `name`.
+ *
+ * @param name The name of the stage.
+ */
+Stage::Stage(std::string name) : name(std::move(name)), traced(tracer().is_enabled()) {
+    if (this->traced) {
+        this->start = tracing_clock::now();
+    }
+}
+
+/**
+ * @brief Completes the run of this stage, and records it.
+ */
+Stage::~Stage() {
+    if (!this->traced) {
+        return;
+    }
+    Tracer &process_tracer = tracer();
+    const tracing_clock::time_point end = tracing_clock::now();
+    process_tracer.record({ std::move(this->name),
+                            process_tracer.microseconds_since_origin(this->start),
+                            std::chrono::duration_cast<std::chrono::microseconds>(end - this->start).count(),
+                            current_thread_index(),
+                            peak_resident_set_size() });
+}
+
+/**
+ * @brief Returns the tracer of the process.
+ *
+ * @return The tracer.
+ */
+Tracer &DutchKBQADSCreate::Tracing::tracer() {
+    static Tracer process_tracer;
+    return process_tracer;
+}
+
+/**
+ * @brief Returns the counter named `name` of the process's tracer. Store the
+ *   result (for example in a function-local `static`) rather than looking the
+ *   counter up for every increment.
+ *
+ * @param name The name of the counter.
+ * @return The counter.
+ */
+Counter &DutchKBQADSCreate::Tracing::counter(const std::string &name) {
+    return tracer().counter(name);
+}
+
+/**
+ * @brief Returns the largest resident set size the process has had so far.
+ *
+ * @return The peak resident set size in bytes, or 0 if it cannot be
+ *   determined.
+ */
+std::int64_t DutchKBQADSCreate::Tracing::peak_resident_set_size() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return static_cast<std::int64_t>(counters.PeakWorkingSetSize);
+#else
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    #if __APPLE__
+        return static_cast<std::int64_t>(usage.ru_maxrss);  /* In bytes. */
+    #else
+        return static_cast<std::int64_t>(usage.ru_maxrss) * 1024;  /* In kilobytes. */
+    #endif
+#endif
+}
@@ -1,10 +1,11 @@
 /* Various utility symbols. */
 
 #include <fstream>
+#include <memory>
+#include <sstream>
 #include <stdexcept>
-#include <algorithm>
-#include <cassert>
 #include "utilities.hpp"
+#include "tracing/tracer.hpp"
 
 using namespace DutchKBQADSCreate;
 
@@ -43,26 +44,82 @@ std::string DutchKBQADSCreate::string_from_lc_quad_split(const LCQuADSplit &spli
 }
 
 /**
- * @brief Determines which type of WikiData symbol an entity or property
- *   belongs to.
+ * @brief Constructs a shard of a task's work.
  *
- * This function throws an `invalid_argument` error if `ent_or_prp` is neither
- * an entity nor a property.
+ * @param index The index of the shard. 0-based, and less than `count`.
+ * @param count The number of shards that the work is divided into. Minimally
+ *   1.
+ */
+DutchKBQADSCreate::Shard::Shard(int index, int count) : index(index), count(count) {
+    if (count < 1) {
+        throw std::invalid_argument(std::string("The number of shards must be at least 1, but is ") +
+                                    std::to_string(count) +
+                                    ".");
+    } else if ((index < 0) || (index >= count)) {
+        throw std::invalid_argument(std::string("Shard index ") +
+                                    std::to_string(index) +
+                                    " is inappropriate for " +
+                                    std::to_string(count) +
+                                    " shards: it must lie in [0, " +
+                                    std::to_string(count) +
+                                    ").");
+    }
+}
+
+/**
+ * @brief Determines whether this shard covers all of a task's work.
  *
- * @param ent_or_prp The entity or property.
+ * @return The question's answer.
  */
-WikiDataSymbol DutchKBQADSCreate::wiki_data_symbol_for_entity_or_property(const std::string &ent_or_prp) {
-    assert(!ent_or_prp.empty());
-    switch (ent_or_prp[0]) {
-        case 'Q':
-            return WikiDataSymbol::ENTITY;
-        case 'P':
-            return WikiDataSymbol::PROPERTY;
-        default:
-            throw std::invalid_argument(std::string("\"") +
-                                        ent_or_prp +
-                                        "\" is not an entity or property!");
+bool DutchKBQADSCreate::Shard::is_whole() const {
+    return this->count == 1;
+}
+
+/**
+ * @brief Returns the range of items that this shard covers, out of `total`
+ *   items of work. The ranges of all shards are disjoint, cover all items, and
+ *   differ in size by at most one item.
+ *
+ * @param total The total number of items of work.
+ * @return The index of the first item covered (inclusive) and that of the
+ *   last item covered (exclusive).
+ */
+std::pair<std::size_t, std::size_t> DutchKBQADSCreate::Shard::bounds(std::size_t total) const {
+    const auto index = static_cast<std::size_t>(this->index);
+    const auto count = static_cast<std::size_t>(this->count);
+    return { total * index / count, total * (index + 1) / count };
+}
+
+/**
+ * @brief Returns the suffix to append to the names of this shard's output
+ *   files, before their extensions.
+ *
+ * @return The suffix. Empty if this shard covers all of the work.
+ */
+std::string DutchKBQADSCreate::Shard::file_name_suffix() const {
+    if (this->is_whole()) {
+        return "";
     }
+    return std::string("-shard-") + std::to_string(this->index) + "-of-" + std::to_string(this->count);
+}
+
+/**
+ * @brief Returns the shard requested by the command-line flags `--shard-index`
+ *   and `--shard-count`.
+ *
+ * @param vm The variables map with which to determine the shard.
+ * @return The shard, or `whole_shard` if neither flag is supplied.
+ */
+Shard DutchKBQADSCreate::requested_shard(const po::variables_map &vm) {
+    const bool has_index = vm.count("shard-index") != 0;
+    const bool has_count = vm.count("shard-count") != 0;
+    if (!has_index && !has_count) {
+        return whole_shard;
+    } else if (!has_index || !has_count) {
+        throw std::invalid_argument(std::string(R"(The "--shard-index" and "--shard-count" flags )") +
+                                    "must be supplied together.");
+    }
+    return { vm["shard-index"].as<int>(), vm["shard-count"].as<int>() };
 }
 
 /**
@@ -99,6 +156,36 @@ void DutchKBQADSCreate::create_directory_if_absent(const fs::path &dir_path) {
     }
 }
 
+/**
+ * @brief Counts the size of the file at `path`, which is read in full, towards
+ *   the bytes read by the process.
+ *
+ * @param path The path of the file.
+ */
+void count_file_read(const fs::path &path) {
+    static Tracing::Counter &bytes_read = Tracing::counter("io.bytes-read");
+    std::error_code ec;
+    const std::uintmax_t size = fs::file_size(path, ec);
+    if (!ec) {
+        bytes_read.add(static_cast<std::int64_t>(size));
+    }
+}
+
+/**
+ * @brief Counts the bytes written to the (not appended-to) file `file` so far
+ *   towards the bytes written by the process. Call it right before closing
+ *   the file.
+ *
+ * @param file The file.
+ */
+void count_file_written(std::ofstream &file) {
+    static Tracing::Counter &bytes_written = Tracing::counter("io.bytes-written");
+    const std::streamoff written = file.tellp();
+    if (written > 0) {
+        bytes_written.add(static_cast<std::int64_t>(written));
+    }
+}
+
 /**
  * @brief Returns JSON data loaded from a file stores in the project root
  *   `resources/dataset/` directory.
@@ -112,6 +199,7 @@ Json::Value DutchKBQADSCreate::json_loaded_from_dataset_file(const std::string &
                        std::ifstream::binary);
     Json::Value json;
     file >> json;
+    count_file_read(dataset_dir / (file_name + ".json"));
     return json;
 }
 
@@ -122,10 +210,15 @@ Json::Value DutchKBQADSCreate::json_loaded_from_dataset_file(const std::string &
  * @param json The JSON data to save to disk.
  * @param file_name The file in the project root's `resources` directory to save
  *   to. Exclude `.json`.
+ * @param pretty Whether to indent the JSON data for readability (`true`), or
+ *   to write it compactly (`false`).
  */
 void DutchKBQADSCreate::save_json_to_dataset_file(const Json::Value &json,
-                                                  const std::string &file_name) {
-    Json::StyledStreamWriter writer;
+                                                  const std::string &file_name,
+                                                  bool pretty) {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = pretty ? "\t" : "";
+    const std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
     std::ofstream file;
     file.open(dataset_dir / (file_name + ".json"),
               std::ofstream::trunc);
@@ -134,86 +227,418 @@ void DutchKBQADSCreate::save_json_to_dataset_file(const Json::Value &json,
                                  file_name +
                                  "\" won't open!");
     }
-    writer.write(file, json);
+    writer->write(json, &file);
+    file << "\n";
+    count_file_written(file);
 }
 
 /**
- * @brief Appends the contents of `json` to the JSON content already present in
- *   the file `file_name`, present in the project root's `resources` directory.
- * 
+ * @brief Appends `json` as a single, compact line to the JSON Lines file
+ *   `file_name` in the project root's `resources` directory, creating the
+ *   file if it does not exist yet.
+ *
+ * This takes time proportional to the size of `json` only: the file's
+ * existing contents are never read.
+ *
  * @param json The JSON to append.
  * @param file_name The name of the file in the project root's `resources`
- *   directory to which to append. Exclude `.json`.
+ *   directory to which to append. Exclude `.jsonl`.
  */
-void DutchKBQADSCreate::append_json_to_dataset_file(const Json::Value &json,
-                                                    const std::string &file_name) {
-    std::ifstream file(dataset_dir / (file_name + ".json"),
+void DutchKBQADSCreate::append_json_line_to_dataset_file(const Json::Value &json,
+                                                         const std::string &file_name) {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    std::ofstream file;
+    file.open(dataset_dir / (file_name + ".jsonl"),
+              std::ofstream::app | std::ofstream::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::string("JSON Lines save file \"") +
+                                 file_name +
+                                 "\" won't open!");
+    }
+    /* Write the record in one go, so that a crash tears at most this line. */
+    static Tracing::Counter &bytes_written = Tracing::counter("io.bytes-written");
+    const std::string line = Json::writeString(builder, json) + "\n";
+    file << line << std::flush;
+    bytes_written.add(static_cast<std::int64_t>(line.size()));
+    if (!file.good()) {
+        throw std::runtime_error(std::string("Couldn't append to JSON Lines file \"") +
+                                 file_name +
+                                 "\"!");
+    }
+}
+
+/**
+ * @brief Returns the JSON records of the JSON Lines file `file_name` in the
+ *   project root's `resources` directory, in order.
+ *
+ * A final line that is incomplete, as left behind by a crash during
+ * `append_json_line_to_dataset_file`, is ignored. Any other malformed line
+ * causes a `runtime_error`.
+ *
+ * @param file_name The name of the file to load in `resources/dataset/`.
+ *   Exclude `.jsonl`.
+ * @return The records. Empty if the file does not exist.
+ */
+std::vector<Json::Value> DutchKBQADSCreate::json_lines_loaded_from_dataset_file(const std::string &file_name) {
+    std::vector<Json::Value> records;
+    std::ifstream file(dataset_dir / (file_name + ".jsonl"),
                        std::ifstream::binary);
-    Json::Value file_json;  /* JSON already present in `file`. */
-    /* Try to get the JSON content of `file`. If it fails, create the file. */
-    try {
-        file >> file_json;
-    } catch (Json::Exception::exception &exception) {
-        save_json_to_dataset_file(json, file_name);
-        return;
+    if (!file.is_open()) {
+        return records;
     }
-    Json::Value updated_file_json;  /* `file_json` plus `json`. */
-    if (file_json.isArray() && json.isArray()) {
-        /* Update case 1: Append two JSON arrays. */
-        updated_file_json = Json::arrayValue;
-        for (const auto &entry : file_json) {
-            updated_file_json.append(entry);
+    count_file_read(dataset_dir / (file_name + ".jsonl"));
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        if (line.empty()) {
+            continue;
         }
-        for (const auto &entry : json) {
-            updated_file_json.append(entry);
+        const bool is_complete_line = !file.eof();  /* `getline` found a line break. */
+        Json::Value record;
+        std::string errors;
+        if (reader->parse(line.data(), line.data() + line.size(), &record, &errors)) {
+            records.push_back(std::move(record));
+        } else if (is_complete_line) {
+            throw std::runtime_error(std::string("Line ") +
+                                     std::to_string(line_number) +
+                                     " of JSON Lines file \"" +
+                                     file_name +
+                                     "\" is malformed: " +
+                                     errors);
         }
+    }
+    return records;
+}
+
+/**
+ * @brief Opens the dataset file `file_name` for reading its records one by
+ *   one.
+ *
+ * @param file_name The name of the file to read in `resources/dataset/`.
+ *   Exclude `.json`.
+ */
+DutchKBQADSCreate::JsonRecordReader::JsonRecordReader(const std::string &file_name)
+        : file_name(file_name),
+          file(dataset_dir / (file_name + ".json"), std::ifstream::binary),
+          exhausted(false),
+          records_read(0) {
+    if (!this->file.is_open()) {
+        throw std::runtime_error(std::string("JSON file \"") +
+                                 file_name +
+                                 "\" won't open!");
+    }
+    count_file_read(dataset_dir / (file_name + ".json"));
+    Json::CharReaderBuilder builder;
+    this->reader.reset(builder.newCharReader());
+    const int opening = this->next_char_after_whitespace();
+    if (opening == '[') {
+        this->type = JsonContainerType::JSON_ARRAY;
+    } else if (opening == '{') {
+        this->type = JsonContainerType::JSON_OBJECT;
     } else {
-        /* Update case 2: Approach both JSON files as objects. */
-        for (const auto &member : file_json.getMemberNames()) {
-            updated_file_json[member] = file_json[member];
+        throw std::runtime_error(std::string("JSON file \"") +
+                                 file_name +
+                                 "\" does not contain an array or object.");
+    }
+    this->file.rdbuf()->sbumpc();
+}
+
+/**
+ * @brief Returns the next character of the file that is not whitespace,
+ *   without consuming it.
+ *
+ * @return The character, or `std::char_traits<char>::eof()` if the end of the
+ *   file has been reached.
+ */
+int DutchKBQADSCreate::JsonRecordReader::next_char_after_whitespace() {
+    std::streambuf *buf = this->file.rdbuf();
+    int c = buf->sgetc();
+    while (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        c = buf->snextc();
+    }
+    return c;
+}
+
+/**
+ * @brief Consumes and returns the text of the next JSON value in the file,
+ *   which starts at the current position.
+ *
+ * The text is only delimited here, by tracking strings and the nesting of
+ * arrays and objects; it is validated when it is parsed.
+ *
+ * @return The text of the value.
+ */
+std::string DutchKBQADSCreate::JsonRecordReader::next_value_text() {
+    std::streambuf *buf = this->file.rdbuf();
+    std::string text;
+    int depth = 0;
+    bool in_string = false;
+    bool escaped = false;
+    while (true) {
+        const int c = buf->sgetc();
+        if (c == std::char_traits<char>::eof()) {
+            throw std::runtime_error(std::string("JSON file \"") +
+                                     this->file_name +
+                                     "\" ends unexpectedly.");
+        }
+        const bool at_value_end = !in_string &&
+                                  depth == 0 &&
+                                  !text.empty() &&
+                                  (c == ',' || c == ':' || c == ']' || c == '}' ||
+                                   c == ' ' || c == '\t' || c == '\n' || c == '\r');
+        if (at_value_end) {
+            return text;
         }
-        for (const auto &member : json.getMemberNames()) {
-            updated_file_json[member] = json[member];
+        text += static_cast<char>(c);
+        buf->sbumpc();
+        if (in_string) {
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '[' || c == '{') {
+            depth++;
+        } else if (c == ']' || c == '}') {
+            depth--;
         }
     }
-    save_json_to_dataset_file(updated_file_json, file_name);
-}
-
-/* The following characters are reserved in regular expressions. */
-const std::vector<char> regex_characters_to_escape {
-    '.',
-    '(', ')',
-    '[', ']',
-    '|',
-    '{', '}',
-    '*',
-    '+',
-    '-',
-    '?',
-    '^',
-    '$',
-    '/',
-    '\\'
-};
-
-/**
- * @brief Returns the input string, but with any reserved RegEx characters
- *   replaced.
- *
- * @param non_escaped The original, non-escaped string.
- * @return The string with any RegEx-reserved characters escaped.
- */
-std::string DutchKBQADSCreate::string_with_regex_characters_escaped(const std::string &non_escaped) {
-    std::string escapes_added;
-    for (const auto &c : non_escaped) {
-        if (*std::find(regex_characters_to_escape.begin(),
-                       regex_characters_to_escape.end(),
-                       c) == c) {
-            escapes_added += "\\";
+}
+
+/**
+ * @brief Returns the JSON value spelled out by `text`.
+ *
+ * @param text The text of a single JSON value.
+ * @return The parsed value.
+ */
+Json::Value DutchKBQADSCreate::JsonRecordReader::parsed_value_text(const std::string &text) {
+    Json::Value value;
+    std::string errors;
+    if (!this->reader->parse(text.data(), text.data() + text.size(), &value, &errors)) {
+        throw std::runtime_error(std::string("Record ") +
+                                 std::to_string(this->records_read) +
+                                 " of JSON file \"" +
+                                 this->file_name +
+                                 "\" is malformed: " +
+                                 errors);
+    }
+    return value;
+}
+
+/**
+ * @brief Returns whether the file's top-level value is an array or an object.
+ *
+ * @return The container type.
+ */
+JsonContainerType DutchKBQADSCreate::JsonRecordReader::container_type() const {
+    return this->type;
+}
+
+/**
+ * @brief Reads the next record of the file.
+ *
+ * @param key Is set to the member name of the record if the file contains an
+ *   object, or to the (decimal) index of the record if it contains an array.
+ * @param record Is set to the record.
+ * @return Whether a record was read (`true`), or the end of the array or
+ *   object has been reached (`false`).
+ */
+bool DutchKBQADSCreate::JsonRecordReader::next(std::string &key, Json::Value &record) {
+    if (this->exhausted) {
+        return false;
+    }
+    std::streambuf *buf = this->file.rdbuf();
+    const char closing = this->type == JsonContainerType::JSON_ARRAY ? ']' : '}';
+    int c = this->next_char_after_whitespace();
+    if (c == closing) {
+        buf->sbumpc();
+        this->exhausted = true;
+        return false;
+    }
+    if (this->records_read > 0) {
+        if (c != ',') {
+            throw std::runtime_error(std::string("Expected a comma after record ") +
+                                     std::to_string(this->records_read - 1) +
+                                     " of JSON file \"" +
+                                     this->file_name +
+                                     "\".");
+        }
+        buf->sbumpc();
+        this->next_char_after_whitespace();
+    }
+    if (this->type == JsonContainerType::JSON_OBJECT) {
+        const Json::Value member_name = this->parsed_value_text(this->next_value_text());
+        if (!member_name.isString() || this->next_char_after_whitespace() != ':') {
+            throw std::runtime_error(std::string("Record ") +
+                                     std::to_string(this->records_read) +
+                                     " of JSON file \"" +
+                                     this->file_name +
+                                     "\" lacks a member name.");
+        }
+        buf->sbumpc();
+        this->next_char_after_whitespace();
+        key = member_name.asString();
+    } else {
+        key = std::to_string(this->records_read);
+    }
+    record = this->parsed_value_text(this->next_value_text());
+    this->records_read++;
+    return true;
+}
+
+/**
+ * @brief Reads the next record of the file, discarding its key.
+ *
+ * @param record Is set to the record.
+ * @return Whether a record was read (`true`), or the end of the array or
+ *   object has been reached (`false`).
+ */
+bool DutchKBQADSCreate::JsonRecordReader::next(Json::Value &record) {
+    std::string key;
+    return this->next(key, record);
+}
+
+/**
+ * @brief Creates (or truncates) the dataset file `file_name`, and opens a JSON
+ *   array or object in it.
+ *
+ * @param file_name The file in the project root's `resources` directory to save
+ *   to. Exclude `.json`.
+ * @param type Whether to write an array or an object.
+ * @param pretty Whether to indent the records for readability (`true`), or to
+ *   write them compactly (`false`).
+ */
+DutchKBQADSCreate::JsonRecordWriter::JsonRecordWriter(const std::string &file_name,
+                                                      JsonContainerType type,
+                                                      bool pretty)
+        : file_name(file_name),
+          file(dataset_dir / (file_name + ".json"), std::ofstream::trunc | std::ofstream::binary),
+          type(type),
+          pretty(pretty),
+          closed(false),
+          records_written(0) {
+    if (!this->file.is_open()) {
+        throw std::runtime_error(std::string("JSON save file \"") +
+                                 file_name +
+                                 "\" won't open!");
+    }
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = pretty ? "\t" : "";
+    this->writer.reset(builder.newStreamWriter());
+    this->file << (type == JsonContainerType::JSON_ARRAY ? '[' : '{');
+}
+
+/**
+ * @brief Closes the array or object, unless this has been done already.
+ *
+ * Errors are swallowed here; call `close` explicitly to be notified of them.
+ */
+DutchKBQADSCreate::JsonRecordWriter::~JsonRecordWriter() {
+    try {
+        this->close();
+    } catch (const std::runtime_error &) {
+        /* Destructors mustn't throw. */
+    }
+}
+
+/**
+ * @brief Writes what precedes a record: a comma if it is not the first, and a
+ *   line break and indentation if pretty-printing.
+ */
+void DutchKBQADSCreate::JsonRecordWriter::write_separator() {
+    if (this->closed) {
+        throw std::logic_error(std::string("JSON save file \"") +
+                               this->file_name +
+                               "\" has already been closed.");
+    }
+    if (this->records_written > 0) {
+        this->file << ',';
+    }
+    if (this->pretty) {
+        this->file << "\n\t";
+    }
+}
+
+/**
+ * @brief Writes `record` at the current position.
+ *
+ * @param record The record to write.
+ */
+void DutchKBQADSCreate::JsonRecordWriter::write_value(const Json::Value &record) {
+    if (this->pretty) {
+        /* Indent the record's own lines one level deeper than the container's. */
+        std::ostringstream record_stream;
+        this->writer->write(record, &record_stream);
+        const std::string record_str = record_stream.str();
+        for (const char c : record_str) {
+            this->file << c;
+            if (c == '\n') {
+                this->file << '\t';
+            }
         }
-        escapes_added += c;
+    } else {
+        this->writer->write(record, &this->file);
+    }
+    this->records_written++;
+}
+
+/**
+ * @brief Appends `record` to the array.
+ *
+ * @param record The record to append.
+ */
+void DutchKBQADSCreate::JsonRecordWriter::write(const Json::Value &record) {
+    if (this->type != JsonContainerType::JSON_ARRAY) {
+        throw std::logic_error("Records of a JSON object require a member name.");
+    }
+    this->write_separator();
+    this->write_value(record);
+}
+
+/**
+ * @brief Adds `record` to the object, as member `key`.
+ *
+ * The writer does not check whether `key` is a member already.
+ *
+ * @param key The member name.
+ * @param record The record to add.
+ */
+void DutchKBQADSCreate::JsonRecordWriter::write(const std::string &key, const Json::Value &record) {
+    if (this->type != JsonContainerType::JSON_OBJECT) {
+        throw std::logic_error("Records of a JSON array cannot have member names.");
+    }
+    this->write_separator();
+    this->file << Json::valueToQuotedString(key.c_str()) << (this->pretty ? " : " : ":");
+    this->write_value(record);
+}
+
+/**
+ * @brief Closes the array or object, and flushes the file.
+ */
+void DutchKBQADSCreate::JsonRecordWriter::close() {
+    if (this->closed) {
+        return;
+    }
+    this->closed = true;
+    if (this->pretty && this->records_written > 0) {
+        this->file << '\n';
+    }
+    this->file << (this->type == JsonContainerType::JSON_ARRAY ? ']' : '}') << '\n';
+    count_file_written(this->file);
+    this->file.close();
+    if (this->file.fail()) {
+        throw std::runtime_error(std::string("Couldn't write JSON save file \"") +
+                                 this->file_name +
+                                 "\"!");
     }
-    return escapes_added;
 }
 
 /**
@@ -0,0 +1,80 @@
+/* Symbols for adapting the size of WikiData query batches. */
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "wikidata/batch-sizer.hpp"
+
+using namespace DutchKBQADSCreate::WikiData;
+
+/**
+ * @brief Constructs a batch sizer.
+ *
+ * @param initial_size The batch size to start with. Clamped to `[min_size,
+ *   max_size]`.
+ * @param min_size The smallest batch size. Strictly positive.
+ * @param max_size The largest batch size. At least `min_size`.
+ * @param target_latency The latency per query to steer towards. Strictly
+ *   positive.
+ */
+AdaptiveBatchSizer::AdaptiveBatchSizer(int initial_size,
+                                       int min_size,
+                                       int max_size,
+                                       std::chrono::milliseconds target_latency) {
+    if (min_size < 1 || max_size < min_size) {
+        throw std::invalid_argument(std::string("Batch sizes must satisfy 1 <= minimum <= maximum, but the ") +
+                                    "minimum is " +
+                                    std::to_string(min_size) +
+                                    " and the maximum is " +
+                                    std::to_string(max_size) +
+                                    ".");
+    } else if (target_latency.count() <= 0) {
+        throw std::invalid_argument("The target latency of batches must be strictly positive!");
+    }
+    this->size = initial_size;
+    this->min_size = min_size;
+    this->max_size = max_size;
+    this->target_latency = target_latency;
+    this->clamp_size();
+}
+
+/**
+ * @brief Keeps the batch size within the configured bounds.
+ */
+void AdaptiveBatchSizer::clamp_size() {
+    this->size = std::clamp(this->size, static_cast<double>(this->min_size), static_cast<double>(this->max_size));
+}
+
+/**
+ * @brief Returns the number of items to put in the next batch.
+ *
+ * @return The batch size.
+ */
+int AdaptiveBatchSizer::batch_size() const {
+    return static_cast<int>(this->size);
+}
+
+/**
+ * @brief Registers that a batch was queried successfully.
+ *
+ * @param batch_size The number of items in the batch.
+ * @param latency The time it took to query the batch.
+ */
+void AdaptiveBatchSizer::register_success(int batch_size, std::chrono::milliseconds latency) {
+    const double ratio = std::clamp(static_cast<double>(this->target_latency.count()) /
+                                    static_cast<double>(std::max<long long>(latency.count(), 1)),
+                                    0.5,
+                                    2.);
+    this->size = (this->size + batch_size * ratio) / 2.;
+    this->clamp_size();
+}
+
+/**
+ * @brief Registers that querying a batch failed.
+ *
+ * @param batch_size The number of items in the batch.
+ */
+void AdaptiveBatchSizer::register_failure(int batch_size) {
+    this->size = std::min(this->size, batch_size / 2.);
+    this->clamp_size();
+}
@@ -0,0 +1,472 @@
+/* Symbols for querying the WikiData query service concurrently. */
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <curlpp/Options.hpp>
+#include <curlpp/Infos.hpp>
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+#include "wikidata/query-fetcher.hpp"
+#include "tracing/tracer.hpp"
+
+using namespace DutchKBQADSCreate::WikiData;
+
+/**
+ * @brief The longest time to block while waiting for network activity. Bounds
+ *   how late new queries are started once the rate limiter permits them.
+ */
+const std::chrono::milliseconds max_activity_wait { 100 };
+
+/**
+ * @brief Encodes a string for usage in a URL.
+ *
+ * This function's implementation is derived from a StackOverflow answer given
+ * here:
+ *   https://stackoverflow.com/a/17708801
+ *
+ * @param str The string to encode for use in URLs.
+ * @return The encoded string.
+ */
+std::string DutchKBQADSCreate::WikiData::url_encoded_string(const std::string &str) {
+    std::ostringstream encoded;
+    encoded.fill('0');
+    encoded << std::hex;
+    for (char c : str) {
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.' || c == '~') {
+            /* Pass unreserved characters as-is. See RFC 3986, section 2.3. */
+            encoded << c;
+        } else {
+            /* Percent-encode reserved characters. See RFC 3986, section 2.2. */
+            encoded << std::uppercase;
+            encoded << '%' << std::setw(2) << int((unsigned char) c);
+            encoded << std::nouppercase;
+        }
+    }
+    return encoded.str();
+}
+
+/**
+ * @brief Extracts the delay of a `Retry-After` response header line.
+ *
+ * Only the delay-seconds form is supported; for the HTTP-date form, as well
+ * as for any other header line, a null value is returned.
+ *
+ * @param line The header line, possibly with its trailing line break.
+ * @return The delay, if `line` is a `Retry-After` header with a numeric
+ *   value. Otherwise, the C++ null value.
+ */
+std::optional<std::chrono::seconds> DutchKBQADSCreate::WikiData::retry_after_from_header_line(const std::string &line) {
+    const std::string name = "retry-after:";
+    if (line.size() < name.size()) {
+        return std::nullopt;
+    }
+    for (std::size_t idx = 0; idx < name.size(); idx++) {
+        if (std::tolower(static_cast<unsigned char>(line[idx])) != name[idx]) {
+            return std::nullopt;
+        }
+    }
+    std::size_t idx = name.size();
+    while (idx < line.size() && (line[idx] == ' ' || line[idx] == '\t')) {
+        idx++;
+    }
+    long long seconds = 0;
+    bool has_digit = false;
+    while (idx < line.size() && std::isdigit(static_cast<unsigned char>(line[idx]))) {
+        seconds = std::min<long long>(seconds * 10 + (line[idx] - '0'), 24 * 60 * 60);
+        has_digit = true;
+        idx++;
+    }
+    if (!has_digit) {
+        return std::nullopt;
+    }
+    return std::chrono::seconds(seconds);
+}
+
+/**
+ * @brief Constructs a rate limiter that permits a first query immediately.
+ *
+ * @param min_interval The shortest interval between two query starts.
+ * @param max_interval The longest interval between two query starts.
+ */
+AdaptiveRateLimiter::AdaptiveRateLimiter(std::chrono::milliseconds min_interval,
+                                         std::chrono::milliseconds max_interval) {
+    if (min_interval.count() < 0 || max_interval < min_interval) {
+        throw std::invalid_argument("The rate limiter's intervals must satisfy 0 <= minimum <= maximum!");
+    }
+    this->interval = min_interval;
+    this->min_interval = min_interval;
+    this->max_interval = max_interval;
+    this->next_start = fetcher_clock::now();
+}
+
+/**
+ * @brief Returns the earliest moment at which a next query may be started.
+ *
+ * @return The moment.
+ */
+fetcher_clock::time_point AdaptiveRateLimiter::next_permitted_start() const {
+    return this->next_start;
+}
+
+/**
+ * @brief Returns the interval currently kept between two query starts.
+ *
+ * @return The interval.
+ */
+std::chrono::milliseconds AdaptiveRateLimiter::current_interval() const {
+    return this->interval;
+}
+
+/**
+ * @brief Registers that a query has been started.
+ */
+void AdaptiveRateLimiter::register_start() {
+    this->next_start = std::max(this->next_start, fetcher_clock::now()) + this->interval;
+}
+
+/**
+ * @brief Registers that a query completed successfully, easing the limit.
+ */
+void AdaptiveRateLimiter::register_success() {
+    this->interval = std::max(this->min_interval, this->interval - this->interval / 10);
+}
+
+/**
+ * @brief Registers that the server throttled a query, tightening the limit.
+ *
+ * @param retry_after The time the server asked to wait before querying again.
+ */
+void AdaptiveRateLimiter::register_throttle(std::chrono::milliseconds retry_after) {
+    this->interval = std::min(this->max_interval,
+                              std::max(this->min_interval, 2 * this->interval + std::chrono::milliseconds(1)));
+    this->next_start = std::max(this->next_start, fetcher_clock::now() + retry_after);
+}
+
+/**
+ * @brief Constructs a query fetcher, including one reusable transfer handle
+ *   per query that may be in flight.
+ *
+ * @param settings The settings to fetch with.
+ */
+QueryFetcher::QueryFetcher(const FetcherSettings &settings)
+        : settings(settings),
+          limiter(settings.min_start_interval, settings.max_start_interval),
+          jitter_engine(std::random_device()()) {
+    if (settings.max_in_flight < 1) {
+        throw std::invalid_argument(std::string("The number of in-flight queries must be at least 1, but is ") +
+                                    std::to_string(settings.max_in_flight) +
+                                    ".");
+    } else if (settings.max_attempts < 1) {
+        throw std::invalid_argument(std::string("The number of attempts per query must be at least 1, but is ") +
+                                    std::to_string(settings.max_attempts) +
+                                    ".");
+    } else if (settings.max_throttles < 0) {
+        throw std::invalid_argument(std::string("The number of throttles per query must be at least 0, but is ") +
+                                    std::to_string(settings.max_throttles) +
+                                    ".");
+    }
+    this->slots.resize(settings.max_in_flight);
+    for (auto &slot : this->slots) {
+        slot.request = std::make_unique<curlpp::Easy>();
+    }
+}
+
+/**
+ * @brief Sets the options of the request in `slot` for performing `query`.
+ *
+ * @param slot The transfer slot. Its request is reused between queries, so
+ *   that libcurl may keep its connection alive.
+ * @param query The SPARQL query to perform.
+ */
+void QueryFetcher::configure_request(TransferSlot &slot, const std::string &query) {
+    curlpp::Easy &request = *slot.request;
+    const std::string post_body = "query=" + url_encoded_string(query);
+    request.setOpt(new curlpp::Options::Url(wikidata_query_service_url + "sparql"));
+    request.setOpt(new curlpp::Options::HttpHeader({ "Accept: application/json",
+                                                     "Content-Type: application/x-www-form-urlencoded",
+                                                     "User-Agent: Curlpp/0.8.1" }));
+    request.setOpt(new curlpp::Options::PostFields(post_body));
+    request.setOpt(new curlpp::Options::PostFieldSize(static_cast<long>(post_body.size())));
+    /* Accept every compression that libcurl supports, and prefer HTTP/2, so
+     * that concurrent queries share one connection. */
+    request.setOpt(new curlpp::Options::Encoding(""));
+    request.setOpt(new curlpp::Options::HttpVersion(CURL_HTTP_VERSION_2TLS));
+    request.setOpt(new curlpp::OptionTrait<long, CURLOPT_TCP_KEEPALIVE>(1L));
+    request.setOpt(new curlpp::Options::Timeout(this->settings.timeout_seconds));
+    request.setOpt(new curlpp::Options::WriteFunction([&slot] (char *ptr, size_t size, size_t n_mem_b) -> size_t {
+        slot.body.append(ptr, size * n_mem_b);
+        return size * n_mem_b;
+    }));
+    request.setOpt(new curlpp::Options::HeaderFunction([&slot] (char *ptr, size_t size, size_t n_mem_b) -> size_t {
+        const std::optional<std::chrono::seconds> retry_after =
+            retry_after_from_header_line(std::string(ptr, size * n_mem_b));
+        if (retry_after.has_value()) {
+            slot.retry_after = retry_after;
+        }
+        return size * n_mem_b;
+    }));
+}
+
+/**
+ * @brief Starts performing a query in a free transfer slot.
+ *
+ * @param slot The free transfer slot.
+ * @param query The query to start.
+ */
+void QueryFetcher::start(TransferSlot &slot, const PendingQuery &query) {
+    static Tracing::Counter &queries_started = Tracing::counter("http.queries-started");
+    queries_started.add();
+    slot.query = query;
+    slot.body.clear();
+    slot.retry_after = std::nullopt;
+    this->configure_request(slot, query.sparql);
+    slot.started = fetcher_clock::now();
+    this->multi.add(slot.request.get());
+    this->limiter.register_start();
+}
+
+/**
+ * @brief Returns the time to wait before retrying a query, with random jitter
+ *   so that concurrent retries spread out.
+ *
+ * @param failed_attempts The number of failed attempts so far. Strictly
+ *   positive.
+ * @return The time to wait.
+ */
+std::chrono::milliseconds QueryFetcher::backoff_for_attempt(int failed_attempts) {
+    std::chrono::milliseconds backoff = this->settings.initial_backoff;
+    for (int attempt = 1; attempt < failed_attempts && backoff < this->settings.max_backoff; attempt++) {
+        backoff *= 2;
+    }
+    backoff = std::min(backoff, this->settings.max_backoff);
+    std::uniform_int_distribution<long long> jitter(backoff.count() / 2, backoff.count());
+    return std::chrono::milliseconds(jitter(this->jitter_engine));
+}
+
+/**
+ * @brief Schedules a failed query for a retry after some backoff, or throws a
+ *   `runtime_error` if it has no attempts left.
+ *
+ * @param pending The queries waiting to be started.
+ * @param query The failed query.
+ * @param reason A description of why the query failed.
+ * @param on_failure The callback to consult before retrying, if any. If it
+ *   returns `false`, the query is dropped instead.
+ */
+void QueryFetcher::retry_or_abort(std::deque<PendingQuery> &pending,
+                                  const PendingQuery &query,
+                                  const std::string &reason,
+                                  const query_failure_callback &on_failure) {
+    static Tracing::Counter &transient_failures = Tracing::counter("http.transient-failures");
+    static Tracing::Counter &retries = Tracing::counter("http.retries");
+    transient_failures.add();
+    if (on_failure && !on_failure(query.index, reason)) {
+        return;
+    }
+    const int failed_attempts = query.failed_attempts + 1;
+    if (failed_attempts >= this->settings.max_attempts) {
+        throw std::runtime_error(std::string("WikiData query ") +
+                                 std::to_string(query.index) +
+                                 " failed " +
+                                 std::to_string(failed_attempts) +
+                                 " times; last failure: " +
+                                 reason +
+                                 ". Aborting.");
+    }
+    retries.add();
+    pending.push_back({ query.index,
+                        query.sparql,
+                        failed_attempts,
+                        query.throttles,
+                        fetcher_clock::now() + this->backoff_for_attempt(failed_attempts) });
+}
+
+/**
+ * @brief Blocks until some transfer has network activity, or until `max_wait`
+ *   has passed, whichever comes first.
+ *
+ * @param max_wait The longest time to block.
+ */
+void QueryFetcher::wait_for_activity(std::chrono::milliseconds max_wait) {
+    fd_set read_fds, write_fds, exc_fds;
+    FD_ZERO(&read_fds);
+    FD_ZERO(&write_fds);
+    FD_ZERO(&exc_fds);
+    int max_fd = -1;
+    this->multi.fdset(&read_fds, &write_fds, &exc_fds, &max_fd);
+    if (max_fd == -1) {
+        /* libcurl has no sockets to wait on yet (e.g. while resolving). */
+        std::this_thread::sleep_for(std::min(max_wait, std::chrono::milliseconds(10)));
+        return;
+    }
+    timeval timeout {};
+    timeout.tv_sec = static_cast<long>(max_wait.count() / 1000);
+    timeout.tv_usec = static_cast<long>((max_wait.count() % 1000) * 1000);
+    select(max_fd + 1, &read_fds, &write_fds, &exc_fds, &timeout);
+}
+
+/**
+ * @brief Performs the queries that `next_query` produces, calling
+ *   `on_response` for each as soon as its response arrives.
+ *
+ * A next query is asked for whenever a transfer slot is free and the rate
+ * limiter permits a start, so that no slot waits for the others. Queries that
+ * are due to be retried are started before newly produced ones. Once
+ * `next_query` returns null, it is only asked again after a callback has been
+ * called, as callbacks may give it new queries to produce; fetching completes
+ * when it has no further queries and none are in flight. Responses may
+ * arrive in any order. The callbacks are called on the calling thread, and no
+ * new queries are started while they run.
+ *
+ * @param next_query The callback to take the next SPARQL query from.
+ * @param on_response The callback to hand the response bodies to.
+ * @param on_failure The callback to report transient failures to, if any.
+ *   Queries it declines to retry are never handed to `on_response`.
+ */
+void QueryFetcher::fetch(const query_producer &next_query,
+                         const query_response_callback &on_response,
+                         const query_failure_callback &on_failure) {
+    const Tracing::Stage stage("query WikiData");
+    static Tracing::Counter &responses_ok = Tracing::counter("http.responses-ok");
+    static Tracing::Counter &responses_throttled = Tracing::counter("http.responses-429");
+    static Tracing::Counter &bytes_received = Tracing::counter("http.bytes-received");
+    std::deque<PendingQuery> pending;
+    std::size_t produced = 0;
+    bool producer_drained = false;
+    std::size_t in_flight = 0;
+    try {
+        while (!pending.empty() || in_flight > 0 || !producer_drained) {
+            /* (1/3) Start as many queries as the limiter permits: due retries
+             * first, and otherwise a newly produced one. */
+            for (auto &slot : this->slots) {
+                const fetcher_clock::time_point now = fetcher_clock::now();
+                if (slot.query.has_value()) {
+                    continue;
+                } else if (this->limiter.next_permitted_start() > now) {
+                    break;
+                }
+                auto ready = std::find_if(pending.begin(), pending.end(), [&now] (const PendingQuery &query) {
+                    return query.not_before <= now;
+                });
+                if (ready != pending.end()) {
+                    const PendingQuery query = *ready;
+                    pending.erase(ready);
+                    this->start(slot, query);
+                } else if (producer_drained) {
+                    break;
+                } else {
+                    std::optional<std::string> sparql = next_query(produced);
+                    if (!sparql.has_value()) {
+                        producer_drained = true;
+                        break;
+                    }
+                    this->start(slot, { produced, std::move(sparql.value()), 0, 0, now });
+                    produced++;
+                }
+                in_flight++;
+            }
+            /* (2/3) Drive the transfers, and handle those that completed. */
+            int running = 0;
+            while (this->multi.perform(&running)) {}
+            for (const auto &message : this->multi.info()) {
+                if (message.second.msg != CURLMSG_DONE) {
+                    continue;
+                }
+                auto slot_it = std::find_if(this->slots.begin(), this->slots.end(), [&message] (const TransferSlot &s) {
+                    return s.request.get() == message.first;
+                });
+                assert(slot_it != this->slots.end());
+                TransferSlot &slot = *slot_it;
+                this->multi.remove(slot.request.get());
+                const PendingQuery query = slot.query.value();
+                slot.query = std::nullopt;
+                in_flight--;
+                producer_drained = false;  /* The callbacks below may give `next_query` new queries. */
+                if (message.second.code != CURLE_OK) {
+                    /* Timeouts, resets and the like: transient, so retry. */
+                    this->retry_or_abort(pending, query, curl_easy_strerror(message.second.code), on_failure);
+                    continue;
+                }
+                const long res_code = curlpp::Infos::ResponseCode::get(*slot.request);
+                if (res_code == 200) {
+                    responses_ok.add();
+                    bytes_received.add(static_cast<std::int64_t>(slot.body.size()));
+                    this->limiter.register_success();
+                    on_response(query.index,
+                                slot.body,
+                                std::chrono::duration_cast<std::chrono::milliseconds>(fetcher_clock::now() -
+                                                                                      slot.started));
+                } else if (res_code == 429) {
+                    responses_throttled.add();
+                    const std::chrono::milliseconds wait = slot.retry_after.has_value() ?
+                        std::chrono::duration_cast<std::chrono::milliseconds>(slot.retry_after.value()) :
+                        this->settings.default_retry_after;
+                    this->limiter.register_throttle(wait);
+                    PendingQuery throttled = query;
+                    throttled.throttles++;
+                    if (throttled.throttles > this->settings.max_throttles) {
+                        /* Throttled too often: count this as a failure, so
+                         * that fetching can't keep on waiting forever. */
+                        this->retry_or_abort(pending,
+                                             throttled,
+                                             "throttled " + std::to_string(throttled.throttles) + " times",
+                                             on_failure);
+                        continue;
+                    }
+                    throttled.not_before = fetcher_clock::now() + wait;
+                    pending.push_front(std::move(throttled));
+                } else if (res_code >= 500 && res_code < 600) {
+                    this->retry_or_abort(pending, query, "response code " + std::to_string(res_code), on_failure);
+                } else {
+                    throw std::runtime_error(std::string("Received response code ") +
+                                             std::to_string(res_code) +
+                                             " from WikiData. Aborting.");
+                }
+            }
+            /* (3/3) Wait until there is something to do. */
+            if (pending.empty() && in_flight == 0 && producer_drained) {
+                break;
+            }
+            fetcher_clock::time_point next_event = fetcher_clock::time_point::max();
+            if (in_flight < this->slots.size()) {
+                if (!producer_drained) {
+                    next_event = fetcher_clock::time_point::min();
+                }
+                for (const auto &query : pending) {
+                    next_event = std::min(next_event, query.not_before);
+                }
+                next_event = std::max(next_event, this->limiter.next_permitted_start());
+            }
+            const fetcher_clock::time_point now = fetcher_clock::now();
+            std::chrono::milliseconds until_next_event = max_activity_wait;
+            if (next_event != fetcher_clock::time_point::max()) {
+                until_next_event = next_event <= now ?
+                    std::chrono::milliseconds(0) :
+                    std::chrono::ceil<std::chrono::milliseconds>(next_event - now);
+            }
+            if (in_flight > 0) {
+                this->wait_for_activity(std::min(until_next_event, max_activity_wait));
+            } else {
+                std::this_thread::sleep_for(until_next_event);
+            }
+        }
+    } catch (...) {
+        /* Detach the remaining transfers, so that this fetcher stays usable. */
+        for (auto &slot : this->slots) {
+            if (slot.query.has_value()) {
+                this->multi.remove(slot.request.get());
+                slot.query = std::nullopt;
+            }
+        }
+        throw;
+    }
+}
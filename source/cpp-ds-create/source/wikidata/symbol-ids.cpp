@@ -0,0 +1,232 @@
+/* Symbols for representing WikiData entities and properties compactly. */
+
+#include <algorithm>
+#include <stdexcept>
+#include "wikidata/symbol-ids.hpp"
+
+using namespace DutchKBQADSCreate;
+using namespace DutchKBQADSCreate::WikiData;
+
+/**
+ * @brief Returns the packed identifier of an entity or property.
+ *
+ * @param type Whether the identifier is that of an entity or a property.
+ * @param number The numeric part of the identifier; for `Q42`, this is `42`.
+ *   At most `max_symbol_number`.
+ * @return The packed identifier.
+ */
+symbol_id DutchKBQADSCreate::WikiData::symbol_id_of(WikiDataSymbol type, std::uint32_t number) {
+    if (number > max_symbol_number) {
+        throw std::invalid_argument(std::string("WikiData identifier number ") +
+                                    std::to_string(number) +
+                                    " is too large to pack.");
+    }
+    return type == WikiDataSymbol::PROPERTY ? (number | property_tag) : number;
+}
+
+/**
+ * @brief Returns whether `id` identifies an entity or a property.
+ *
+ * @param id The packed identifier.
+ * @return The symbol type.
+ */
+WikiDataSymbol DutchKBQADSCreate::WikiData::symbol_type(symbol_id id) {
+    return (id & property_tag) != 0 ? WikiDataSymbol::PROPERTY : WikiDataSymbol::ENTITY;
+}
+
+/**
+ * @brief Returns the numeric part of `id`.
+ *
+ * @param id The packed identifier.
+ * @return The numeric part; for `Q42`, this is `42`.
+ */
+std::uint32_t DutchKBQADSCreate::WikiData::symbol_number(symbol_id id) {
+    return id & max_symbol_number;
+}
+
+/**
+ * @brief Returns the textual form of `id`, as used by WikiData.
+ *
+ * @param id The packed identifier.
+ * @return The identifier as a string, such as `"Q42"` or `"P31"`.
+ */
+std::string DutchKBQADSCreate::WikiData::string_from_symbol_id(symbol_id id) {
+    return (symbol_type(id) == WikiDataSymbol::PROPERTY ? "P" : "Q") + std::to_string(symbol_number(id));
+}
+
+/**
+ * @brief Returns the packed identifier of the textual WikiData identifier
+ *   `ent_or_prp`.
+ *
+ * @param ent_or_prp The identifier as a string, such as `"Q42"` or `"P31"`.
+ * @return The packed identifier, or `std::nullopt` if `ent_or_prp` is not an
+ *   entity or property identifier, or is too large to pack.
+ */
+std::optional<symbol_id> DutchKBQADSCreate::WikiData::symbol_id_from_string(const std::string &ent_or_prp) {
+    if (ent_or_prp.size() < 2 || (ent_or_prp[0] != 'Q' && ent_or_prp[0] != 'P')) {
+        return std::nullopt;
+    }
+    std::uint64_t number = 0;
+    for (std::size_t idx = 1; idx < ent_or_prp.size(); idx++) {
+        const char c = ent_or_prp[idx];
+        if (c < '0' || c > '9') {
+            return std::nullopt;
+        }
+        number = number * 10 + static_cast<std::uint64_t>(c - '0');
+        if (number > max_symbol_number) {
+            return std::nullopt;
+        }
+    }
+    return symbol_id_of(ent_or_prp[0] == 'P' ? WikiDataSymbol::PROPERTY : WikiDataSymbol::ENTITY,
+                        static_cast<std::uint32_t>(number));
+}
+
+/**
+ * @brief Returns the packed identifier of the textual WikiData identifier
+ *   `ent_or_prp`, which must be valid.
+ *
+ * @param ent_or_prp The identifier as a string, such as `"Q42"` or `"P31"`.
+ * @return The packed identifier.
+ */
+symbol_id DutchKBQADSCreate::WikiData::parsed_symbol_id(const std::string &ent_or_prp) {
+    const std::optional<symbol_id> id = symbol_id_from_string(ent_or_prp);
+    if (!id.has_value()) {
+        throw std::invalid_argument(std::string("\"") +
+                                    ent_or_prp +
+                                    "\" is not an entity or property!");
+    }
+    return id.value();
+}
+
+/**
+ * @brief Returns whether the textual form of `first` sorts before that of
+ *   `second`; for example, `P10` precedes `P9`, which precedes `Q1`.
+ *
+ * @param first The first packed identifier.
+ * @param second The second packed identifier.
+ * @return The question's answer.
+ */
+bool DutchKBQADSCreate::WikiData::textually_precedes(symbol_id first, symbol_id second) {
+    const bool first_is_property = symbol_type(first) == WikiDataSymbol::PROPERTY;
+    const bool second_is_property = symbol_type(second) == WikiDataSymbol::PROPERTY;
+    if (first_is_property != second_is_property) {
+        return first_is_property;  /* 'P' precedes 'Q' */
+    }
+    return std::to_string(symbol_number(first)) < std::to_string(symbol_number(second));
+}
+
+/**
+ * @brief Returns whether `c` can be part of a SPARQL prefixed name, so that a
+ *   prefix or identifier adjacent to it is not a token of its own.
+ *
+ * @param c The character.
+ * @return Whether `c` continues a name.
+ */
+bool is_name_character(char c) {
+    return (c >= 'a' && c <= 'z') ||
+           (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') ||
+           c == '_' ||
+           c == '-' ||
+           c == ':';
+}
+
+/**
+ * @brief Returns the index just past the WikiData prefix (`wd:`, `wdt:`, `p:`,
+ *   `ps:` or `pq:`) that starts at `idx` in `sparql`, if any.
+ *
+ * @param sparql The SPARQL query.
+ * @param idx The index at which the prefix must start.
+ * @return The index of the first character after the prefix's colon, or
+ *   `std::nullopt` if no WikiData prefix starts at `idx`.
+ */
+std::optional<std::size_t> index_after_wikidata_prefix(const std::string &sparql, std::size_t idx) {
+    std::size_t after = idx + 1;
+    if (sparql[idx] == 'w') {
+        if (after >= sparql.size() || sparql[after] != 'd') {
+            return std::nullopt;
+        }
+        after++;
+        if (after < sparql.size() && sparql[after] == 't') {
+            after++;
+        }
+    } else if (sparql[idx] == 'p') {
+        if (after < sparql.size() && (sparql[after] == 's' || sparql[after] == 'q')) {
+            after++;
+        }
+    } else {
+        return std::nullopt;
+    }
+    if (after >= sparql.size() || sparql[after] != ':') {
+        return std::nullopt;
+    }
+    return after + 1;
+}
+
+/**
+ * @brief Returns the occurrences of entities and properties in `sparql`
+ *   through the WikiData prefixes `wd:`, `wdt:`, `p:`, `ps:` and `pq:`.
+ *
+ * The query is scanned in a single pass, without any allocations besides the
+ * result. Identifiers outside of such prefixed names, like the `P1` in
+ * `?P1` or in string literals, are not reported.
+ *
+ * @param sparql The SPARQL query.
+ * @return The occurrences, in the order in which they appear in `sparql`.
+ */
+std::vector<SymbolOccurrence> DutchKBQADSCreate::WikiData::symbol_occurrences_in_sparql(const std::string &sparql) {
+    std::vector<SymbolOccurrence> occurrences;
+    std::size_t idx = 0;
+    while (idx < sparql.size()) {
+        if (idx > 0 && is_name_character(sparql[idx - 1])) {
+            idx++;  /* a prefix must start a name */
+            continue;
+        }
+        const std::optional<std::size_t> after_prefix = index_after_wikidata_prefix(sparql, idx);
+        if (!after_prefix.has_value()) {
+            idx++;
+            continue;
+        }
+        const std::size_t start = after_prefix.value();
+        std::size_t end = start;
+        if (end >= sparql.size() || (sparql[end] != 'Q' && sparql[end] != 'P')) {
+            idx = end;
+            continue;
+        }
+        const WikiDataSymbol type = sparql[end] == 'P' ? WikiDataSymbol::PROPERTY : WikiDataSymbol::ENTITY;
+        end++;
+        const std::size_t digits_start = end;
+        std::uint64_t number = 0;
+        while (end < sparql.size() && sparql[end] >= '0' && sparql[end] <= '9') {
+            number = std::min<std::uint64_t>(number * 10 + static_cast<std::uint64_t>(sparql[end] - '0'),
+                                             static_cast<std::uint64_t>(max_symbol_number) + 1);
+            end++;
+        }
+        const bool is_whole_identifier = end > digits_start &&
+                                         (end >= sparql.size() || !is_name_character(sparql[end])) &&
+                                         number <= max_symbol_number;
+        if (is_whole_identifier) {
+            occurrences.push_back({ symbol_id_of(type, static_cast<std::uint32_t>(number)), start, end });
+        }
+        idx = end;
+    }
+    return occurrences;
+}
+
+/**
+ * @brief Returns the entities and properties referred to in `sparql` through
+ *   the WikiData prefixes `wd:`, `wdt:`, `p:`, `ps:` and `pq:`. See
+ *   `symbol_occurrences_in_sparql`.
+ *
+ * @param sparql The SPARQL query.
+ * @return The identifiers, sorted and without duplicates.
+ */
+std::vector<symbol_id> DutchKBQADSCreate::WikiData::symbol_ids_in_sparql(const std::string &sparql) {
+    std::vector<symbol_id> ids;
+    for (const auto &occurrence : symbol_occurrences_in_sparql(sparql)) {
+        ids.push_back(occurrence.id);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
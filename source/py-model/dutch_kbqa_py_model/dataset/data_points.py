@@ -1,12 +1,15 @@
 """Symbols for loading in and pre-processing language model data points."""
 
+import mmap
+import struct
 from pathlib import Path
 from transformers import PreTrainedTokenizer
 from dutch_kbqa_py_model.utilities import DEBUG_MODE, \
                                           LOGGER, \
                                           LOGGER_NUMBER_EXAMPLES, \
                                           MLStage
-from typing import NamedTuple, List, Tuple, Optional, Union
+from typing import NamedTuple, List, Tuple, Optional, Union, Sequence, \
+                   overload
 from typing_extensions import Literal
 
 
@@ -56,6 +59,117 @@ def loaded_raw_data_points(natural_language_file: Path,
     return data_points
 
 
+# The layout of the columnar files that the C++ dataset-creating project's
+# `finalise-dataset` task writes: a header, followed by sections that each
+# consist of an element count and that many elements, padded to a multiple of
+# eight bytes. Integers are stored in the byte order of the machine that wrote
+# the file.
+COLUMNS_HEADER = struct.Struct('=8sIIIIQqQ')
+COLUMNS_MAGIC = b'DKBQSCAR'
+COLUMNS_VERSION = 1
+COLUMNS_KIND = 3
+COLUMNS_BYTE_ORDER_MARK = 0x01020304
+
+
+class ColumnarDataPoints(Sequence[RawDataPoint]):
+    """'Raw' natural language-query language data points, memory-mapped from a
+    columnar file.
+
+    The file holds the data points' UIDs, their natural language sentences and
+    their query language sentences, each in a column of its own. Opening the
+    file only reads its header; a data point's sentences are decoded when it is
+    accessed. As the file is mapped read-only, the operating system shares its
+    pages between all processes that map it, like data loader workers.
+    """
+
+    def __init__(self, columns_file: Path) -> None:
+        """Constructs the data points by mapping a columnar file into memory.
+
+        :param columns_file: A file system path to a columnar file, like those
+            in which the C++ dataset-creating project's `finalise-dataset` task
+            saves the finalised dataset.
+        :throws: `ValueError` if the file is not such a columnar file, or if
+            it was written on a machine of another byte order.
+        """
+        with open(columns_file, mode='rb') as handle:
+            self.mapped = mmap.mmap(handle.fileno(), 0, access=mmap.ACCESS_READ)
+        view = memoryview(self.mapped)
+        if len(view) < COLUMNS_HEADER.size:
+            raise ValueError(f'"{columns_file}" is too small to be a ' +
+                             'columnar file!')
+        magic, version, kind, byte_order_mark, *_ = \
+            COLUMNS_HEADER.unpack_from(view)
+        if (magic, version, kind, byte_order_mark) != \
+           (COLUMNS_MAGIC, COLUMNS_VERSION, COLUMNS_KIND,
+            COLUMNS_BYTE_ORDER_MARK):
+            raise ValueError(f'"{columns_file}" is not a columnar file of ' +
+                             'the current format and this byte order!')
+        self.position = COLUMNS_HEADER.size
+        self.uids = self.next_section(view, 'i')
+        self.question_offsets = self.next_section(view, 'Q')
+        self.questions = self.next_section(view, 'B')
+        self.answer_offsets = self.next_section(view, 'Q')
+        self.answers = self.next_section(view, 'B')
+        if not (len(self.question_offsets) == len(self.answer_offsets) ==
+                len(self.uids) + 1):
+            raise ValueError(f'The columns of "{columns_file}" differ in ' +
+                             'length!')
+        self.length = len(self.uids)
+        if DEBUG_MODE:
+            self.length = min(self.length, DEBUG_NUMBER_DATA_POINTS)
+
+    def next_section(self, view: memoryview, element_format: str) -> \
+            memoryview:
+        """Returns the elements of the section that starts at the current
+        position in the file, and moves the position past the section.
+
+        :param view: A view of the whole file.
+        :param element_format: The `struct` format character of the elements.
+        :returns: A view of the elements. Does not copy them.
+        :throws: `ValueError` if the section exceeds the file.
+        """
+        count, = struct.unpack_from('=Q', view, self.position)
+        size = count * struct.calcsize(element_format)
+        start = self.position + 8
+        if start + size > len(view):
+            raise ValueError('A section of a columnar file exceeds the file!')
+        self.position = start + size + (-size % 8)
+        return view[start:(start + size)].cast(element_format)
+
+    def __len__(self) -> int:
+        return self.length
+
+    @overload
+    def __getitem__(self, idx: int) -> RawDataPoint: ...
+
+    @overload
+    def __getitem__(self, idx: slice) -> List[RawDataPoint]: ...
+
+    def __getitem__(self, idx: Union[int, slice]) -> \
+            Union[RawDataPoint, List[RawDataPoint]]:
+        """Returns the data point at index `idx`, or the data points of a
+        slice of indices.
+
+        Like `loaded_raw_data_points`, data points are indexed by their
+        position in the file, and their sentences are stripped of surrounding
+        whitespace.
+
+        :param idx: The index, or the slice of indices.
+        :returns: The data point(s).
+        :throws: `IndexError` if `idx` is out of range.
+        """
+        if isinstance(idx, slice):
+            return [self[i] for i in range(*idx.indices(self.length))]
+        idx = range(self.length)[idx]
+        question = str(self.questions[self.question_offsets[idx]:
+                                      self.question_offsets[idx + 1]], 'utf-8')
+        query = str(self.answers[self.answer_offsets[idx]:
+                                 self.answer_offsets[idx + 1]], 'utf-8')
+        return RawDataPoint(idx=idx,
+                            natural_language=question.strip(),
+                            query_language=query.strip())
+
+
 class TransformerDataPoint(NamedTuple):
     """A single natural language-query language data point that is appropriate
     for training, validating, and testing a transformer model with.
@@ -167,7 +281,7 @@ def log_first_data_points(data_points: List[TransformerDataPoint],
     LOGGER.info(msg)
 
 
-def transformer_data_points_from_raw(raw_data_points: List[RawDataPoint],
+def transformer_data_points_from_raw(raw_data_points: Sequence[RawDataPoint],
                                      enc_tokeniser: PreTrainedTokenizer,
                                      dec_tokeniser: PreTrainedTokenizer,
                                      max_natural_language_length: int,
@@ -48,6 +48,7 @@ from transformers import PretrainedConfig, \
 from nltk.translate.bleu_score import corpus_bleu
 from dutch_kbqa_py_model.model.transformer import Transformer
 from dutch_kbqa_py_model.dataset.data_points import RawDataPoint, TransformerDataPoint, \
+                                                    ColumnarDataPoints, \
                                                     loaded_raw_data_points, \
                                                     transformer_data_points_from_raw
 from dutch_kbqa_py_model.utilities import LOGGER, \
@@ -64,6 +65,7 @@ from typing import NamedTuple, \
                    Optional, \
                    Tuple, \
                    List, \
+                   Sequence, \
                    Callable, \
                    cast
 from typing_extensions import Literal, TypedDict
@@ -587,7 +589,7 @@ class TransformerRunner:
     def raw_data_points_for_ml_stage(self,
                                      ml_stage: MLStage,
                                      perform_sampling: bool = False) -> \
-            List[RawDataPoint]: 
+            Sequence[RawDataPoint]: 
         """Returns unprocessed ('raw') data points for the requested stage of
         machine learning.
         
@@ -598,14 +600,24 @@ class TransformerRunner:
             capped to a maximum of `MAX_SAMPLES` data points, so if the file
             you requested has more data points, some may not appear in the
             sample. Defaults to `False`.
-        :returns: 'Raw' data points for the requested ML stage.
+        :returns: 'Raw' data points for the requested ML stage. If the
+            dataset directory holds a columnar file for the stage, like the C++
+            dataset-creating project's `finalise-dataset` task writes, the data
+            points are memory-mapped from it; otherwise, they are read from the
+            stage's text files.
         """
-        natural_language_loc = self.data_points_location(ml_stage,
-                                                         self.natural_language)
-        query_language_loc = self.data_points_location(ml_stage,
-                                                       self.query_language)
-        data_points = loaded_raw_data_points(natural_language_loc,
-                                             query_language_loc)
+        columns_loc = self.dataset_dir / \
+                      f'{ml_stage.value}-{self.natural_language.value}.columns'
+        data_points: Sequence[RawDataPoint]
+        if columns_loc.is_file():
+            data_points = ColumnarDataPoints(columns_loc)
+        else:
+            natural_language_loc = self.data_points_location(ml_stage,
+                                                             self.natural_language)
+            query_language_loc = self.data_points_location(ml_stage,
+                                                           self.query_language)
+            data_points = loaded_raw_data_points(natural_language_loc,
+                                                 query_language_loc)
         if perform_sampling:
             sample_size = min(TransformerRunner.MAX_SAMPLES,
                               len(data_points))
@@ -613,7 +625,7 @@ class TransformerRunner:
         return data_points
 
     def transformer_data_points_for_ml_stage(self,
-                                             raw_data_points: List[RawDataPoint],
+                                             raw_data_points: Sequence[RawDataPoint],
                                              ml_stage: MLStage) -> \
             List[TransformerDataPoint]:
         """Returns transformer-ready data points for the requested stage of
@@ -687,7 +699,7 @@ class TransformerRunner:
     def data_loader_for_ml_stage(self,
                                  ml_stage: MLStage,
                                  raw_dps:
-                                     Optional[List[RawDataPoint]] = None) -> \
+                                     Optional[Sequence[RawDataPoint]] = None) -> \
             Tuple[DataLoader, int]:
         """Returns a data loader for the requested stage of machine learning.
         
@@ -846,7 +858,7 @@ class TransformerRunner:
 
     def evaluation_pairs(self,
                          predicted_sents: List[str],
-                         ground_truth_raw_dps: List[RawDataPoint]) -> \
+                         ground_truth_raw_dps: Sequence[RawDataPoint]) -> \
             List[EvaluationPair]:
         """Returns evaluation pairs derived from combining predicted
         sentences and 'raw' ground-truth data points in a one-on-one fashion.
@@ -981,7 +993,7 @@ class TransformerRunner:
                    best_ckpt_dir / f'{TransformerRunner.SAVE_FILE_NAME}.zip')
 
     def run_single_evaluation_epoch(self,
-                                    raw_dps: List[RawDataPoint],
+                                    raw_dps: Sequence[RawDataPoint],
                                     ml_stage: MLStage) -> float:
         """Runs the transformer through a single evaluation epoch.
 
@@ -1046,7 +1058,7 @@ class TransformerRunner:
         self.log_start_of_training(number_data_points=number_train)
         train_info: TrainInfo = {'steps_sum': 0, 'loss_sum': 0.}
         best_bleu = TransformerRunner.WORST_BLEU_SCORE
-        validation_raw_dps: Optional[List[RawDataPoint]] = None  # filled later
+        validation_raw_dps: Optional[Sequence[RawDataPoint]] = None  # filled later
         for epoch in range(self.training_epochs):
             epoch_info = self.run_single_training_epoch(epoch,
                                                         dl,